@@ -0,0 +1,75 @@
+#!/bin/bash
+
+
+# runs the release binary headless against the dummy backend (see note on the dummy backend
+#   in dummy_backend.h) and checks what it prints and what it writes - run via 'make check'
+
+
+BIN_DIR=./bin/Release
+LOOPIDITY=./loopidity
+HEADLESS_ARGS="--headless --nomon"
+WORK_DIR=`mktemp -d`
+SAMPLE_RATE=48000
+N_FAILS=0
+
+
+# little endian integers
+le16() { printf "\\x$(printf %02x $(($1 & 255)))\\x$(printf %02x $((($1 >> 8) & 255)))" ; }
+le32() { le16 $(($1 & 65535)) ; le16 $((($1 >> 16) & 65535)) ; }
+
+# write_wav <path> <source> <n_seconds> [<source> <n_seconds> ...] - 16 bit mono PCM
+write_wav()
+{
+  local PATH_OUT=$1 ; shift ; local ARGS=("$@") ; local N_BYTES=0
+  for ((ARG_N = 1 ; ARG_N < ${#ARGS[@]} ; ARG_N += 2))
+  do N_BYTES=$((N_BYTES + ${ARGS[$ARG_N]} * SAMPLE_RATE * 2))
+  done
+
+  { printf "RIFF" ; le32 $((N_BYTES + 36)) ; printf "WAVEfmt " ; le32 16 ; le16 1 ; le16 1 ;
+    le32 $SAMPLE_RATE ; le32 $((SAMPLE_RATE * 2)) ; le16 2 ; le16 16 ; printf "data" ; le32 $N_BYTES ;
+    for ((ARG_N = 0 ; ARG_N < ${#ARGS[@]} ; ARG_N += 2))
+    do head -c $((${ARGS[$ARG_N + 1]} * SAMPLE_RATE * 2)) ${ARGS[$ARG_N]}
+    done ; } > $PATH_OUT
+}
+
+# run <name> <in.wav> [args ...] - writes $WORK_DIR/<name>.wav and $WORK_DIR/<name>.log
+run()
+{
+  local NAME=$1 ; local IN_WAV=$2 ; shift 2
+  ( cd $BIN_DIR && $LOOPIDITY $HEADLESS_ARGS --dummyio $IN_WAV $WORK_DIR/$NAME.wav "$@" ) \
+      > $WORK_DIR/$NAME.log 2>&1
+}
+
+# check <description> <status>
+check()
+{
+  if (($2))
+  then echo "  FAIL: $1" ; N_FAILS=$((N_FAILS + 1))
+  else echo "  pass: $1"
+  fi
+}
+
+
+# calibration must measure back exactly the simulated round trip
+LOOPBACK_SIZE=1234
+write_wav $WORK_DIR/silence.wav /dev/zero 3
+run calibration $WORK_DIR/silence.wav --dummyloopback $LOOPBACK_SIZE --calibrate
+grep -q "Round trip latency: $LOOPBACK_SIZE frames" $WORK_DIR/calibration.log
+check "calibration measures a $LOOPBACK_SIZE frame loopback" $?
+
+# two scripted triggers over noise must commit a loop that keeps playing once the input is silent
+#   (see note on the dummy backend in dummy_backend.h) - without them the tail must be silent
+TAIL_SIZE=$((2 * SAMPLE_RATE * 2 * 4)) # last 2 seconds of the stereo float output
+printf "%d trigger\n%d trigger\n" $((SAMPLE_RATE / 2)) $((SAMPLE_RATE * 7 / 2)) > $WORK_DIR/loop.txt
+write_wav $WORK_DIR/noise.wav /dev/urandom 4 /dev/zero 4
+run loop   $WORK_DIR/noise.wav --dummyscript $WORK_DIR/loop.txt
+run noloop $WORK_DIR/noise.wav
+(($(tail -c $TAIL_SIZE $WORK_DIR/loop.wav   | tr -d '\0' | wc -c) > 0))
+check "a scripted loop plays back after the input ends" $?
+(($(tail -c $TAIL_SIZE $WORK_DIR/noloop.wav | tr -d '\0' | wc -c) == 0))
+check "an unscripted run is silent after the input ends" $?
+
+
+rm -rf $WORK_DIR
+
+exit $((N_FAILS > 0))
@@ -0,0 +1,80 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+
+#ifndef _AUDIO_BACKEND_H_
+#define _AUDIO_BACKEND_H_
+
+
+#include "loopidity.h"
+
+
+using namespace std ;
+
+
+class AudioBackend
+{
+  public:
+
+    /* AudioBackend instance side public functions */
+
+    virtual ~AudioBackend() {}
+
+    // setup
+    virtual Uint32 open(    Uint32 nChannels , bool shouldOutputStems) = 0 ;
+    virtual bool   activate(void)                                      = 0 ;
+    virtual void   close(   void)                                      = 0 ;
+
+    // getters
+    virtual Uint32 getSampleRate(void) = 0 ;
+    virtual Uint32 getBufferSize(void) = 0 ;
+    virtual float  getDspLoad(   void) = 0 ;
+
+    // process thread
+    virtual void    getBuffers(   Uint32 nFrames , Sample** inBuffers , Sample** outBuffers) = 0 ;
+    virtual Sample* getStemBuffer(Uint32 stemN   , Uint32 nFrames)                           = 0 ;
+} ;
+
+
+#endif // #ifndef _AUDIO_BACKEND_H_
+
+
+/* NOTE: on audio backends
+
+    JackIO is the engine - it owns the record buffers , the mix kernels , and the scene
+      state machine but it no longer knows where its period buffers come from
+    an AudioBackend owns the device side - the clock , the port buffers , and the
+      callbacks - and drives the engine through the JackIO entry points below
+        open()        --> JackIO::FormatCallback() with the initial rate and period
+        process clock --> JackIO::ThreadInitCallback() once then
+                          JackIO::ProcessCallback() once per period
+        overruns      --> JackIO::XrunCallback()
+        device loss   --> JackIO::ShutdownCallback()
+    ProcessCallback() calls getBuffers() and getStemBuffer() on the process thread
+      so neither may allocate or block - getStemBuffer() returns 0 for a stem that
+      no one is listening to and the engine skips it
+    open() returns one of the JACK_* error states - activate() starts the clock and is
+      called once from JackIO::Init() - the engine outputs silence until JackIO::Reset()
+      sets the first Scene and later Reset() calls leave the clock running
+
+    JackBackend   (jack_backend.h)  --> a JACK client - the default
+    DummyBackend  (dummy_backend.h) --> reads a WAV file and writes a WAV file on a
+                                        simulated clock (DUMMY_IO_ARG)
+*/
@@ -0,0 +1,204 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+
+#include "bounce.h"
+
+
+/* Bounce class side private constants */
+
+const Uint32 Bounce::PERIOD_SIZE = BOUNCE_PERIOD_SIZE ;
+
+
+/* Bounce class side private varables */
+
+// options
+string Bounce::OutDir(BOUNCE_DEFAULT_DIR) ;          // Init()
+Uint32 Bounce::NRepetitions = BOUNCE_N_REPETITIONS ; // Init()
+
+// job (snapshot of the scene taken in Begin())
+Uint32  Bounce::SceneN      = 0 ; // Begin()
+Uint32  Bounce::NChannels   = 0 ; // Begin()
+Uint32  Bounce::SampleRate  = 0 ; // Begin()
+Uint32  Bounce::NLoops      = 0 ; // Begin()
+Sample* Bounce::LoopBuffers[NUM_LOOPS][MAX_N_CHANNELS] ; // Begin()
+float   Bounce::LoopVols[NUM_LOOPS] ;                    // Begin()
+Uint32  Bounce::SeamFrameN  = 0 ; // Begin()
+Uint32  Bounce::LoopNFrames = 0 ; // Begin()
+Uint32  Bounce::LeadInSize  = 0 ; // Begin()
+Uint32  Bounce::LeadOutSize = 0 ; // Begin()
+string  Bounce::OutPath ;         // Begin()
+
+// work buffers
+Sample* Bounce::OutBuffers[MAX_N_CHANNELS] = { 0 } ; // Begin()
+Sample* Bounce::SilenceBuffer              = 0 ;     // Begin()
+Sample* Bounce::RecordBuffer               = 0 ;     // Begin()
+
+// worker thread
+SDL_Thread*  Bounce::WorkerThread   = 0 ; // Begin()
+atomic<bool> Bounce::IsBouncing(false) ;  // Begin() , Worker()
+atomic<bool> Bounce::IsRunning(false) ;   // Begin() , Cleanup()
+Uint32       Bounce::NFramesWritten = 0 ; // Worker()
+
+// event structs
+SDL_Event Bounce::DoneEvent ; // Begin()
+
+
+/* Bounce class side private functions */
+
+// setup
+
+void Bounce::Init(const char* outDir , Uint32 nRepetitions)
+{
+  if (outDir) OutDir = outDir ;
+  NRepetitions = (nRepetitions)? nRepetitions : 1 ;
+}
+
+bool Bounce::Begin(Scene* scene)
+{
+  if (IsBouncing || !scene || scene->loops.empty()) return false ;
+
+  // reap the previous worker
+  if (WorkerThread) { SDL_WaitThread(WorkerThread , 0) ; WorkerThread = 0 ; }
+
+  // snapshot the unmuted loops - muting is resolved here as in JackIO::Mix()
+  SceneN     = scene->sceneN ;
+  NChannels  = JackIO::NChannels ;
+  SampleRate = JackIO::SampleRate ;
+  NLoops     = 0 ;
+  list<Loop*>::iterator loopIter = scene->loops.begin() ;
+  list<Loop*>::iterator loopsEnd = scene->loops.end() ;
+  bool isSceneMuted = scene->isMuted ;
+  for ( ; loopIter != loopsEnd && NLoops < NUM_LOOPS ; ++loopIter)
+  {
+    Loop* aLoop = *loopIter ; if (isSceneMuted && aLoop->isMuted) continue ;
+
+    for (Uint32 channelN = 0 ; channelN < NChannels ; ++channelN)
+      LoopBuffers[NLoops][channelN] = aLoop->buffers[channelN] ;
+    LoopVols[NLoops++] = aLoop->vol ;
+  }
+
+  // locate the loop body and its margins within the loop buffers
+  LoopNFrames = scene->nFrames ;
+#if SCENE_NFRAMES_EDITABLE
+  Uint32 marginSize = JackIO::BufferMarginSize ;
+  SeamFrameN  = scene->endFrameN - scene->nFrames ;
+  LeadInSize  = (marginSize < SeamFrameN)?  marginSize : SeamFrameN ;
+  LeadOutSize = (marginSize < LoopNFrames)? marginSize : LoopNFrames ;
+#else
+  SeamFrameN  = LeadInSize = LeadOutSize = 0 ;
+#endif // #if SCENE_NFRAMES_EDITABLE
+
+  char outPath[BOUNCE_PATH_LEN] ;
+  snprintf(outPath , BOUNCE_PATH_LEN , BOUNCE_FILE_FMT , OutDir.c_str() , SceneN + 1) ;
+  OutPath = outPath ;
+
+  // initialize work buffers
+  for (Uint32 channelN = 0 ; channelN < NChannels ; ++channelN)
+    if (!(OutBuffers[channelN] = new (nothrow) Sample[PERIOD_SIZE]))
+      { FreeBuffers() ; return false ; }
+  if (!(SilenceBuffer = new (nothrow) Sample[PERIOD_SIZE]()) ||
+      !(RecordBuffer  = new (nothrow) Sample[PERIOD_SIZE])    )
+    { FreeBuffers() ; return false ; }
+
+  // initialize SDL event struct
+  DoneEvent.type       = SDL_USEREVENT ;
+  DoneEvent.user.code  = EVT_BOUNCE_DONE ;
+  DoneEvent.user.data1 = &SceneN ;
+  DoneEvent.user.data2 = &NFramesWritten ;
+
+  IsBouncing = IsRunning = true ;
+  if (!(WorkerThread = SDL_CreateThread(Worker , 0)))
+    { IsBouncing = false ; FreeBuffers() ; return false ; }
+
+  return true ;
+}
+
+void Bounce::Cleanup()
+{
+  IsRunning = false ;
+  if (WorkerThread) { SDL_WaitThread(WorkerThread , 0) ; WorkerThread = 0 ; }
+}
+
+
+// worker thread
+
+int Bounce::Worker(void* unused)
+{
+  TraceRing::NameThread("bounce") ;
+
+  // lead-in fades in , the body repeats at unity gain , the lead-out fades out
+  WavFile outFile ; NFramesWritten = 0 ;
+  float fadeInInc  = (LeadInSize)?  1.0 / LeadInSize  : 0.0 ;
+  float fadeOutInc = (LeadOutSize)? 1.0 / LeadOutSize : 0.0 ;
+  bool  isDone     = outFile.openWrite(OutPath.c_str() , NChannels , SampleRate) &&
+                     RenderSpan(&outFile , SeamFrameN - LeadInSize , LeadInSize , 0.0 , fadeInInc) ;
+  for (Uint32 repetitionN = 0 ; isDone && repetitionN < NRepetitions ; ++repetitionN)
+    isDone = RenderSpan(&outFile , SeamFrameN , LoopNFrames , 1.0 , 0.0) ;
+  isDone = isDone && RenderSpan(&outFile , SeamFrameN , LeadOutSize , 1.0 , -fadeOutInc) ;
+  outFile.close() ;
+
+  if (!isDone) NFramesWritten = 0 ;
+  FreeBuffers() ; if (IsRunning) SDL_PushEvent(&DoneEvent) ;
+  IsBouncing = false ;
+
+  return 0 ;
+}
+
+bool Bounce::RenderSpan(WavFile* outFile , Uint32 loopFrameN , Uint32 nFrames ,
+                        float    gain    , float  gainInc                     )
+{
+  // the live mix kernel for this loop count - unmonitored so the input is only recorded
+  JackIO::SpanKernel kernel = JackIO::SpanKernels[NLoops] ;
+  while (nFrames)
+  {
+    if (!IsRunning) return false ;
+
+    Uint32 nPeriodFrames = (nFrames < PERIOD_SIZE)? nFrames : PERIOD_SIZE ;
+    for (Uint32 channelN = 0 ; channelN < NChannels ; ++channelN)
+    {
+      const Sample* loops[NUM_LOOPS + 1] ; // + 1 - zero length arrays are not portable
+      for (Uint32 loopN = 0 ; loopN < NLoops ; ++loopN)
+        loops[loopN] = LoopBuffers[loopN][channelN] + loopFrameN ;
+      kernel(SilenceBuffer , OutBuffers[channelN] , RecordBuffer , loops , LoopVols , nPeriodFrames) ;
+
+      // fades are applied after the kernel so that the kernel is exactly the live one
+      if (gainInc == 0.0) continue ;
+
+      Sample* out = OutBuffers[channelN] ;
+      for (Uint32 frameN = 0 ; frameN < nPeriodFrames ; ++frameN)
+        out[frameN] *= gain + (gainInc * frameN) ;
+    }
+    if (!outFile->write(OutBuffers , NChannels , nPeriodFrames)) return false ;
+
+    NFramesWritten += nPeriodFrames ; loopFrameN += nPeriodFrames ;
+    gain           += gainInc * nPeriodFrames ; nFrames -= nPeriodFrames ;
+  }
+
+  return true ;
+}
+
+void Bounce::FreeBuffers()
+{
+  for (Uint32 channelN = 0 ; channelN < MAX_N_CHANNELS ; ++channelN)
+    if (OutBuffers[channelN]) { delete [] OutBuffers[channelN] ; OutBuffers[channelN] = 0 ; }
+  if (SilenceBuffer) { delete [] SilenceBuffer ; SilenceBuffer = 0 ; }
+  if (RecordBuffer)  { delete [] RecordBuffer ;  RecordBuffer  = 0 ; }
+}
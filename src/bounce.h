@@ -0,0 +1,122 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+
+#ifndef _BOUNCE_H_
+#define _BOUNCE_H_
+
+
+#include <atomic>
+#include <string>
+
+#include "loopidity.h"
+class Scene ;
+class WavFile ;
+
+
+using namespace std ;
+
+
+class Bounce
+{
+  friend class Loopidity ;
+
+
+  private:
+
+    /* Bounce class side private constants */
+
+    static const Uint32 PERIOD_SIZE ;
+
+
+    /* Bounce class side private varables */
+
+    // options
+    static string OutDir ;
+    static Uint32 NRepetitions ;
+
+    // job (snapshot of the scene taken in Begin())
+    static Uint32  SceneN ;
+    static Uint32  NChannels ;
+    static Uint32  SampleRate ;
+    static Uint32  NLoops ;
+    static Sample* LoopBuffers[NUM_LOOPS][MAX_N_CHANNELS] ;
+    static float   LoopVols[NUM_LOOPS] ;
+    static Uint32  SeamFrameN ;  // first frame of the loop body in the loop buffers
+    static Uint32  LoopNFrames ;
+    static Uint32  LeadInSize ;
+    static Uint32  LeadOutSize ;
+    static string  OutPath ;
+
+    // work buffers
+    static Sample* OutBuffers[MAX_N_CHANNELS] ;
+    static Sample* SilenceBuffer ; // stands in for the input
+    static Sample* RecordBuffer ;  // discarded kernel record output
+
+    // worker thread
+    static SDL_Thread*  WorkerThread ;
+    static atomic<bool> IsBouncing ;
+    static atomic<bool> IsRunning ;
+    static Uint32       NFramesWritten ;
+
+    // event structs
+    static SDL_Event DoneEvent ;
+
+
+    /* Bounce class side private functions */
+
+    // setup
+    static void Init(   const char* outDir , Uint32 nRepetitions) ;
+    static bool Begin(  Scene* scene) ;
+    static void Cleanup(void) ;
+
+    // worker thread
+    static int  Worker(    void* unused) ;
+    static bool RenderSpan(WavFile* outFile , Uint32 loopFrameN , Uint32 nFrames ,
+                           float    gain    , float  gainInc                     ) ;
+    static void FreeBuffers(void) ;
+} ;
+
+
+#endif // #ifndef _BOUNCE_H_
+
+
+/* NOTE: on bouncing
+
+    BounceScene() (F2) renders the current scene to BOUNCE_FILE_FMT in BOUNCE_DIR_ARG
+      (default '.') as 32 bit float WAV - the render is offline on a worker thread
+      and runs as fast as the CPU allows without touching the JACK thread or its buffers
+
+    GUI thread    -->
+        snapshots the loop buffers , vols , and mutes of the scene - muting follows
+          the live rule (a loop is silent if it and the scene are both muted)
+    worker thread -->
+        renders the lead-in , then NRepetitions (BOUNCE_REPS_ARG) of the loop body ,
+          then the lead-out and pushes EVT_BOUNCE_DONE
+        mixing goes through JackIO::SpanKernels - the same MixSpan() instances
+          that ProcessCallback() uses - with silence as the (unmonitored) input
+
+    the lead-in is the BufferMarginSize frames recorded before the loop seam - it fades in
+    the lead-out regions of the loop buffers are not yet filled (see note on RecordBuffer
+      layout in jack_io.h) so the lead-out continues the loop past its seam and fades out
+    loops carry no margins unless SCENE_NFRAMES_EDITABLE - then there is no lead-in or lead-out
+    loops are unlinked from their Scene on delete or reset but never freed so the
+      snapshot remains valid if the scene is edited while the bounce is in progress
+*/
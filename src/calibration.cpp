@@ -0,0 +1,166 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+#include "calibration.h"
+#include "jack_io.h"
+
+
+/* Calibration class side private constants */
+
+const Uint32 Calibration::IMPULSE_SIZE    = CALIBRATION_IMPULSE_SIZE ;
+const float  Calibration::MIN_CORRELATION = CALIBRATION_MIN_CORR ;
+
+
+/* Calibration class side private varables */
+
+// test signal and capture
+Sample* Calibration::Impulse       = 0 ; // Begin()
+Sample* Calibration::CaptureBuffer = 0 ; // Begin()
+Uint32  Calibration::CaptureSize   = 0 ; // Begin()
+Uint32  Calibration::CaptureFrameN = 0 ; // ProcessPeriod()
+
+// worker thread
+SDL_Thread*  Calibration::WorkerThread     = 0 ; // Begin()
+SDL_sem*     Calibration::CaptureDoneSem   = 0 ; // Begin()
+atomic<bool> Calibration::IsCapturing(false) ;   // Begin() , ProcessPeriod()
+bool         Calibration::IsSuccess(false) ;     // Worker()
+Uint32       Calibration::RoundTripLatency = 0 ; // Worker()
+
+// event structs
+SDL_Event Calibration::DoneEvent ; // Begin()
+
+
+/* Calibration class side private functions */
+
+// setup
+
+bool Calibration::Begin(Uint32 captureSize)
+{
+  if (IsCapturing || WorkerThread || captureSize <= IMPULSE_SIZE) return false ;
+
+  // initialize test signal and capture buffers
+  FreeBuffers() ; CaptureSize = captureSize ; CaptureFrameN = 0 ;
+  if (!(Impulse        = new (nothrow) Sample[IMPULSE_SIZE]()) ||
+      !(CaptureBuffer  = new (nothrow) Sample[CaptureSize]())  ||
+      !(CaptureDoneSem = SDL_CreateSemaphore(0))                )
+    { FreeBuffers() ; return false ; }
+
+  // pseudo-random burst - correlates to a single sharp peak even through AC coupling
+  Uint32 seed = 0x1234567 ;
+  for (Uint32 frameN = 0 ; frameN < IMPULSE_SIZE ; ++frameN)
+  {
+    seed            = (seed * 1103515245) + 12345 ;
+    Impulse[frameN] = (seed & 0x40000000)? 0.5 : -0.5 ;
+  }
+
+  // initialize SDL event struct
+  DoneEvent.type       = SDL_USEREVENT ;
+  DoneEvent.user.code  = EVT_CALIBRATION_DONE ;
+  DoneEvent.user.data1 = &RoundTripLatency ;
+  DoneEvent.user.data2 = &IsSuccess ;
+
+  // the worker blocks until the JACK thread has filled CaptureBuffer
+  IsSuccess = false ; RoundTripLatency = 0 ; IsCapturing = true ;
+  if (!(WorkerThread = SDL_CreateThread(Worker , 0)))
+    { IsCapturing = false ; FreeBuffers() ; return false ; }
+
+  return true ;
+}
+
+void Calibration::Cleanup()
+{
+  // the JACK thread has stopped if the capture is unfinished here - wake the worker
+  if (WorkerThread)
+  {
+    if (IsCapturing) { IsCapturing = false ; SDL_SemPost(CaptureDoneSem) ; }
+    SDL_WaitThread(WorkerThread , 0) ; WorkerThread = 0 ;
+  }
+
+  FreeBuffers() ;
+}
+
+void Calibration::FreeBuffers()
+{
+  if (Impulse)        { delete [] Impulse ;       Impulse        = 0 ; }
+  if (CaptureBuffer)  { delete [] CaptureBuffer ; CaptureBuffer  = 0 ; }
+  if (CaptureDoneSem) { SDL_DestroySemaphore(CaptureDoneSem) ; CaptureDoneSem = 0 ; }
+}
+
+
+// JACK thread
+
+void Calibration::ProcessPeriod(Sample* in , Sample* out , Uint32 nFrames)
+{
+  for (Uint32 frameN = 0 ; frameN < nFrames ; ++frameN)
+  {
+    Uint32 captureN = CaptureFrameN + frameN ;
+    out[frameN]     = (captureN < IMPULSE_SIZE)? Impulse[captureN] : 0.0 ;
+    if (captureN >= CaptureSize) continue ;
+
+    CaptureBuffer[captureN] = in[frameN] ;
+  }
+
+  if ((CaptureFrameN += nFrames) < CaptureSize) return ;
+
+  IsCapturing = false ; SDL_SemPost(CaptureDoneSem) ;
+}
+
+
+// worker thread
+
+int Calibration::Worker(void* unused)
+{
+  SDL_SemWait(CaptureDoneSem) ;
+  if (CaptureFrameN < CaptureSize) return 0 ; // aborted by Cleanup()
+
+  Uint32 latency ;
+  if ((IsSuccess = Analyze(&latency))) JackIO::SetRecordOffset(RoundTripLatency = latency) ;
+
+  // the buffers are freed and this thread is joined by Cleanup() on the main thread
+  SDL_PushEvent(&DoneEvent) ;
+
+  return 0 ;
+}
+
+bool Calibration::Analyze(Uint32* latency)
+{
+  // energy of the test signal - normalizes the correlation peak to 0.0 <= peak <= 1.0
+  float impulseEnergy = 0.0 ;
+  for (Uint32 frameN = 0 ; frameN < IMPULSE_SIZE ; ++frameN)
+    impulseEnergy += Impulse[frameN] * Impulse[frameN] ;
+
+  // find the lag of the strongest correlation
+  Uint32 nLags    = CaptureSize - IMPULSE_SIZE ;
+  float  bestCorr = 0.0 ; float bestEnergy = 0.0 ; Uint32 bestLag = 0 ;
+  for (Uint32 lag = 0 ; lag < nLags ; ++lag)
+  {
+    Sample* capture = CaptureBuffer + lag ; float corr = 0.0 , energy = 0.0 ;
+    for (Uint32 frameN = 0 ; frameN < IMPULSE_SIZE ; ++frameN)
+      { corr += Impulse[frameN] * capture[frameN] ; energy += capture[frameN] * capture[frameN] ; }
+
+    if (fabs(corr) > fabs(bestCorr)) { bestCorr = corr ; bestEnergy = energy ; bestLag = lag ; }
+  }
+
+  // reject silence and noise (e.g. the first output not patched back into the first input)
+  float norm = sqrt(impulseEnergy * bestEnergy) ;
+  if (norm <= 0.0 || fabs(bestCorr) / norm < MIN_CORRELATION) return false ;
+
+  *latency = bestLag ; return true ;
+}
@@ -0,0 +1,111 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+#ifndef _CALIBRATION_H_
+#define _CALIBRATION_H_
+
+
+#include <atomic>
+
+#include "loopidity.h"
+
+
+using namespace std ;
+
+
+class Calibration
+{
+  friend class JackIO ;
+  friend class Loopidity ;
+
+
+  private:
+
+    /* Calibration class side private constants */
+
+    static const Uint32 IMPULSE_SIZE ;
+    static const float  MIN_CORRELATION ;
+
+
+    /* Calibration class side private varables */
+
+    // test signal and capture
+    static Sample* Impulse ;
+    static Sample* CaptureBuffer ;
+    static Uint32  CaptureSize ;
+    static Uint32  CaptureFrameN ;
+
+    // worker thread
+    static SDL_Thread*  WorkerThread ;
+    static SDL_sem*     CaptureDoneSem ;
+    static atomic<bool> IsCapturing ;
+    static bool         IsSuccess ;
+    static Uint32       RoundTripLatency ;
+
+    // event structs
+    static SDL_Event DoneEvent ;
+
+
+    /* Calibration class side private functions */
+
+    // setup
+    static bool Begin(      Uint32 captureSize) ;
+    static void Cleanup(    void) ;
+    static void FreeBuffers(void) ;
+
+    // JACK thread
+    static void ProcessPeriod(Sample* in , Sample* out , Uint32 nFrames) ;
+
+    // worker thread
+    static int  Worker( void* unused) ;
+    static bool Analyze(Uint32* latency) ;
+} ;
+
+
+#endif // #ifndef _CALIBRATION_H_
+
+
+/* NOTE: on latency calibration
+
+    the round trip is measured once at startup (CALIBRATE_ARG) with the first output
+      patched back into the first input by cable or via the JACK graph - these are
+      outL and inL in stereo and out1 and in1 otherwise (see JackBackend::MakePortNames())
+
+    JACK thread   -->
+        mutes all outputs but the first and stops advancing the scene
+        writes Impulse (a short pseudo-random burst) to the first output
+        copies the first input into CaptureBuffer until CaptureSize frames are captured
+        posts CaptureDoneSem
+    worker thread -->
+        cross-correlates Impulse against CaptureBuffer
+        the lag of the strongest correlation is the round trip in frames
+        stores it via JackIO::SetRecordOffset() and pushes EVT_CALIBRATION_DONE
+    main thread   -->
+        Loopidity::OnCalibrationDone() joins the worker via Cleanup() and reports
+          IsSuccess and RoundTripLatency (a zero round trip is a valid measurement)
+        Cleanup() also runs at exit - after the JACK thread has stopped - and wakes
+          a worker that is still waiting on an unfinished capture
+
+    CaptureSize is BufferMarginSize - the record offset is applied as a read-ahead
+      into the loop buffers so it must never exceed the margin
+
+    the dummy backend can simulate the cable (see DUMMY_LOOPBACK_ARG in dummy_backend.h)
+      which allows exercising the whole path without any hardware
+*/
@@ -0,0 +1,254 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+
+#include "dummy_backend.h"
+
+
+/* DummyBackend class side private constants */
+
+const Uint32 DummyBackend::BUFFER_SIZE = DUMMY_IO_BUFFER_SIZE ;
+
+
+/* DummyBackend instance side public functions */
+
+DummyBackend::DummyBackend(const char* inPath       , const char* outPath    , bool isRealtime ,
+                           Uint32      loopbackSize , const char* scriptPath                   ) :
+    inPath(inPath) , outPath(outPath) , inFile(0) , outFile(0) , nChannels(0) ,
+    loopbackSize(loopbackSize) , loopbackFrameN(0) , scriptPath((scriptPath)? scriptPath : "") ,
+    scriptEventN(0) , syncSem(0) , clockThread(0) , isRunning(false) , isRealtime(isRealtime) ,
+    dspLoad(0.0) {}
+
+DummyBackend::~DummyBackend() { close() ; }
+
+
+// setup
+
+Uint32 DummyBackend::open(Uint32 nChannels , bool shouldOutputStems)
+{
+  if (!(inFile = new (nothrow) WavFile()) || !(outFile = new (nothrow) WavFile()))
+    return JACK_MEM_FAIL ;
+
+  // the input file sets the clock rate
+  if (!inFile->openRead(inPath.c_str()))
+    { printf(DUMMY_IO_FAIL_FMT , inPath.c_str()) ; return JACK_SW_FAIL ; }
+  if (!outFile->openWrite(outPath.c_str() , nChannels , inFile->getSampleRate()))
+    { printf(DUMMY_IO_FAIL_FMT , outPath.c_str()) ; return JACK_SW_FAIL ; }
+
+  // period buffers stand in for the JACK port buffers
+  this->nChannels = nChannels ;
+  for (Uint32 channelN = 0 ; channelN < nChannels ; ++channelN)
+  {
+    inBuffers .push_back(new (nothrow) Sample[BUFFER_SIZE]()) ;
+    outBuffers.push_back(new (nothrow) Sample[BUFFER_SIZE]()) ;
+    if (!inBuffers.back() || !outBuffers.back()) return JACK_MEM_FAIL ;
+  }
+
+  // a sample can not be looped back within the period that produced it
+  if (loopbackSize && loopbackSize < BUFFER_SIZE) loopbackSize = BUFFER_SIZE ;
+  loopbackRing.assign(loopbackSize , 0.0) ;
+
+  // the keys a user would press and the event that reports them handled
+  if (!scriptPath.empty())
+  {
+    if (!readScript()) { printf(DUMMY_SCRIPT_FAIL_FMT , scriptPath.c_str()) ; return JACK_SW_FAIL ; }
+    if (!(syncSem = SDL_CreateSemaphore(0))) return JACK_MEM_FAIL ;
+
+    keyEvent.type             = SDL_KEYDOWN ;
+    keyEvent.key.state        = SDL_PRESSED ;
+    keyEvent.key.keysym.mod   = KMOD_NONE ;
+    syncEvent.type            = SDL_USEREVENT ;
+    syncEvent.user.code       = EVT_DUMMY_SYNC ;
+    syncEvent.user.data1      = syncSem ;
+    syncEvent.user.data2      = 0 ; // unused
+  }
+
+  // propogate simulated server state
+  JackIO::FormatCallback(inFile->getSampleRate() , BUFFER_SIZE) ;
+
+  return JACK_INIT_SUCCESS ;
+}
+
+bool DummyBackend::activate()
+{
+  if (clockThread) return true ;
+
+  isRunning = true ;
+  if (!(clockThread = SDL_CreateThread(Clock , this))) isRunning = false ;
+
+  return !!clockThread ;
+}
+
+void DummyBackend::close()
+{
+  // stop the clock before the buffers it writes into go away
+  isRunning = false ;
+  if (clockThread) { SDL_WaitThread(clockThread , 0) ; clockThread = 0 ; }
+  if (syncSem)     { SDL_DestroySemaphore(syncSem) ;   syncSem     = 0 ; }
+  if (inFile)      { delete inFile ;  inFile  = 0 ; } // closes the file
+  if (outFile)     { delete outFile ; outFile = 0 ; } // patches the WAV header
+
+  for (Uint32 channelN = 0 ; channelN < inBuffers.size() ; ++channelN)
+    { delete [] inBuffers[channelN] ; delete [] outBuffers[channelN] ; }
+  inBuffers.clear() ; outBuffers.clear() ;
+}
+
+
+// getters
+
+Uint32 DummyBackend::getSampleRate() { return (inFile)? inFile->getSampleRate() : 0 ; }
+
+Uint32 DummyBackend::getBufferSize() { return BUFFER_SIZE ; }
+
+float DummyBackend::getDspLoad() { return dspLoad.load(memory_order_relaxed) ; }
+
+
+// process thread
+
+void DummyBackend::getBuffers(Uint32 nFrames , Sample** inBuffers , Sample** outBuffers)
+{
+  for (Uint32 channelN = 0 ; channelN < nChannels ; ++channelN)
+  {
+    inBuffers [channelN] = this->inBuffers [channelN] ;
+    outBuffers[channelN] = this->outBuffers[channelN] ;
+  }
+}
+
+Sample* DummyBackend::getStemBuffer(Uint32 stemN , Uint32 nFrames) { return 0 ; }
+
+
+/* DummyBackend instance side private functions */
+
+// setup
+
+bool DummyBackend::readScript()
+{
+  FILE* file = fopen(scriptPath.c_str() , "r") ; if (!file) return false ;
+
+  unsigned long long frameN ; char action[16] ; int nFields ; bool isValid = true ;
+  while (isValid && (nFields = fscanf(file , "%llu %15s" , &frameN , action)) == 2)
+  {
+    DummyScriptEvent event = { frameN , (!strcmp(action , DUMMY_SCRIPT_TRIGGER))? SDLK_SPACE :
+                                        (!strcmp(action , DUMMY_SCRIPT_SCENE))?   SDLK_KP0   :
+                                                                                  SDLK_UNKNOWN } ;
+    isValid = event.key != SDLK_UNKNOWN && (script.empty() || frameN >= script.back().frameN) ;
+    if (isValid) script.push_back(event) ;
+  }
+  fclose(file) ;
+
+  return isValid && nFields == EOF ;
+}
+
+
+// clock thread
+
+int DummyBackend::runClock()
+{
+  JackIO::ThreadInitCallback() ;
+
+  Uint32 sampleRate  = inFile->getSampleRate() ;
+  Uint64 periodUsecs = ((Uint64)BUFFER_SIZE * 1000000) / sampleRate ;
+  Uint64 startUsecs  = NowUsecs() ;
+  for (Uint64 periodN = 1 ; isRunning ; ++periodN)
+  {
+    // let the main thread act on any scripted keys due within this period
+    startUsecs += replayScript(periodN * BUFFER_SIZE) ;
+
+    // short reads are zero filled - the last period is processed in full
+    Uint32 nFramesRead = inFile->read(&inBuffers[0] , nChannels , BUFFER_SIZE) ;
+    if (loopbackSize) readLoopback() ;
+
+    Uint64 beginUsecs = NowUsecs() ;
+    JackIO::ProcessCallback(BUFFER_SIZE) ;
+    Uint64 endUsecs   = NowUsecs() ;
+    dspLoad.store((endUsecs - beginUsecs) * 100.0 / periodUsecs , memory_order_relaxed) ;
+
+    if (loopbackSize) feedLoopback() ;
+
+    outFile->write(&outBuffers[0] , nChannels , BUFFER_SIZE) ;
+    if (nFramesRead < BUFFER_SIZE) break ;
+
+    if (!isRealtime) continue ;
+
+    // pace against the start time rather than the last period so that errors do not accumulate
+    Uint64 deadlineUsecs = startUsecs + (periodN * BUFFER_SIZE * 1000000) / sampleRate ;
+    Uint64 nowUsecs      = NowUsecs() ;
+    if      (nowUsecs > deadlineUsecs + periodUsecs) JackIO::XrunCallback() ;
+    else if (nowUsecs < deadlineUsecs)               SDL_Delay((deadlineUsecs - nowUsecs) / 1000) ;
+  }
+
+  // end of input - let a headless run exit
+  SDL_Event quitEvent ; quitEvent.type = SDL_QUIT ; pushEvent(&quitEvent) ;
+
+  return 0 ;
+}
+
+
+void DummyBackend::readLoopback()
+{
+  // loopbackRing[frameN % loopbackSize] holds outL from loopbackSize frames ago
+  for (Uint32 frameN = 0 ; frameN < BUFFER_SIZE ; ++frameN)
+    inBuffers[0][frameN] = loopbackRing[(loopbackFrameN + frameN) % loopbackSize] ;
+}
+
+void DummyBackend::feedLoopback()
+{
+  for (Uint32 frameN = 0 ; frameN < BUFFER_SIZE ; ++frameN)
+    loopbackRing[(loopbackFrameN + frameN) % loopbackSize] = outBuffers[0][frameN] ;
+
+  loopbackFrameN += BUFFER_SIZE ;
+}
+
+Uint64 DummyBackend::replayScript(Uint64 endFrameN)
+{
+  if (scriptEventN >= script.size() || script[scriptEventN].frameN >= endFrameN) return 0 ;
+
+  // the main thread reads the scene frame counters that only this thread advances
+  //   so while this thread waits the actions land exactly within this period
+  Uint64 beginUsecs = NowUsecs() ;
+  for ( ; scriptEventN < script.size() && script[scriptEventN].frameN < endFrameN ; ++scriptEventN)
+    { keyEvent.key.keysym.sym = script[scriptEventN].key ; pushEvent(&keyEvent) ; }
+  if (pushEvent(&syncEvent))
+    while (isRunning && SDL_SemWaitTimeout(syncSem , 100) == SDL_MUTEX_TIMEDOUT) ;
+
+  return NowUsecs() - beginUsecs ;
+}
+
+bool DummyBackend::pushEvent(SDL_Event* event)
+{
+  // the clock starts before SDL is initialized and SDL_PushEvent() fails until it is
+  while (isRunning && SDL_PushEvent(event) < 0) SDL_Delay(1) ;
+
+  return isRunning ;
+}
+
+
+/* DummyBackend class side private functions */
+
+// clock thread
+
+int DummyBackend::Clock(void* backend) { return ((DummyBackend*)backend)->runClock() ; }
+
+Uint64 DummyBackend::NowUsecs()
+{
+  timespec now ; clock_gettime(CLOCK_MONOTONIC , &now) ;
+
+  return ((Uint64)now.tv_sec * 1000000) + (now.tv_nsec / 1000) ;
+}
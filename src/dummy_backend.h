@@ -0,0 +1,165 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+
+#ifndef _DUMMY_BACKEND_H_
+#define _DUMMY_BACKEND_H_
+
+
+#include <atomic>
+#include <string>
+
+#include "loopidity.h"
+class WavFile ;
+
+
+using namespace std ;
+
+
+typedef struct DummyScriptEvent
+{
+  Uint64 frameN ; // input file frame that the key is pressed within
+  SDLKey key ;
+} DummyScriptEvent ;
+
+
+class DummyBackend : public AudioBackend
+{
+  private:
+
+    /* DummyBackend class side private constants */
+
+    static const Uint32 BUFFER_SIZE ;
+
+
+  public:
+
+    /* DummyBackend instance side public functions */
+
+    DummyBackend(const char* inPath       , const char* outPath    , bool isRealtime ,
+                 Uint32      loopbackSize , const char* scriptPath                   ) ;
+    ~DummyBackend() ;
+
+    // setup
+    Uint32 open(    Uint32 nChannels , bool shouldOutputStems) ;
+    bool   activate(void) ;
+    void   close(   void) ;
+
+    // getters
+    Uint32 getSampleRate(void) ;
+    Uint32 getBufferSize(void) ;
+    float  getDspLoad(   void) ;
+
+    // process thread
+    void    getBuffers(   Uint32 nFrames , Sample** inBuffers , Sample** outBuffers) ;
+    Sample* getStemBuffer(Uint32 stemN   , Uint32 nFrames) ;
+
+
+  private:
+
+    /* DummyBackend instance side private varables */
+
+    // files
+    string   inPath ;
+    string   outPath ;
+    WavFile* inFile ;
+    WavFile* outFile ;
+
+    // period buffers
+    Uint32          nChannels ;
+    vector<Sample*> inBuffers ;  // one per channel
+    vector<Sample*> outBuffers ; // one per channel
+
+    // simulated outL -> inL cable
+    Uint32         loopbackSize ; // nFrames - 0 if unpatched
+    vector<Sample> loopbackRing ; // outL delayed by loopbackSize frames
+    Uint64         loopbackFrameN ;
+
+    // trigger script
+    string                   scriptPath ;   // empty if unscripted
+    vector<DummyScriptEvent> script ;       // ascending frameN
+    Uint32                   scriptEventN ; // next to replay
+    SDL_Event                keyEvent ;
+    SDL_Event                syncEvent ;
+    SDL_sem*                 syncSem ;
+
+    // clock thread
+    SDL_Thread*   clockThread ;
+    atomic<bool>  isRunning ;
+    bool          isRealtime ;
+    atomic<float> dspLoad ;
+
+
+    /* DummyBackend instance side private functions */
+
+    // setup
+    bool readScript(void) ;
+
+    // clock thread
+    int    runClock(    void) ;
+    void   readLoopback(void) ;
+    void   feedLoopback(void) ;
+    Uint64 replayScript(Uint64 endFrameN) ;
+    bool   pushEvent(   SDL_Event* event) ;
+
+
+    /* DummyBackend class side private functions */
+
+    // clock thread
+    static int    Clock(   void* backend) ;
+    static Uint64 NowUsecs(void) ;
+} ;
+
+
+#endif // #ifndef _DUMMY_BACKEND_H_
+
+
+/* NOTE: on the dummy backend
+
+    DUMMY_IO_ARG <in.wav> <out.wav> runs the complete looper - scenes , triggers ,
+      and loop commits - without a JACK server
+    the input file sets the sample rate and the period is DUMMY_IO_BUFFER_SIZE frames
+    the clock thread stands in for the JACK process thread - each period it
+        reads one period of the input file into the input buffers
+        calls JackIO::ProcessCallback()
+        appends the output buffers to the output file
+    by default periods are paced to the sample rate - if a period finishes later than
+      one period past its deadline that is reported as an xrun
+    FREE_RUN_ARG drops the pacing so the input is processed as fast as possible
+      getDspLoad() is the fraction of the period spent in ProcessCallback() either way
+    when the input is exhausted SDL_QUIT is pushed so that a HEADLESS_ARG run exits
+      and the output file is finalized by JackIO::Cleanup()
+    stems are not supported - getStemBuffer() always returns 0
+
+    DUMMY_LOOPBACK_ARG <nFrames> simulates outL patched back into inL - inL is replaced
+      by outL delayed by nFrames (at least one period) so that CALIBRATE_ARG can be
+      exercised without any hardware and must measure back exactly nFrames
+
+    DUMMY_SCRIPT_ARG <script.txt> replays user actions against the input file timeline -
+      each line is '<frameN> <action>' in ascending frame order where the action is
+        DUMMY_SCRIPT_TRIGGER --> the SDLK_SPACE trigger (Loopidity::ToggleRecordingState())
+        DUMMY_SCRIPT_SCENE   --> SDLK_KP0 (Loopidity::ToggleNextScene())
+      before processing a period the clock thread pushes the key events due within it
+        then an EVT_DUMMY_SYNC event and waits until the main thread has handled them all
+        so each action takes effect in the period its frameN falls within on every run
+      the clock is started by JackIO::Init() so frame 0 is the first frame of the input
+        file - events pushed before SDL is initialized are retried until it is
+      the time spent waiting is not counted against the pacing so it is never an xrun
+*/
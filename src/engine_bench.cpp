@@ -0,0 +1,241 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+
+#include <ctime>
+
+#include "engine_bench.h"
+
+
+/* EngineBench class side private varables */
+
+// period buffers
+Sample* EngineBench::InBuffers [MAX_N_CHANNELS] = { 0 } ; // Init()
+Sample* EngineBench::OutBuffers[MAX_N_CHANNELS] = { 0 } ; // Init()
+Uint32  EngineBench::NChannels                  = DEFAULT_N_CHANNELS ;
+
+
+/* EngineBench class side public functions */
+
+int EngineBench::Main(int argc , char** argv)
+{
+  // parse args
+  Uint32 periods[ENGINE_BENCH_MAX_CASES] , loops[ENGINE_BENCH_MAX_CASES] ;
+  Uint32 seconds[ENGINE_BENCH_MAX_CASES] , mutes[ENGINE_BENCH_MAX_CASES] ;
+  Uint32 nPeriods  = ParseList(ENGINE_BENCH_PERIODS , periods) ;
+  Uint32 nLoops    = ParseList(ENGINE_BENCH_LOOPS   , loops) ;
+  Uint32 nSeconds  = ParseList(ENGINE_BENCH_SECONDS , seconds) ;
+  Uint32 nMutes    = ParseList(ENGINE_BENCH_MUTES   , mutes) ;
+  Uint32 duration  = ENGINE_BENCH_DURATION ; bool isMonitoring = true ;
+  for (int argN = 1 ; argN < argc ; ++argN)
+  {
+    if      (!strcmp(argv[argN] , MONITOR_ARG)) isMonitoring = false ;
+    else if (argN + 1 >= argc) break ;
+    else if (!strcmp(argv[argN] , CHANNELS_ARG))
+      NChannels = atoi(argv[++argN]) ;
+    else if (!strcmp(argv[argN] , ENGINE_BENCH_DURATION_ARG))
+      duration = atoi(argv[++argN]) ;
+    else if (!strcmp(argv[argN] , ENGINE_BENCH_PERIODS_ARG))
+      nPeriods = ParseList(argv[++argN] , periods) ;
+    else if (!strcmp(argv[argN] , ENGINE_BENCH_LOOPS_ARG))
+      nLoops = ParseList(argv[++argN] , loops) ;
+    else if (!strcmp(argv[argN] , ENGINE_BENCH_SECONDS_ARG))
+      nSeconds = ParseList(argv[++argN] , seconds) ;
+    else if (!strcmp(argv[argN] , ENGINE_BENCH_MUTES_ARG))
+      nMutes = ParseList(argv[++argN] , mutes) ;
+  }
+
+  // validate args
+  const char* invalidArg = 0 ;
+  if (!NChannels || NChannels > MAX_N_CHANNELS) invalidArg = CHANNELS_ARG ;
+  if (!duration)                                invalidArg = ENGINE_BENCH_DURATION_ARG ;
+  if (!nMutes)                                  invalidArg = ENGINE_BENCH_MUTES_ARG ;
+  for (Uint32 caseN = 0 ; caseN < nPeriods ; ++caseN)
+    if (!periods[caseN] || periods[caseN] > ENGINE_BENCH_MAX_PERIOD)
+      invalidArg = ENGINE_BENCH_PERIODS_ARG ;
+  for (Uint32 caseN = 0 ; caseN < nLoops ; ++caseN)
+    if (loops[caseN] > NUM_LOOPS) invalidArg = ENGINE_BENCH_LOOPS_ARG ;
+  for (Uint32 caseN = 0 ; caseN < nSeconds ; ++caseN)
+    if (!seconds[caseN]) invalidArg = ENGINE_BENCH_SECONDS_ARG ;
+  if (!nPeriods) invalidArg = ENGINE_BENCH_PERIODS_ARG ;
+  if (!nLoops)   invalidArg = ENGINE_BENCH_LOOPS_ARG ;
+  if (!nSeconds) invalidArg = ENGINE_BENCH_SECONDS_ARG ;
+  if (invalidArg) { printf(ENGINE_BENCH_ARG_FAIL_FMT , invalidArg) ; return EXIT_FAILURE ; }
+
+  // the record buffer must hold the longest loop plus its margins
+  Uint32 maxSeconds = 0 ;
+  for (Uint32 caseN = 0 ; caseN < nSeconds ; ++caseN)
+    if (maxSeconds < seconds[caseN]) maxSeconds = seconds[caseN] ;
+  Uint32 recordBufferSize = (maxSeconds + 3) * ENGINE_BENCH_SAMPLE_RATE * sizeof(Sample) ;
+  if (!Init() || JackIO::InitOffline(isMonitoring , recordBufferSize , NChannels) != JACK_INIT_SUCCESS)
+    { printf(ENGINE_BENCH_INIT_FAIL_MSG) ; Cleanup() ; return EXIT_FAILURE ; }
+
+  printf(ENGINE_BENCH_HEADER_FMT , "period" , "nLoops" , "nSeconds" , "muteMask" ,
+         "ns/frame" , "xRealtime" , "worst (us)" , "worst (%)") ;
+  for (Uint32 periodN = 0 ; periodN < nPeriods ; ++periodN)
+    for (Uint32 loopsN = 0 ; loopsN < nLoops ; ++loopsN)
+      for (Uint32 secondsN = 0 ; secondsN < nSeconds ; ++secondsN)
+        for (Uint32 muteN = 0 ; muteN < nMutes ; ++muteN)
+          if (!RunCase(periods[periodN] , loops[loopsN] , seconds[secondsN] , mutes[muteN] , duration))
+            { printf(ENGINE_BENCH_INIT_FAIL_MSG) ; Cleanup() ; return EXIT_FAILURE ; }
+
+  Cleanup() ; return EXIT_SUCCESS ;
+}
+
+
+/* EngineBench class side private functions */
+
+// setup
+
+bool EngineBench::Init()
+{
+  for (Uint32 channelN = 0 ; channelN < NChannels ; ++channelN)
+  {
+    if (!(InBuffers [channelN] = new (nothrow) Sample[ENGINE_BENCH_MAX_PERIOD]()) ||
+        !(OutBuffers[channelN] = new (nothrow) Sample[ENGINE_BENCH_MAX_PERIOD]())  )
+      return false ;
+
+    Fill(InBuffers[channelN] , ENGINE_BENCH_MAX_PERIOD , channelN + 1) ;
+  }
+
+  return true ;
+}
+
+void EngineBench::Cleanup()
+{
+  for (Uint32 channelN = 0 ; channelN < MAX_N_CHANNELS ; ++channelN)
+  {
+    if (InBuffers [channelN]) { delete [] InBuffers [channelN] ; InBuffers [channelN] = 0 ; }
+    if (OutBuffers[channelN]) { delete [] OutBuffers[channelN] ; OutBuffers[channelN] = 0 ; }
+  }
+}
+
+Uint32 EngineBench::ParseList(const char* arg , Uint32* values)
+{
+  Uint32 nValues = 0 ; char* end = const_cast<char*>(arg) ;
+  while (*end && nValues < ENGINE_BENCH_MAX_CASES)
+  {
+    values[nValues++] = strtoul(end , &end , 0) ;
+    if (*end == ',') ++end ; else if (*end) return 0 ;
+  }
+
+  return nValues ;
+}
+
+
+// measurement
+
+bool EngineBench::RunCase(Uint32 nFramesPerPeriod , Uint32 nLoops , Uint32 nSeconds ,
+                          Uint32 muteMask         , Uint32 duration                 )
+{
+  JackIO::SetOfflinePeriod(ENGINE_BENCH_SAMPLE_RATE , nFramesPerPeriod) ;
+  Scene* scene = CreateScene(nFramesPerPeriod , nLoops , nSeconds , muteMask) ;
+  if (!scene) return false ;
+
+  JackIO::SetCurrentScene(scene) ; JackIO::SetNextScene(scene) ;
+
+  // one untimed pass over the loop so that every page has been touched
+  // rollovers may unmute the scene (AUTO_UNMUTE_LOOPS_ON_ROLLOVER) - the mutes are restored
+  Uint32 nPeriodsPerLoop = scene->nFrames / nFramesPerPeriod ; bool isMuted = scene->isMuted ;
+  for (Uint32 periodN = 0 ; periodN < nPeriodsPerLoop ; ++periodN)
+    { JackIO::ProcessOffline(InBuffers , OutBuffers , nFramesPerPeriod) ; scene->isMuted = isMuted ; }
+
+  // time each period - the total excludes the loop and timer overhead between periods
+  Uint32 nPeriods = (duration * ENGINE_BENCH_SAMPLE_RATE) / nFramesPerPeriod ;
+  double total    = 0.0 , worst = 0.0 ;
+  for (Uint32 periodN = 0 ; periodN < nPeriods ; ++periodN)
+  {
+    double begin = Now() ;
+    JackIO::ProcessOffline(InBuffers , OutBuffers , nFramesPerPeriod) ;
+    double elapsed = Now() - begin ; total += elapsed ; if (worst < elapsed) worst = elapsed ;
+    scene->isMuted = isMuted ;
+  }
+
+  double nFrames = (double)nPeriods * nFramesPerPeriod ;
+  double budget  = (nFramesPerPeriod * 1000000000.0) / ENGINE_BENCH_SAMPLE_RATE ;
+  printf(ENGINE_BENCH_ROW_FMT , nFramesPerPeriod , nLoops , nSeconds , muteMask ,
+         total / nFrames , (nFrames * 1000000000.0) / (total * ENGINE_BENCH_SAMPLE_RATE) ,
+         worst / 1000.0 , (worst * 100.0) / budget) ;
+
+  JackIO::SetCurrentScene(0) ; JackIO::SetNextScene(0) ; DestroyScene(scene) ;
+
+  return true ;
+}
+
+Scene* EngineBench::CreateScene(Uint32 nFramesPerPeriod , Uint32 nLoops , Uint32 nSeconds ,
+                                Uint32 muteMask                                         )
+{
+  Scene* scene ; try { scene = new Scene(0) ; } catch(exception& ex) { return 0 ; }
+
+  // the same state that Scene::toggleRecordingState() leaves once the base loop exists
+  Uint32 nFrames        = ((nSeconds * ENGINE_BENCH_SAMPLE_RATE) / nFramesPerPeriod) * nFramesPerPeriod ;
+  scene->nFrames        = nFrames ;
+  scene->nBytes         = nFrames * sizeof(Sample) ;
+  scene->nSeconds       = nSeconds ;
+  scene->endFrameN      = scene->beginFrameN + nFrames ;
+  scene->currentFrameN  = scene->beginFrameN ;
+  scene->shouldSaveLoop = false ;
+  scene->doesPulseExist = true ;
+  scene->isMuted        = !!muteMask ;
+
+  // loop buffers span the scene plus a margin at each end (see note on RecordBuffer layout)
+  Uint32 nLoopFrames = nFrames + (scene->beginFrameN * 2) ;
+  for (Uint32 loopN = 0 ; loopN < nLoops ; ++loopN)
+  {
+    Loop* loop ; try { loop = new Loop(nLoopFrames , NChannels) ; }
+    catch(exception& ex) { DestroyScene(scene) ; return 0 ; }
+
+    for (Uint32 channelN = 0 ; channelN < NChannels ; ++channelN)
+      Fill(loop->buffers[channelN] , nLoopFrames , (loopN * MAX_N_CHANNELS) + channelN + 1) ;
+    loop->vol     = 1.0 / NUM_LOOPS ;
+    loop->isMuted = !!(muteMask & (1 << loopN)) ;
+    scene->loops.push_back(loop) ;
+  }
+
+  return scene ;
+}
+
+void EngineBench::DestroyScene(Scene* scene)
+{
+  while (!scene->loops.empty()) { delete scene->loops.back() ; scene->loops.pop_back() ; }
+  delete scene ;
+}
+
+void EngineBench::Fill(Sample* buffer , Uint32 nFrames , Uint32 seed)
+{
+  // uniform noise in -0.5 <= sample < 0.5 - denormals and silence would flatter the mix
+  for (Uint32 frameN = 0 ; frameN < nFrames ; ++frameN)
+  {
+    seed           = (seed * 1103515245) + 12345 ;
+    buffer[frameN] = (Sample)((seed >> 8) & 0xFFFF) / 65536.0 - 0.5 ;
+  }
+}
+
+double EngineBench::Now()
+{
+  timespec now ; clock_gettime(CLOCK_MONOTONIC , &now) ;
+
+  return (now.tv_sec * 1000000000.0) + now.tv_nsec ;
+}
+
+
+/* entry point */
+
+int main(int argc , char** argv) { return EngineBench::Main(argc , argv) ; }
@@ -0,0 +1,111 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+
+#ifndef _ENGINE_BENCH_H_
+#define _ENGINE_BENCH_H_
+
+
+#include "loopidity.h"
+
+
+#define ENGINE_BENCH_PERIODS_ARG   "--periods"
+#define ENGINE_BENCH_LOOPS_ARG     "--loops"
+#define ENGINE_BENCH_SECONDS_ARG   "--seconds"
+#define ENGINE_BENCH_MUTES_ARG     "--mutes"
+#define ENGINE_BENCH_DURATION_ARG  "--duration"
+#define ENGINE_BENCH_PERIODS       "16,32,64,128,256,512,1024,2048"
+#define ENGINE_BENCH_LOOPS         "0,1,4,9"
+#define ENGINE_BENCH_SECONDS       "10"
+#define ENGINE_BENCH_MUTES         "0,0x0AA" // none , every other loop
+#define ENGINE_BENCH_DURATION      10        // nSeconds of audio per case
+#define ENGINE_BENCH_SAMPLE_RATE   48000
+#define ENGINE_BENCH_MAX_PERIOD    2048
+#define ENGINE_BENCH_MAX_CASES     32        // per list argument
+#define ENGINE_BENCH_HEADER_FMT    "\n%-6s %-6s %-8s %-8s %10s %10s %10s %10s\n"
+#define ENGINE_BENCH_ROW_FMT       "%-6d %-6d %-8d 0x%03X    %10.2f %10.1f %10.1f %9.1f%%\n"
+#define ENGINE_BENCH_INIT_FAIL_MSG "ERROR: EngineBench: could not initialize the engine\n"
+#define ENGINE_BENCH_ARG_FAIL_FMT  "ERROR: EngineBench: invalid value for '%s'\n"
+
+
+using namespace std ;
+
+
+class EngineBench
+{
+  public:
+
+    /* EngineBench class side public functions */
+
+    static int Main(int argc , char** argv) ;
+
+
+  private:
+
+    /* EngineBench class side private varables */
+
+    // period buffers (stand in for the JACK port buffers)
+    static Sample* InBuffers [MAX_N_CHANNELS] ;
+    static Sample* OutBuffers[MAX_N_CHANNELS] ;
+    static Uint32  NChannels ;
+
+
+    /* EngineBench class side private functions */
+
+    // setup
+    static bool   Init(       void) ;
+    static void   Cleanup(    void) ;
+    static Uint32 ParseList(  const char* arg , Uint32* values) ;
+
+    // measurement
+    static bool   RunCase(    Uint32 nFramesPerPeriod , Uint32 nLoops , Uint32 nSeconds ,
+                              Uint32 muteMask         , Uint32 duration                 ) ;
+    static Scene* CreateScene(Uint32 nFramesPerPeriod , Uint32 nLoops , Uint32 nSeconds ,
+                              Uint32 muteMask                                         ) ;
+    static void   DestroyScene(Scene* scene) ;
+    static void   Fill(       Sample* buffer , Uint32 nFrames , Uint32 seed) ;
+    static double Now(        void) ;
+} ;
+
+
+#endif // #ifndef _ENGINE_BENCH_H_
+
+
+/* NOTE: on the engine benchmark
+
+    loopidity-enginebench (make enginebench) drives JackIO through the offline driver
+      (see note on the offline driver in jack_io.h) so it runs without a JACK server
+    every combination of the list arguments is one case -->
+        ENGINE_BENCH_PERIODS_ARG  period sizes in frames (16 - 2048)
+        ENGINE_BENCH_LOOPS_ARG    loop counts (0 - NUM_LOOPS)
+        ENGINE_BENCH_SECONDS_ARG  loop lengths in seconds
+        ENGINE_BENCH_MUTES_ARG    mute masks - bit N mutes loop N (and the scene is muted)
+      lists are comma separated (e.g. --periods 64,256 --mutes 0,0x1FF)
+      CHANNELS_ARG and MONITOR_ARG are honoured as for loopidity
+
+    each case processes ENGINE_BENCH_DURATION (or ENGINE_BENCH_DURATION_ARG) seconds of
+      synthetic audio at ENGINE_BENCH_SAMPLE_RATE - the loops are filled with noise and
+      recording is off so that rollovers occur but no loops are created
+    columns -->
+        ns/frame   mean cost of one frame (all channels)
+        xRealtime  seconds of audio processed per second of CPU
+        worst (us) the slowest single period
+        worst (%)  the slowest single period as a share of its real-time budget
+*/
@@ -0,0 +1,110 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+#include "frame_scheduler.h"
+
+
+/* FrameScheduler class side private varables */
+
+// pacing
+Uint32 FrameScheduler::TargetInterval = 1000 / GUI_DEFAULT_FPS ; // Init()
+Uint32 FrameScheduler::IdleInterval   = 1000 / GUI_IDLE_FPS ;    // Init()
+Uint32 FrameScheduler::MinInterval    = 1000 / GUI_MAX_FPS ;
+Uint32 FrameScheduler::Deadline       = 0 ;                      // WaitForNextFrame()
+Uint32 FrameScheduler::FrameBegin     = 0 ;                      // WaitForNextFrame()
+Uint32 FrameScheduler::LastWakeTime   = 0 ;                      // Wake()
+
+// wakeups
+SDL_mutex* FrameScheduler::WakeMutex = 0 ;     // Init()
+SDL_cond*  FrameScheduler::WakeCond  = 0 ;     // Init()
+bool       FrameScheduler::IsWoken   = false ; // Wake() , WaitForNextFrame()
+
+
+/* FrameScheduler class side private functions */
+
+// setup
+
+bool FrameScheduler::Init(Uint32 targetFps)
+{
+  if (targetFps < GUI_MIN_FPS || targetFps > GUI_MAX_FPS) targetFps = GUI_DEFAULT_FPS ;
+
+  TargetInterval = 1000 / targetFps ;
+  IdleInterval   = (TargetInterval > 1000 / GUI_IDLE_FPS)? TargetInterval : 1000 / GUI_IDLE_FPS ;
+  Deadline       = FrameBegin = LastWakeTime = SDL_GetTicks() ;
+
+  return (!!(WakeMutex = SDL_CreateMutex()) && !!(WakeCond = SDL_CreateCond())) ;
+}
+
+void FrameScheduler::Cleanup()
+{
+  if (WakeCond)  { SDL_DestroyCond(WakeCond) ;   WakeCond  = 0 ; }
+  if (WakeMutex) { SDL_DestroyMutex(WakeMutex) ; WakeMutex = 0 ; }
+}
+
+
+// any thread
+
+void FrameScheduler::Wake()
+{
+  SDL_mutexP(WakeMutex) ;
+  IsWoken = true ; LastWakeTime = SDL_GetTicks() ; SDL_CondSignal(WakeCond) ;
+  SDL_mutexV(WakeMutex) ;
+}
+
+
+// render thread
+
+void FrameScheduler::WaitForNextFrame(bool isIdle)
+{
+  // a late frame is dropped rather than caught up
+  Uint32 now = SDL_GetTicks() ; Deadline += GetInterval(isIdle) ;
+  if ((Sint32)(Deadline - now) < 0) Deadline = now + GetInterval(isIdle) ;
+
+  SDL_mutexP(WakeMutex) ;
+  while ((Sint32)(Deadline - (now = SDL_GetTicks())) > 0)
+  {
+    // a woken frame is drawn now unless the previous one was too recent
+    if (IsWoken && now - FrameBegin >= MinInterval) { Deadline = now ; break ; }
+
+    Uint32 timeout = (IsWoken)? FrameBegin + MinInterval - now : Deadline - now ;
+    SDL_CondWaitTimeout(WakeCond , WakeMutex , timeout) ;
+  }
+  IsWoken = false ; FrameBegin = SDL_GetTicks() ;
+  SDL_mutexV(WakeMutex) ;
+}
+
+bool FrameScheduler::IsDue(Uint32* lastTime , Uint32 interval)
+{
+  if (FrameBegin - *lastTime < interval) return false ;
+
+  *lastTime = FrameBegin ; return true ;
+}
+
+Uint32 FrameScheduler::GetInterval(bool isIdle)
+{
+  Uint32 interval = TargetInterval ;
+  if (isIdle && SDL_GetTicks() - LastWakeTime >= GUI_IDLE_TIMEOUT) interval = IdleInterval ;
+
+  float dspLoad = JackIO::GetDspLoad() ;
+  if      (dspLoad >= DSP_LOAD_CRITICAL) interval *= 4 ;
+  else if (dspLoad >= DSP_LOAD_HIGH)     interval *= 2 ;
+
+  return interval ;
+}
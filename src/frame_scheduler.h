@@ -0,0 +1,102 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+#ifndef _FRAME_SCHEDULER_H_
+#define _FRAME_SCHEDULER_H_
+
+
+#include "loopidity.h"
+
+
+// frame rates
+#define GUI_DEFAULT_FPS     8    // 1000 / GUI_UPDATE_INTERVAL
+#define GUI_MIN_FPS         1
+#define GUI_MAX_FPS         120  // also limits the rate of woken frames
+#define GUI_IDLE_FPS        4
+#define GUI_IDLE_TIMEOUT    5000 // nMsecs without input (while not rolling) before GUI_IDLE_FPS
+#define GUI_STATUS_INTERVAL 1000 // nMsecs between duration status updates
+
+// DSP load thresholds (jack_cpu_load() percent)
+#define DSP_LOAD_HIGH     60.0 // halve the frame rate
+#define DSP_LOAD_CRITICAL 80.0 // quarter the frame rate
+
+
+using namespace std ;
+
+
+class FrameScheduler
+{
+  friend class LoopImager ;
+  friend class Loopidity ;
+
+
+  private:
+
+    /* FrameScheduler class side private varables */
+
+    // pacing
+    static Uint32 TargetInterval ;
+    static Uint32 IdleInterval ;
+    static Uint32 MinInterval ;
+    static Uint32 Deadline ;
+    static Uint32 FrameBegin ;
+    static Uint32 LastWakeTime ;
+
+    // wakeups
+    static SDL_mutex* WakeMutex ;
+    static SDL_cond*  WakeCond ;
+    static bool       IsWoken ;
+
+
+    /* FrameScheduler class side private functions */
+
+    // setup
+    static bool Init(   Uint32 targetFps) ;
+    static void Cleanup(void) ;
+
+    // any thread
+    static void Wake(void) ;
+
+    // render thread
+    static void   WaitForNextFrame(bool isIdle) ;
+    static bool   IsDue(           Uint32* lastTime , Uint32 interval) ;
+    static Uint32 GetInterval(     bool isIdle) ;
+} ;
+
+
+#endif // #ifndef _FRAME_SCHEDULER_H_
+
+
+/* NOTE: on frame pacing
+
+    the render thread sleeps in WaitForNextFrame() until the next deadline
+      or until Wake() is called by the main thread after it has handled an event
+      (key presses , new loops , scene changes) so that those are drawn immediately
+    woken frames are still at least MinInterval apart
+
+    the interval between deadlines is the FPS_ARG target unless
+      idle     --> not rolling and no input for GUI_IDLE_TIMEOUT - GUI_IDLE_FPS at most
+      DSP load --> above DSP_LOAD_HIGH the interval is doubled , above DSP_LOAD_CRITICAL quadrupled
+    a frame that overruns its deadline is not caught up - the next deadline is
+      one full interval after it
+
+    the transient scopes advance one column per GUI_UPDATE_INTERVAL regardless of
+      the frame rate so that their time scale does not change with the load
+*/
@@ -0,0 +1,99 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+
+#include "glyph_atlas.h"
+
+
+/* GlyphAtlas instance side public functions */
+
+GlyphAtlas::GlyphAtlas() : atlas(0) { memset(glyphs , 0 , sizeof(glyphs)) ; }
+
+
+// setup
+
+bool GlyphAtlas::init(TTF_Font* font , SDL_Color fgColor , SDL_PixelFormat* fmt)
+{
+  cleanup() ;
+
+  // measure
+  Uint16 atlasW = 0 , atlasH = TTF_FontHeight(font) ; int ascent = TTF_FontAscent(font) ;
+  SDL_Surface* glyphImgs[GLYPH_ATLAS_N] ;
+  for (Uint16 glyphN = 0 ; glyphN < GLYPH_ATLAS_N ; ++glyphN)
+  {
+    Uint16 ch = GLYPH_ATLAS_FIRST + glyphN ; int minX , maxX , minY , maxY , advance ;
+    glyphImgs[glyphN] = TTF_RenderGlyph_Solid(font , ch , fgColor) ;
+    if (TTF_GlyphMetrics(font , ch , &minX , &maxX , &minY , &maxY , &advance))
+      { minX = advance = 0 ; maxY = ascent ; }
+
+    Uint16 glyphW          = (glyphImgs[glyphN])? glyphImgs[glyphN]->w : 0 ;
+    glyphs[glyphN].rect    = { (Sint16)atlasW , 0 , glyphW , atlasH } ;
+    glyphs[glyphN].minX    = minX ;
+    glyphs[glyphN].topY    = (ascent > maxY)? ascent - maxY : 0 ;
+    glyphs[glyphN].advance = advance ;
+    atlasW                += glyphW ;
+  }
+
+  // pack - any colour other than fgColor is transparent as the glyphs are solid
+  Uint32 keyColor = 0 ;
+  if ((atlas = SDL_CreateRGBSurface(SDL_SWSURFACE , atlasW , atlasH , fmt->BitsPerPixel ,
+                                    fmt->Rmask , fmt->Gmask , fmt->Bmask , 0)))
+  {
+    keyColor = SDL_MapRGB(atlas->format , ~fgColor.r , ~fgColor.g , ~fgColor.b) ;
+    SDL_FillRect(atlas , 0 , keyColor) ;
+  }
+  for (Uint16 glyphN = 0 ; glyphN < GLYPH_ATLAS_N ; ++glyphN)
+  {
+    if (!glyphImgs[glyphN]) continue ;
+
+    // the rendered glyph is its tight bitmap - drop it from the ascent onto the baseline
+    SDL_Rect destRect = glyphs[glyphN].rect ; destRect.y = glyphs[glyphN].topY ;
+    if (atlas) SDL_BlitSurface(glyphImgs[glyphN] , 0 , atlas , &destRect) ;
+    SDL_FreeSurface(glyphImgs[glyphN]) ;
+  }
+  if (!atlas) return false ;
+
+  SDL_SetColorKey(atlas , SDL_SRCCOLORKEY | SDL_RLEACCEL , keyColor) ; return true ;
+}
+
+void GlyphAtlas::cleanup() { if (atlas) { SDL_FreeSurface(atlas) ; atlas = 0 ; } }
+
+
+// drawing
+
+Uint16 GlyphAtlas::drawText(const char* text , SDL_Surface* surface , Sint16 x , Sint16 y , Uint16 maxW)
+{
+  if (!atlas) return 0 ;
+
+  Uint16 penX = 0 ;
+  for (const char* ch = text ; *ch ; ++ch)
+  {
+    Uint8  c      = (Uint8)*ch ;
+    Uint16 glyphN = ((c >= GLYPH_ATLAS_FIRST && c <= GLYPH_ATLAS_LAST)? c : GLYPH_ATLAS_MISSING) -
+                    GLYPH_ATLAS_FIRST ;
+    Glyph* glyph  = &glyphs[glyphN] ; if (penX + glyph->advance > maxW) break ;
+
+    SDL_Rect srcRect  = glyph->rect ;
+    SDL_Rect destRect = { (Sint16)(x + penX + glyph->minX) , y , 0 , 0 } ;
+    SDL_BlitSurface(atlas , &srcRect , surface , &destRect) ; penX += glyph->advance ;
+  }
+
+  return penX ;
+}
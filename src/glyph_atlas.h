@@ -0,0 +1,87 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+
+#ifndef _GLYPH_ATLAS_H_
+#define _GLYPH_ATLAS_H_
+
+
+#include "loopidity.h"
+
+
+#define GLYPH_ATLAS_FIRST   32  // ' '
+#define GLYPH_ATLAS_LAST    126 // '~'
+#define GLYPH_ATLAS_N       (GLYPH_ATLAS_LAST - GLYPH_ATLAS_FIRST + 1)
+#define GLYPH_ATLAS_MISSING '?' // stands in for characters outside of the atlas
+
+
+using namespace std ;
+
+
+typedef struct Glyph
+{
+  SDL_Rect rect ;    // in the atlas surface
+  Sint16   minX ;    // TTF_GlyphMetrics()
+  Sint16   advance ; // TTF_GlyphMetrics()
+  Sint16   topY ;    // in the atlas row - TTF_FontAscent() - maxY
+} Glyph ;
+
+
+class GlyphAtlas
+{
+  public:
+
+    /* GlyphAtlas instance side public functions */
+
+    GlyphAtlas() ;
+
+    // setup
+    bool init(   TTF_Font* font , SDL_Color fgColor , SDL_PixelFormat* fmt) ;
+    void cleanup(void) ;
+
+    // drawing
+    Uint16 drawText(const char* text , SDL_Surface* surface , Sint16 x , Sint16 y , Uint16 maxW) ;
+
+
+  private:
+
+    /* GlyphAtlas instance side private varables */
+
+    SDL_Surface* atlas ;
+    Glyph        glyphs[GLYPH_ATLAS_N] ;
+} ;
+
+
+#endif // #ifndef _GLYPH_ATLAS_H_
+
+
+/* NOTE: on the glyph atlas
+
+    every printable ASCII glyph of a font is rendered once by init() into a single
+      colour-keyed RLE surface in the display format
+    drawText() then costs one blit per character with no TTF rendering and no allocation
+
+    TTF_RenderGlyph_Solid() returns only the glyph's tight bitmap so init() packs each
+      glyph TTF_FontAscent() - maxY down its TTF_FontHeight() tall cell - every glyph
+      then shares the font's baseline as TTF_RenderText_Solid() would draw it
+    glyphs are placed by their TTF_GlyphMetrics() advance so kerning is not applied
+      this is fine for the short status strings it is used for - the header is still
+      rendered by TTF_RenderText_Solid() as it is drawn only once
+*/
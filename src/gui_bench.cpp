@@ -0,0 +1,185 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+
+#include <algorithm>
+#include <ctime>
+
+#include "gui_bench.h"
+
+
+/* GuiBench class side private varables */
+
+// model and views
+Scene*         GuiBench::Scenes[NUM_SCENES]    = { 0 } ; // Init()
+SceneSdl*      GuiBench::SdlScenes[NUM_SCENES] = { 0 } ; // Init()
+ScopeHistory   GuiBench::PeaksIn ;
+ScopeHistory   GuiBench::PeaksOut ;
+vector<Sample> GuiBench::TransientPeaks ;
+
+
+/* GuiBench class side public functions */
+
+int GuiBench::Main(int argc , char** argv)
+{
+  Uint32 nIterations = GUI_BENCH_N_ITERATIONS ;
+  for (int argN = 1 ; argN < argc ; ++argN)
+    if (!strcmp(argv[argN] , GUI_BENCH_ITERATIONS_ARG) && argN + 1 < argc)
+      nIterations = atoi(argv[++argN]) ;
+  if (!nIterations) nIterations = GUI_BENCH_N_ITERATIONS ;
+
+  if (!Init()) { printf(GUI_BENCH_INIT_FAIL_MSG) ; Cleanup() ; return EXIT_FAILURE ; }
+
+  printf(GUI_BENCH_HEADER_FMT , "nLoops" , "widget" , "p50 (us)" , "p99 (us)" , "max (us)") ;
+  ViewState view = { 0 , 0 , true } ;
+  vector<double> times[GUI_BENCH_N_WIDGETS] ;
+  for (Uint32 nLoops = 1 ; nLoops <= NUM_LOOPS ; ++nLoops)
+  {
+    // loop images
+    times[3].clear() ;
+    for (Uint32 sceneN = 0 ; sceneN < NUM_SCENES ; ++sceneN)
+      { double begin = Now() ; AddLoop(sceneN) ; times[3].push_back(Now() - begin) ; }
+
+    for (Uint32 widgetN = 0 ; widgetN < 3 ; ++widgetN) times[widgetN].clear() ;
+    for (Uint32 frameN = 0 ; frameN < nIterations ; ++frameN)
+    {
+      // advance the scenes so that the rings rotate and the scopes scroll
+      for (Uint32 sceneN = 0 ; sceneN < NUM_SCENES ; ++sceneN)
+      {
+        Scene* scene         = Scenes[sceneN] ;
+        scene->currentFrameN = scene->beginFrameN +
+                               ((frameN * scene->nFramesPerPeak) % scene->nFrames) ;
+        SdlScenes[sceneN]->isDirty = true ;
+      }
+      Sample peak = (Sample)(frameN % 100) / 100.0 ; PeaksIn.push(peak) ; PeaksOut.push(1.0 - peak) ;
+
+      double begin = Now() ; LoopiditySdl::DrawScenes(&view) ;
+      double mid   = Now() ; LoopiditySdl::DrawTransientScopes() ;
+      double end   = Now() ; LoopiditySdl::DrawEditScopes(&view) ;
+      times[0].push_back(mid - begin) ; times[1].push_back(end - mid) ;
+      times[2].push_back(Now() - end) ; LoopiditySdl::FlipScreen() ;
+    }
+
+    Report(nLoops , "DrawScenes"          , &times[0]) ;
+    Report(nLoops , "DrawTransientScopes" , &times[1]) ;
+    Report(nLoops , "DrawEditScopes"      , &times[2]) ;
+    Report(nLoops , "loop images"         , &times[3]) ;
+  }
+
+  Cleanup() ; return EXIT_SUCCESS ;
+}
+
+
+/* GuiBench class side private functions */
+
+// setup
+
+bool GuiBench::Init()
+{
+  // the same metadata that JackIO would provide for a GUI_BENCH_LOOP_SECONDS scene
+  SceneMetadata metadata ;
+  metadata.sampleRate         = GUI_BENCH_SAMPLE_RATE ;
+  metadata.nFramesPerPeriod   = GUI_BENCH_PERIOD_SIZE ;
+  metadata.bytesPerFrame      = sizeof(Sample) ;
+  metadata.minLoopSize        = GUI_BENCH_SAMPLE_RATE ;
+  metadata.triggerLatencySize = 0 ;
+  metadata.beginFrameN        = GUI_BENCH_SAMPLE_RATE ;
+  metadata.endFrameN          = GUI_BENCH_SAMPLE_RATE * (GUI_BENCH_LOOP_SECONDS + 1) ;
+  Scene::SetMetadata(&metadata) ;
+
+  for (Uint32 sceneN = 0 ; sceneN < NUM_SCENES ; ++sceneN)
+  {
+    try { Scenes[sceneN] = new Scene(sceneN) ; } catch(exception& ex) { return false ; }
+
+    Scene* scene          = Scenes[sceneN] ;
+    scene->nFrames        = metadata.endFrameN - metadata.beginFrameN ;
+    scene->nFramesPerPeak = scene->nFrames / N_PEAKS_FINE ;
+    scene->nSeconds       = GUI_BENCH_LOOP_SECONDS ;
+    scene->doesPulseExist = true ;
+    SdlScenes[sceneN]     = new SceneSdl(scene) ;
+  }
+
+  TransientPeaks.assign(N_PEAKS_TRANSIENT , 0.0) ;
+  return LoopiditySdl::Init(SdlScenes , &PeaksIn , &PeaksOut , &TransientPeaks , true) ;
+}
+
+void GuiBench::Cleanup()
+{
+  for (Uint32 sceneN = 0 ; sceneN < NUM_SCENES ; ++sceneN)
+    if (SdlScenes[sceneN]) SdlScenes[sceneN]->cleanup() ;
+  LoopiditySdl::Cleanup() ;
+}
+
+
+// synthetic data
+
+void GuiBench::AddLoop(Uint32 sceneN)
+{
+  Scene*    scene    = Scenes[sceneN] ;
+  SceneSdl* sdlScene = SdlScenes[sceneN] ;
+  Uint32    loopN    = scene->loops.size() ;
+  Loop*     loop     = new Loop(0 , 0) ; // no audio buffers
+
+  // a decaying pulse per beat - distinct per loop so that each image differs
+  for (Uint32 peakN = 0 ; peakN < N_PEAKS_FINE ; ++peakN)
+  {
+    Uint32 beatPeakN       = (peakN * (loopN + 1)) % (N_PEAKS_FINE / 8) ;
+    Sample peak            = 1.0 - ((Sample)beatPeakN / (Sample)(N_PEAKS_FINE / 8)) ;
+    loop->peaksFine[peakN] = peak ;
+    if (scene->hiScenePeaks[peakN] < peak) scene->hiScenePeaks[peakN] = peak ;
+    if (scene->hiLoopPeaks[loopN]  < peak) scene->hiLoopPeaks[loopN]  = peak ;
+  }
+  for (Uint32 peakN = 0 ; peakN < N_PEAKS_COURSE ; ++peakN)
+    loop->peaksCourse[peakN] = loop->peaksFine[(peakN * N_PEAKS_FINE) / N_PEAKS_COURSE] ;
+  scene->loops.push_back(loop) ;
+
+  // the same images that SceneSdl::addLoop() and LoopImager would produce
+  SDL_Surface* playingImg = 0 ; SDL_Surface* mutedImg = 0 ;
+  sdlScene->drawHistogram(loop->peaksCourse , &playingImg , &mutedImg) ;
+  sdlScene->histogramImgs.push_back(new LoopSdl(playingImg , mutedImg ,
+                                                SceneSdl::GetLoopL(loopN) , SceneSdl::LoopsT)) ;
+  sdlScene->loopImgs.push_back(sdlScene->drawLoop(loop , loopN)) ;
+  sdlScene->isDirty = true ;
+}
+
+
+// measurement
+
+double GuiBench::Now()
+{
+  timespec now ; clock_gettime(CLOCK_MONOTONIC , &now) ;
+
+  return (now.tv_sec * 1000000.0) + (now.tv_nsec / 1000.0) ;
+}
+
+void GuiBench::Report(Uint32 nLoops , const char* widgetName , vector<double>* times)
+{
+  if (times->empty()) return ;
+
+  sort(times->begin() , times->end()) ;
+  Uint32 nTimes = times->size() ;
+  printf(GUI_BENCH_ROW_FMT , nLoops , widgetName , (*times)[nTimes / 2] ,
+         (*times)[(nTimes * 99) / 100] , (*times)[nTimes - 1]) ;
+}
+
+
+/* entry point */
+
+int main(int argc , char** argv) { return GuiBench::Main(argc , argv) ; }
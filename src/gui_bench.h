@@ -0,0 +1,99 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+
+#ifndef _GUI_BENCH_H_
+#define _GUI_BENCH_H_
+
+
+#include "loopidity.h"
+
+
+#define GUI_BENCH_ITERATIONS_ARG "--iterations"
+#define GUI_BENCH_N_ITERATIONS   200
+#define GUI_BENCH_SAMPLE_RATE    48000
+#define GUI_BENCH_PERIOD_SIZE    128
+#define GUI_BENCH_LOOP_SECONDS   10
+#define GUI_BENCH_N_WIDGETS      4
+#define GUI_BENCH_HEADER_FMT     "\n%-7s %-20s %10s %10s %10s\n"
+#define GUI_BENCH_ROW_FMT        "%-7d %-20s %10.1f %10.1f %10.1f\n"
+#define GUI_BENCH_INIT_FAIL_MSG  "ERROR: GuiBench: could not initialize offscreen scenes\n"
+
+
+using namespace std ;
+
+
+class GuiBench
+{
+  public:
+
+    /* GuiBench class side public functions */
+
+    static int Main(int argc , char** argv) ;
+
+
+  private:
+
+    /* GuiBench class side private varables */
+
+    // model and views
+    static Scene*       Scenes[NUM_SCENES] ;
+    static SceneSdl*    SdlScenes[NUM_SCENES] ;
+    static ScopeHistory PeaksIn ;
+    static ScopeHistory PeaksOut ;
+    static vector<Sample> TransientPeaks ;
+
+
+    /* GuiBench class side private functions */
+
+    // setup
+    static bool Init(   void) ;
+    static void Cleanup(void) ;
+
+    // synthetic data
+    static void AddLoop(Uint32 sceneN) ;
+
+    // measurement
+    static double Now(   void) ;
+    static void   Report(Uint32 nLoops , const char* widgetName , vector<double>* times) ;
+} ;
+
+
+#endif // #ifndef _GUI_BENCH_H_
+
+
+/* NOTE: on the GUI benchmark
+
+    loopidity-guibench (make guibench) draws into an offscreen Screen via the SDL dummy
+      video driver so it runs on build machines without a display or JACK
+    it must be run from a directory containing the assets (e.g. bin/Release)
+
+    for 1 through NUM_LOOPS loops in every scene it times each widget for
+      GUI_BENCH_N_ITERATIONS (or GUI_BENCH_ITERATIONS_ARG) frames and prints
+      p50 , p99 , and max in microseconds
+    widgets -->
+        DrawScenes()          every scene is marked dirty so this is the worst case
+        DrawTransientScopes() fed from synthetic ScopeHistory peaks
+        DrawEditScopes()      with a fixed base loop so the edit overlay is cached
+        loop images           drawHistogram() + drawLoop() for one loop - synchronous here
+
+    loops are synthetic - they have no audio buffers and their peak caches are filled
+      directly so that the numbers do not depend on JackIO
+*/
@@ -0,0 +1,196 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+
+#include "jack_backend.h"
+
+
+/* JackBackend instance side public functions */
+
+JackBackend::JackBackend() : client(0)
+{
+  for (Uint32 stemN = 0 ; stemN < NUM_LOOPS * MAX_N_CHANNELS ; ++stemN)
+    isStemConnected[stemN] = false ;
+}
+
+JackBackend::~JackBackend() { close() ; }
+
+
+// setup
+
+Uint32 JackBackend::open(Uint32 nChannels , bool shouldOutputStems)
+{
+  // register JACK client
+  if (!(client = jack_client_open(APP_NAME , JackNoStartServer , NULL)))
+    return JACK_SW_FAIL ;
+
+  // assign server callbacks
+  jack_set_process_callback(    client , ProcessCallback    , this) ;
+  jack_set_sample_rate_callback(client , SampleRateCallback , this) ;
+  jack_set_buffer_size_callback(client , BufferSizeCallback , this) ;
+  jack_on_shutdown(             client , ShutdownCallback   , this) ;
+  jack_set_thread_init_callback(client , ThreadInitCallback , this) ;
+  jack_set_xrun_callback(       client , XrunCallback       , this) ;
+  if (shouldOutputStems)
+    jack_set_port_connect_callback(client , PortConnectCallback , this) ;
+
+  // register I/O ports
+  if (!registerPorts(nChannels , shouldOutputStems)) return JACK_HW_FAIL ;
+
+  // propogate server state
+  JackIO::FormatCallback(jack_get_sample_rate(client) , jack_get_buffer_size(client)) ;
+
+  return JACK_INIT_SUCCESS ;
+}
+
+bool JackBackend::activate() { return client && !jack_activate(client) ; }
+
+void JackBackend::close()
+{
+  if (client) { jack_client_close(client) ; client = 0 ; }
+  inputPorts.clear() ; outputPorts.clear() ; stemPorts.clear() ;
+}
+
+
+// getters
+
+Uint32 JackBackend::getSampleRate() { return (client)? jack_get_sample_rate(client) : 0 ; }
+
+Uint32 JackBackend::getBufferSize() { return (client)? jack_get_buffer_size(client) : 0 ; }
+
+float JackBackend::getDspLoad() { return (client)? jack_cpu_load(client) : 0.0 ; }
+
+
+// process thread
+
+void JackBackend::getBuffers(Uint32 nFrames , Sample** inBuffers , Sample** outBuffers)
+{
+  for (Uint32 channelN = 0 ; channelN < inputPorts.size() ; ++channelN)
+  {
+    inBuffers [channelN] = (Sample*)jack_port_get_buffer(inputPorts [channelN] , nFrames) ;
+    outBuffers[channelN] = (Sample*)jack_port_get_buffer(outputPorts[channelN] , nFrames) ;
+  }
+}
+
+Sample* JackBackend::getStemBuffer(Uint32 stemN , Uint32 nFrames)
+{
+  // unconnected ports are never touched
+  if (stemN >= stemPorts.size() || !isStemConnected[stemN].load(memory_order_relaxed)) return 0 ;
+
+  return (Sample*)jack_port_get_buffer(stemPorts[stemN] , nFrames) ;
+}
+
+
+/* JackBackend class side public functions */
+
+// helpers
+
+void JackBackend::MakePortNames(Uint32 nChannels , Uint32 channelN , char* inName , char* outName)
+{
+  // stereo keeps the traditional L/R names - otherwise ports are numbered from 1
+  if (nChannels == 2)
+  {
+    snprintf(inName  , 32 , "%s" , (channelN)? JACK_INPUT2_PORT_NAME  : JACK_INPUT1_PORT_NAME) ;
+    snprintf(outName , 32 , "%s" , (channelN)? JACK_OUTPUT2_PORT_NAME : JACK_OUTPUT1_PORT_NAME) ;
+  }
+  else
+  {
+    snprintf(inName  , 32 , JACK_INPUT_PORT_FMT  , channelN + 1) ;
+    snprintf(outName , 32 , JACK_OUTPUT_PORT_FMT , channelN + 1) ;
+  }
+}
+
+
+/* JackBackend instance side private functions */
+
+// helpers
+
+bool JackBackend::registerPorts(Uint32 nChannels , bool shouldOutputStems)
+{
+  char inName[32] , outName[32] ;
+  for (Uint32 channelN = 0 ; channelN < nChannels ; ++channelN)
+  {
+    MakePortNames(nChannels , channelN , inName , outName) ;
+
+    jack_port_t* inputPort  = registerPort(inName  , JackPortIsInput) ;
+    jack_port_t* outputPort = registerPort(outName , JackPortIsOutput) ;
+    if (!inputPort || !outputPort) return false ;
+
+    inputPorts.push_back(inputPort) ; outputPorts.push_back(outputPort) ;
+  }
+
+  // optional per loop slot direct outputs (see note on stems in jack_io.h)
+  if (!shouldOutputStems) return true ;
+
+  char stemName[32] ;
+  for (Uint32 slotN = 0 ; slotN < NUM_LOOPS ; ++slotN)
+    for (Uint32 channelN = 0 ; channelN < nChannels ; ++channelN)
+    {
+      if (nChannels == 2)
+        snprintf(stemName , 32 , (channelN)? JACK_STEM_R_PORT_FMT : JACK_STEM_L_PORT_FMT ,
+                 slotN + 1                                                             ) ;
+      else snprintf(stemName , 32 , JACK_STEM_PORT_FMT , slotN + 1 , channelN + 1) ;
+
+      jack_port_t* stemPort = registerPort(stemName , JackPortIsOutput) ;
+      if (!stemPort) return false ;
+
+      stemPorts.push_back(stemPort) ; isStemConnected[stemPorts.size() - 1] = false ;
+    }
+
+  return true ;
+}
+
+jack_port_t* JackBackend::registerPort(const char* portName , unsigned long portFlags)
+  { return jack_port_register(client , portName , JACK_DEFAULT_AUDIO_TYPE , portFlags , 0) ; }
+
+
+/* JackBackend class side private functions */
+
+// JACK server callbacks
+
+int JackBackend::ProcessCallback(jack_nframes_t nFramesPerPeriod , void* backend)
+  { return JackIO::ProcessCallback(nFramesPerPeriod) ; }
+
+int JackBackend::SampleRateCallback(jack_nframes_t sampleRate , void* backend)
+{
+  JackBackend* jackBackend = (JackBackend*)backend ;
+  JackIO::FormatCallback(sampleRate , jack_get_buffer_size(jackBackend->client)) ; return 0 ;
+}
+
+int JackBackend::BufferSizeCallback(jack_nframes_t nFramesPerPeriod , void* backend)
+{
+  JackBackend* jackBackend = (JackBackend*)backend ;
+  JackIO::FormatCallback(jack_get_sample_rate(jackBackend->client) , nFramesPerPeriod) ; return 0 ;
+}
+
+void JackBackend::ShutdownCallback(void* backend) { JackIO::ShutdownCallback() ; }
+
+void JackBackend::ThreadInitCallback(void* backend) { JackIO::ThreadInitCallback() ; }
+
+int JackBackend::XrunCallback(void* backend) { JackIO::XrunCallback() ; return 0 ; }
+
+void JackBackend::PortConnectCallback(jack_port_id_t portA , jack_port_id_t portB ,
+                                      int isConnected      , void* backend        )
+{
+  // called on a non-RT thread - refresh all stem flags rather than matching port ids
+  JackBackend* jackBackend = (JackBackend*)backend ;
+  for (Uint32 portN = 0 ; portN < jackBackend->stemPorts.size() ; ++portN)
+    jackBackend->isStemConnected[portN] = jack_port_connected(jackBackend->stemPorts[portN]) > 0 ;
+}
@@ -0,0 +1,99 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+
+#ifndef _JACK_BACKEND_H_
+#define _JACK_BACKEND_H_
+
+
+#include <atomic>
+
+#include "loopidity.h"
+
+
+using namespace std ;
+
+
+class JackBackend : public AudioBackend
+{
+  public:
+
+    /* JackBackend instance side public functions */
+
+    JackBackend() ;
+    ~JackBackend() ;
+
+    // setup
+    Uint32 open(    Uint32 nChannels , bool shouldOutputStems) ;
+    bool   activate(void) ;
+    void   close(   void) ;
+
+    // getters
+    Uint32 getSampleRate(void) ;
+    Uint32 getBufferSize(void) ;
+    float  getDspLoad(   void) ;
+
+    // process thread
+    void    getBuffers(   Uint32 nFrames , Sample** inBuffers , Sample** outBuffers) ;
+    Sample* getStemBuffer(Uint32 stemN   , Uint32 nFrames) ;
+
+
+    /* JackBackend class side public functions */
+
+    // helpers
+    static void MakePortNames(Uint32 nChannels , Uint32 channelN , char* inName , char* outName) ;
+
+
+  private:
+
+    /* JackBackend instance side private varables */
+
+    // JACK handles
+    jack_client_t*       client ;
+    vector<jack_port_t*> inputPorts ;
+    vector<jack_port_t*> outputPorts ;
+    vector<jack_port_t*> stemPorts ;   // [(slotN * nChannels) + channelN]
+
+    // misc flags
+    atomic<bool> isStemConnected[NUM_LOOPS * MAX_N_CHANNELS] ; // per stemPorts
+
+
+    /* JackBackend instance side private functions */
+
+    // helpers
+    bool         registerPorts(Uint32 nChannels , bool shouldOutputStems) ;
+    jack_port_t* registerPort( const char* portName , unsigned long portFlags) ;
+
+
+    /* JackBackend class side private functions */
+
+    // JACK server callbacks
+    static int  ProcessCallback(    jack_nframes_t nFramesPerPeriod , void* backend) ;
+    static int  SampleRateCallback( jack_nframes_t sampleRate ,       void* backend) ;
+    static int  BufferSizeCallback( jack_nframes_t nFramesPerPeriod , void* backend) ;
+    static void ShutdownCallback(                                     void* backend) ;
+    static void ThreadInitCallback(                                   void* backend) ;
+    static int  XrunCallback(                                         void* backend) ;
+    static void PortConnectCallback(jack_port_id_t portA , jack_port_id_t portB ,
+                                    int isConnected      , void* backend        ) ;
+} ;
+
+
+#endif // #ifndef _JACK_BACKEND_H_
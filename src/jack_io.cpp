@@ -23,9 +23,6 @@
 
 /* JackIO class side private constants */
 
-const Uint32 JackIO::N_PORTS              = N_AUDIO_PORTS ;
-const Uint32 JackIO::N_INPUT_PORTS        = N_INPUT_CHANNELS ;
-const Uint32 JackIO::N_OUTPUT_PORTS       = N_OUTPUT_CHANNELS ;
 const Uint32 JackIO::N_TRANSIENT_PEAKS    = N_PEAKS_TRANSIENT ;
 const Uint32 JackIO::DEFAULT_BUFFER_SIZE  = DEFAULT_AUDIO_BUFFER_SIZE ;
 const Uint32 JackIO::N_BYTES_PER_FRAME    = sizeof(Sample) ;
@@ -34,15 +31,8 @@ const Uint32 JackIO::GUI_UPDATE_IVL       = GUI_UPDATE_INTERVAL ;
 
 /* JackIO class side private varables */
 
-// JACK handles
-jack_client_t* JackIO::Client      = 0 ; // Init()
-#if FIXED_N_AUDIO_PORTS
-jack_port_t*   JackIO::InputPort1  = 0 ; // Init()
-jack_port_t*   JackIO::InputPort2  = 0 ; // Init()
-jack_port_t*   JackIO::OutputPort1 = 0 ; // Init()
-jack_port_t*   JackIO::OutputPort2 = 0 ; // Init()
-#else // TODO: much
-#endif // #if FIXED_N_AUDIO_PORTS
+// audio backend
+AudioBackend* JackIO::Backend = 0 ; // Init()
 
 // app state
 Scene*       JackIO::CurrentScene  = 0 ; // Reset()
@@ -51,25 +41,26 @@ Scene*       JackIO::NextScene     = 0 ; // Reset()
 //Uint32 JackIO::NextSceneN    = 0 ;
 
 // audio data
-Uint32       JackIO::RecordBufferSize = 0 ; // Init()
-#if FIXED_N_AUDIO_PORTS
-Sample*      JackIO::RecordBuffer1    = 0 ; // Init()
-Sample*      JackIO::RecordBuffer2    = 0 ; // Init()
-#  if SCENE_NFRAMES_EDITABLE
+Uint32          JackIO::NChannels        = 0 ; // Init()
+Uint32          JackIO::RecordBufferSize = 0 ; // Init()
+vector<Sample*> JackIO::RecordBuffers ;        // Init()
+vector<Sample*> JackIO::InBuffers ;            // Init() , ProcessCallback()
+vector<Sample*> JackIO::OutBuffers ;           // Init() , ProcessCallback()
+atomic<Loop*>   JackIO::SpareLoop(0) ;         // PrepareSpareLoop() , TakeSpareLoop()
+atomic<Loop*>   JackIO::ReturnedLoop(0) ;      // PrepareSpareLoop() , TakeSpareLoop()
+#if SCENE_NFRAMES_EDITABLE
 /*
 Sample* JackIO::LeadInBuffer1  = 0 ; // SetMetadata()
 Sample* JackIO::LeadInBuffer2  = 0 ; // SetMetadata()
 Sample* JackIO::LeadOutBuffer1 = 0 ; // SetMetadata()
 Sample* JackIO::LeadOutBuffer2 = 0 ; // SetMetadata()
 */
-#  endif // #if SCENE_NFRAMES_EDITABLE
-#else // TODO: much
-#endif // #if FIXED_N_AUDIO_PORTS
+#endif // #if SCENE_NFRAMES_EDITABLE
 
 // peaks data
-vector<Sample> JackIO::PeaksIn ;                         // Reset()
-vector<Sample> JackIO::PeaksOut ;                        // Reset()
-Sample         JackIO::TransientPeaks[N_PORTS] = {0.0} ;
+ScopeHistory   JackIO::PeaksIn ;                         // Reset()
+ScopeHistory   JackIO::PeaksOut ;                        // Reset()
+vector<Sample> JackIO::TransientPeaks ;                  // Init()
 Sample         JackIO::TransientPeakInMix      = 0 ;
 //Sample         JackIO::TransientPeakOutMix     = 0 ;
 
@@ -79,6 +70,9 @@ Uint32       JackIO::NewLoopEventSceneN     = 0 ; // Init()
 Loop*        JackIO::NewLoopEventLoop       = 0 ; // Init()
 SDL_Event    JackIO::SceneChangeEvent ;           // Init()
 Uint32       JackIO::SceneChangeEventSceneN = 0 ; // Init()
+SDL_Event    JackIO::SceneResetEvent ;            // Init()
+Uint32       JackIO::SceneResetEventSceneN  = 0 ; // Init()
+SDL_Event    JackIO::OutOfMemoryEvent ;           // Init()
 
 // metadata
 jack_nframes_t JackIO::SampleRate           = 0 ; // SetMetadata()
@@ -103,36 +97,99 @@ Uint32         JackIO::EndFrameN            = 0 ; // SetMetadata()
 Uint32         JackIO::BytesPerPeriod       = 0 ; // SetMetadata()
 #endif // #if SCENE_NFRAMES_EDITABLE
 Uint32         JackIO::FramesPerGuiInterval = 0 ; // SetMetadata()
+Uint32         JackIO::RecordOffsetSize     = 0 ; // SetRecordOffset()
+
+// DSP kernels
+JackIO::MixKernel  JackIO::MixKernels[N_MIX_KERNELS][2][NUM_LOOPS + 1] ; // InitMixKernels()
+Uint32             JackIO::MixKernelN = 0 ;                              // Init()
+JackIO::SpanKernel JackIO::SpanKernels[NUM_LOOPS + 1] ;                  // InitMixKernels()
+Sample*            JackIO::ActiveBuffers[NUM_LOOPS][MAX_N_CHANNELS] ;    // Mix()
+float              JackIO::ActiveVols[NUM_LOOPS] ;                       // Mix()
 
 // misc flags
 bool JackIO::ShouldMonitorInputs = true ;
+bool JackIO::ShouldOutputStems   = false ; // Init()
 
 
 /* JackIO class side public functions */
 
 // setup
 #if INIT_JACK_BEFORE_SCENES
-Uint32 JackIO::Init(bool shouldMonitorInputs , Uint32 recordBufferSize)
+Uint32 JackIO::Init(AudioBackend* backend          , bool   shouldMonitorInputs ,
+                    Uint32        recordBufferSize , Uint32 nChannels           ,
+                    bool          shouldOutputStems                             )
 #else
-Uint32 JackIO::Init(Scene* currentScene     , bool shouldMonitorInputs ,
-                    Uint32 recordBufferSize                            )
+Uint32 JackIO::Init(AudioBackend* backend             , Scene* currentScene      ,
+                    bool          shouldMonitorInputs , Uint32 recordBufferSize ,
+                    Uint32        nChannels           , bool   shouldOutputStems)
 #endif // #if INIT_JACK_BEFORE_SCENES
 {
 DEBUG_TRACE_JACK_INIT
 
   // set initial state
+  RtGuard::Init() ;
+#if !INIT_JACK_BEFORE_SCENES
+  Reset(currentScene) ;
+#endif // #if !INIT_JACK_BEFORE_SCENES
+
+  // take ownership of the backend - it is deleted in Cleanup() even if Init() fails
+  Backend = backend ; ShouldOutputStems = shouldOutputStems ;
+  if (!Backend) return JACK_MEM_FAIL ;
+
+  // initialize the engine
+  Uint32 status = InitEngine(shouldMonitorInputs , recordBufferSize , nChannels) ;
+  if (status != JACK_INIT_SUCCESS) return status ;
+
 #if INIT_JACK_BEFORE_SCENES
+#define DUMMY_SCENEN -1
+  // instantiate dummy Scene
+//  CurrentScene = Scene::DummyScene ;
+#endif // #if !INIT_JACK_BEFORE_SCENES
+
+  // open the backend - it propogates the server state via FormatCallback()
+  status = Backend->open(NChannels , ShouldOutputStems) ;
+  if (status != JACK_INIT_SUCCESS) return status ;
+
+  // begin processing audio - once only , Reset() never restarts the clock
+  if (!Backend->activate()) return JACK_HW_FAIL ;
+
+  return JACK_INIT_SUCCESS ;
+}
+
+Uint32 JackIO::InitEngine(bool shouldMonitorInputs , Uint32 recordBufferSize , Uint32 nChannels)
+{
   ShouldMonitorInputs = shouldMonitorInputs ;
-#else
-  Reset(currentScene) ; ShouldMonitorInputs = shouldMonitorInputs ;
-#endif // #if INIT_JACK_BEFORE_SCENES
 
-  // initialize record buffers
+  // initialize record buffers (one per channel)
+  NChannels         = nChannels ;
   recordBufferSize /= N_BYTES_PER_FRAME ;
   RecordBufferSize  = !!(recordBufferSize) ? recordBufferSize : DEFAULT_BUFFER_SIZE ;
-  if (!(RecordBuffer1 = new (nothrow) Sample[RecordBufferSize]()) ||
-      !(RecordBuffer2 = new (nothrow) Sample[RecordBufferSize]())  )
-    return JACK_MEM_FAIL ;
+  for (Uint32 channelN = 0 ; channelN < NChannels ; ++channelN)
+  {
+    Sample* recordBuffer = new (nothrow) Sample[RecordBufferSize]() ;
+    if (!recordBuffer) return JACK_MEM_FAIL ;
+
+    // fault it in so that the first periods do not page
+    RtGuard::Prefault(recordBuffer , RecordBufferSize * N_BYTES_PER_FRAME) ;
+    RecordBuffers.push_back(recordBuffer) ;
+  }
+  PerfStats::SetRecordBytes((size_t)RecordBufferSize * NChannels * N_BYTES_PER_FRAME) ;
+
+  // size per channel port buffer handles and VU peaks - these are never resized later
+  InBuffers.assign(     NChannels     , (Sample*)0) ;
+  OutBuffers.assign(    NChannels     , (Sample*)0) ;
+  TransientPeaks.assign(NChannels * 2 , 0.0) ;
+
+  // select the row of mix kernels specialized for this channel count
+  InitMixKernels() ;
+  switch (NChannels)
+  {
+    case 1:  MixKernelN = 0 ; break ;
+    case 2:  MixKernelN = 1 ; break ;
+    case 4:  MixKernelN = 2 ; break ;
+    case 8:  MixKernelN = 3 ; break ;
+    default: MixKernelN = 4 ; break ;
+  }
 
   // initialize SDL event structs
   NewLoopEvent.type           = SDL_USEREVENT ;
@@ -143,40 +200,14 @@ DEBUG_TRACE_JACK_INIT
   SceneChangeEvent.user.code  = EVT_SCENE_CHANGED ;
   SceneChangeEvent.user.data1 = &SceneChangeEventSceneN ;
   SceneChangeEvent.user.data2 = 0 ; // unused
-
-  // register JACK client
-  if (!(Client = jack_client_open(APP_NAME , JackNoStartServer , NULL)))
-    return JACK_SW_FAIL ;
-
-#if INIT_JACK_BEFORE_SCENES
-#define DUMMY_SCENEN -1
-  // instantiate dummy Scene
-//  CurrentScene = Scene::DummyScene ;
-#endif // #if !INIT_JACK_BEFORE_SCENES
-
-  // assign server callbacks
-  jack_set_process_callback(    Client , ProcessCallback    , 0) ;
-  jack_set_sample_rate_callback(Client , SampleRateCallback , 0) ;
-  jack_set_buffer_size_callback(Client , BufferSizeCallback , 0) ;
-  jack_on_shutdown(             Client , ShutdownCallback   , 0) ;
-
-  // register I/O ports
-#if INIT_JACK_BEFORE_SCENES
-  if (!(InputPort1  = RegisterPort(JACK_INPUT1_PORT_NAME  , JackPortIsInput))  ||
-      !(InputPort2  = RegisterPort(JACK_INPUT2_PORT_NAME  , JackPortIsInput))  ||
-      !(OutputPort1 = RegisterPort(JACK_OUTPUT1_PORT_NAME , JackPortIsOutput)) ||
-      !(OutputPort2 = RegisterPort(JACK_OUTPUT2_PORT_NAME , JackPortIsOutput)))
-    return JACK_HW_FAIL ;
-#else
-  if (!(InputPort1  = RegisterPort(JACK_INPUT1_PORT_NAME  , JackPortIsInput))  ||
-      !(InputPort2  = RegisterPort(JACK_INPUT2_PORT_NAME  , JackPortIsInput))  ||
-      !(OutputPort1 = RegisterPort(JACK_OUTPUT1_PORT_NAME , JackPortIsOutput)) ||
-      !(OutputPort2 = RegisterPort(JACK_OUTPUT2_PORT_NAME , JackPortIsOutput)) ||
-      jack_activate(Client)) return JACK_HW_FAIL ;
-#endif // #if INIT_JACK_BEFORE_SCENES
-
-  // propogate server state
-  SetMetadata(jack_get_sample_rate(Client) , jack_get_buffer_size(Client)) ;
+  SceneResetEvent.type        = SDL_USEREVENT ;
+  SceneResetEvent.user.code   = EVT_SCENE_RESET ;
+  SceneResetEvent.user.data1  = &SceneResetEventSceneN ;
+  SceneResetEvent.user.data2  = 0 ; // unused
+  OutOfMemoryEvent.type       = SDL_USEREVENT ;
+  OutOfMemoryEvent.user.code  = EVT_OUT_OF_MEMORY ;
+  OutOfMemoryEvent.user.data1 = 0 ; // unused
+  OutOfMemoryEvent.user.data2 = 0 ; // unused
 
   return JACK_INIT_SUCCESS ;
 }
@@ -193,18 +224,64 @@ DEBUG_TRACE_JACK_RESET
   BytesPerPeriod = 0 ;
 
   // initialize scope/VU peaks cache
-  for (Uint32 peakN = 0 ; peakN < N_TRANSIENT_PEAKS ; ++peakN)
-    { PeaksIn.push_back(0.0) ; PeaksOut.push_back(0.0) ; }
+  PeaksIn.reset() ; PeaksOut.reset() ;
 
 #if INIT_JACK_BEFORE_SCENES
   // destroy dummy Scene
 //  if (DummyScene) { delete DummyScene ; DummyScene = 0 ; }
 
-  // begin processing audio
-  jack_activate(Client) ;
+  // the first commit takes a prefaulted loop (see note on the spare loop in jack_io.h)
+  PrepareSpareLoop(currentScene) ;
 #endif // #if INIT_JACK_BEFORE_SCENES
 }
 
+void JackIO::Cleanup()
+{
+  // stop the backend clock before the record buffers go away
+  if (Backend) { Backend->close() ; delete Backend ; Backend = 0 ; }
+
+  for (Uint32 channelN = 0 ; channelN < RecordBuffers.size() ; ++channelN)
+    delete [] RecordBuffers[channelN] ;
+  RecordBuffers.clear() ;
+
+  Loop* loop ;
+  if ((loop = SpareLoop.exchange(0)))    delete loop ;
+  if ((loop = ReturnedLoop.exchange(0))) delete loop ;
+}
+
+bool JackIO::BeginCalibration()
+{
+#if SCENE_NFRAMES_EDITABLE
+  // the record offset is a read-ahead into the loop buffers so it may not exceed the margin
+  return Calibration::Begin(BufferMarginSize) ;
+#else
+  return false ;
+#endif // #if SCENE_NFRAMES_EDITABLE
+}
+
+void JackIO::PrepareSpareLoop(Scene* currentScene)
+{
+  if (!currentScene || !NChannels) return ;
+
+  // size for the longest loop until the base loop fixes the scene length
+#if SCENE_NFRAMES_EDITABLE
+  Uint32 nFrames = (currentScene->doesPulseExist)?
+                   currentScene->nFrames + BufferMarginsSize : RecordBufferSize ;
+#else
+  Uint32 nFrames = (currentScene->doesPulseExist)? currentScene->nFrames : RecordBufferSize ;
+#endif // #if SCENE_NFRAMES_EDITABLE
+  Loop* loop = SpareLoop.load() ; if (loop && loop->nFrames == nFrames) return ;
+
+  // free a spare handed back by the JACK thread before offering another
+  if ((loop = ReturnedLoop.exchange(0))) delete loop ;
+
+  try { loop = new Loop(nFrames , NChannels) ; } catch(exception& ex) { return ; }
+
+  for (Uint32 channelN = 0 ; channelN < NChannels ; ++channelN)
+    RtGuard::Prefault(loop->buffers[channelN] , nFrames * N_BYTES_PER_FRAME) ;
+  if ((loop = SpareLoop.exchange(loop))) delete loop ;
+}
+
 
 // getters/setters
 #if !INIT_JACK_BEFORE_SCENES
@@ -221,13 +298,24 @@ Uint32 JackIO::GetNBytesPerSecond() { return NBytesPerSecond ; }
 */
 void JackIO::SetCurrentScene(Scene* currentScene) { CurrentScene = currentScene ; }
 
+float JackIO::GetDspLoad() { return (Backend)? Backend->getDspLoad() : 0.0 ; }
+
+Uint32 JackIO::GetNChannels() { return NChannels ; }
+
 void JackIO::SetNextScene(Scene* nextScene) { NextScene = nextScene ; }
 
-vector<Sample>* JackIO::GetPeaksIn() { return &PeaksIn ; }
+void JackIO::SetRecordOffset(Uint32 nFrames)
+{
+#if SCENE_NFRAMES_EDITABLE
+  RecordOffsetSize = (nFrames < BufferMarginSize)? nFrames : BufferMarginSize ;
+#endif // #if SCENE_NFRAMES_EDITABLE
+}
+
+ScopeHistory* JackIO::GetPeaksIn() { return &PeaksIn ; }
 
-vector<Sample>* JackIO::GetPeaksOut() { return &PeaksOut ; }
+ScopeHistory* JackIO::GetPeaksOut() { return &PeaksOut ; }
 
-Sample* JackIO::GetTransientPeaks() { return TransientPeaks ; }
+vector<Sample>* JackIO::GetTransientPeaks() { return &TransientPeaks ; }
 
 Sample* JackIO::GetTransientPeakIn() { return &TransientPeakInMix ; }
 
@@ -247,68 +335,40 @@ void JackIO::ScanTransientPeaks()
 //  Uint32 currentFrameN = CurrentScene->currentFrameN ;
 //  currentFrameN        = (currentFrameN < FramesPerGuiInterval)? 0 : currentFrameN - FramesPerGuiInterval ;
 //  Uint32 offsetFrameN  = currentFrameN + BufferMarginSize ;//+ TriggerLatencySize ;
+#  else // SCENE_NFRAMES_EDITABLE
+  Uint32 currentFrameN = CurrentScene->currentFrameN ;
+  currentFrameN        = (currentFrameN < FramesPerGuiInterval) ? 0 : currentFrameN - FramesPerGuiInterval ;
+  Uint32 offsetFrameN  = currentFrameN ;
+#  endif // #if SCENE_NFRAMES_EDITABLE
   Uint32 nFrames       = FramesPerGuiInterval ;
-
-  // initialize with inputs
-  Sample peakIn1 = GetPeak(&(RecordBuffer1[offsetFrameN]) , nFrames) ;
-  Sample peakIn2 = GetPeak(&(RecordBuffer2[offsetFrameN]) , nFrames) ;
-
-  // add in unmuted tracks
-  Sample peakOut1 = 0.0 ; Sample peakOut2 = 0.0 ;
-  Uint32 nLoops   = CurrentScene->loops.size() ;
-  for (Uint32 loopN = 0 ; loopN < nLoops ; ++loopN)
+  Uint32 nLoops        = CurrentScene->loops.size() ;
+  Sample peakIn        = 0.0 , peakOut = 0.0 ;
+  for (Uint32 channelN = 0 ; channelN < NChannels ; ++channelN)
   {
-    Loop* loop = CurrentScene->getLoop(loopN) ;
-    if (CurrentScene->isMuted && loop->isMuted) continue ;
-
-    peakOut1 += GetPeak(&(loop->buffer1[currentFrameN]) , nFrames) * loop->vol ;
-    peakOut2 += GetPeak(&(loop->buffer2[currentFrameN]) , nFrames) * loop->vol ;
-  }
-#  else // SCENE_NFRAMES_EDITABLE
-  Uint32 frameN = CurrentScene->currentFrameN ;
-  frameN        = (frameN < FramesPerGuiInterval) ? 0 : frameN - FramesPerGuiInterval ;
+    // initialize with inputs
+    Sample peakInN  = GetPeak(&(RecordBuffers[channelN][offsetFrameN]) , nFrames) ;
 
-  // initialize with inputs
-  Sample peakIn1 = GetPeak(&(RecordBuffer1[frameN]) , FramesPerGuiInterval) ;
-  Sample peakIn2 = GetPeak(&(RecordBuffer2[frameN]) , FramesPerGuiInterval) ;
+    // add in unmuted tracks
+    Sample peakOutN = 0.0 ;
+    for (Uint32 loopN = 0 ; loopN < nLoops ; ++loopN)
+    {
+      Loop* loop = CurrentScene->getLoop(loopN) ;
+      if (CurrentScene->isMuted && loop->isMuted) continue ;
 
-  // add in unmuted tracks
-  Sample peakOut1 = 0.0 ; Sample peakOut2 = 0.0 ;
-  Uint32 nLoops   = CurrentScene->loops.size() ;
-  for (Uint32 loopN = 0 ; loopN < nLoops ; ++loopN)
-  {
-    Loop* loop = CurrentScene->getLoop(loopN) ;
-    if (CurrentScene->isMuted && loop->isMuted) continue ;
+      peakOutN += GetPeak(&(loop->buffers[channelN][currentFrameN]) , nFrames) * loop->vol ;
+    }
 
-    peakOut1 += GetPeak(&(loop->buffer1[frameN]) , FramesPerGuiInterval) * loop->vol ;
-    peakOut2 += GetPeak(&(loop->buffer2[frameN]) , FramesPerGuiInterval) * loop->vol ;
+    // load VU peaks (per channel - inputs then outputs)
+    TransientPeaks[channelN]             = peakInN ;
+    TransientPeaks[NChannels + channelN] = peakOutN ;
+    peakIn += peakInN ; peakOut += peakOutN ;
   }
-#  endif // #if SCENE_NFRAMES_EDITABLE
 
-#  if FIXED_N_AUDIO_PORTS
-  Sample peakIn  = (peakIn1 + peakIn2)   / N_INPUT_PORTS ;
-  Sample peakOut = (peakOut1 + peakOut2) / N_OUTPUT_PORTS ;
-  if (peakOut > 1.0) peakOut = 1.0 ;
-#  else
-  Sample peakIn  = (peakIn1 + peakIn2)   / N_INPUT_PORTS ;
-  Sample peakOut = (peakOut1 + peakOut2) / N_OUTPUT_PORTS ;
-  if (peakOut > 1.0) peakOut = 1.0 ;
-#  endif // #if FIXED_N_AUDIO_PORTS
+  peakIn /= NChannels ; peakOut /= NChannels ; if (peakOut > 1.0) peakOut = 1.0 ;
 
   // load scope peaks (mono mix)
-  PeaksIn.pop_back()  ; PeaksIn.insert(PeaksIn.begin()   , peakIn) ;
-  PeaksOut.pop_back() ; PeaksOut.insert(PeaksOut.begin() , peakOut) ;
-
-  // load VU peaks (per channel)
-#  if FIXED_N_AUDIO_PORTS
-  TransientPeakInMix = peakIn ;   //TransientPeakOutMix = peakOut ;
-  TransientPeaks[0]  = peakIn1 ;  TransientPeaks[1]   = peakIn2 ;
-  TransientPeaks[2]  = peakOut1 ; TransientPeaks[3]   = peakOut2 ;
-#  else // TODO: magic #s ~= N_PORTS (see #def)
-  TransientPeakInMix = peakIn ;   //TransientPeakOutMix = peakOut ;
-  TransientPeaks[0]  = peakIn1 ;  TransientPeaks[1]   = peakIn2 ;
-  TransientPeaks[2]  = peakOut1 ; TransientPeaks[3]   = peakOut2 ;
-#  endif // #if FIXED_N_AUDIO_PORTS
+  PeaksIn.push(peakIn) ; PeaksOut.push(peakOut) ;
+  TransientPeakInMix = peakIn ; //TransientPeakOutMix = peakOut ;
 #endif // #if SCAN_TRANSIENT_PEAKS_DATA
 }
 
@@ -329,55 +389,100 @@ Sample JackIO::GetPeak(Sample* buffer , Uint32 nFrames)
 }
 
 
+// offline driver
+
+Uint32 JackIO::InitOffline(bool shouldMonitorInputs , Uint32 recordBufferSize , Uint32 nChannels)
+  { return InitEngine(shouldMonitorInputs , recordBufferSize , nChannels) ; }
+
+void JackIO::SetOfflinePeriod(Uint32 sampleRate , Uint32 nFramesPerPeriod)
+  { FormatCallback(sampleRate , nFramesPerPeriod) ; }
+
+void JackIO::ProcessOffline(Sample** inBuffers , Sample** outBuffers , Uint32 nFrames)
+{
+  // the caller owns the period buffers - they stand in for the JACK port buffers
+  for (Uint32 channelN = 0 ; channelN < NChannels ; ++channelN)
+    { InBuffers[channelN] = inBuffers[channelN] ; OutBuffers[channelN] = outBuffers[channelN] ; }
+
+  ProcessPeriod(nFrames) ;
+}
+
+
 /* JackIO class side private functions */
 
-// JACK server callbacks
+// backend callbacks
+
+int JackIO::ProcessCallback(Uint32 nFramesPerPeriod)
+{
+RT_GUARD_PROCESS_SCOPE
+
+#if JACK_IO_READ_WRITE
+  // get backend buffers
+  Backend->getBuffers(nFramesPerPeriod , &InBuffers[0] , &OutBuffers[0]) ;
+
+  // the clock runs from Init() but there is nothing to mix until Reset() sets the scene
+  if (!CurrentScene)
+  {
+    for (Uint32 channelN = 0 ; channelN < NChannels ; ++channelN)
+      memset(OutBuffers[channelN] , 0 , nFramesPerPeriod * N_BYTES_PER_FRAME) ;
+    SilenceStems(nFramesPerPeriod) ; return 0 ;
+  }
+#endif // #if JACK_IO_READ_WRITE
 
-int JackIO::ProcessCallback(jack_nframes_t nFramesPerPeriod , void* unused)
+  return ProcessPeriod(nFramesPerPeriod) ;
+}
+
+void JackIO::FormatCallback(Uint32 sampleRate , Uint32 nFramesPerPeriod)
 #if SCENE_NFRAMES_EDITABLE
+  { SetMetadata(sampleRate , nFramesPerPeriod) ; }
+#else
 {
+  SampleRate           = sampleRate ;
+  BytesPerPeriod       = N_BYTES_PER_FRAME * nFramesPerPeriod ;
+//  NBytesPerSecond       = N_BYTES_PER_FRAME * SampleRate ;
+  FramesPerGuiInterval = (Uint32)(SampleRate * (float)GUI_UPDATE_IVL * 0.001) ;
+#  if INIT_JACK_BEFORE_SCENES
+  Loopidity::SetMetadata(SampleRate , nFramesPerPeriod , RecordBufferSize) ;
+#  else
+  Loopidity::SetMetadata(SampleRate , nFramesPerPeriod) ;
+#  endif // #if INIT_JACK_BEFORE_SCENES
+}
+#endif // #if SCENE_NFRAMES_EDITABLE
+
+void JackIO::ShutdownCallback()
+{
+  // close the backend and free resouces
+  Cleanup() ; exit(1) ;
+}
+
+void JackIO::ThreadInitCallback() { RtGuard::InitRtThread() ; TraceRing::NameThread("jack") ; }
+
+void JackIO::XrunCallback() { PerfStats::AddXrun() ; }
+
+
+// JACK thread
+
+int JackIO::ProcessPeriod(Uint32 nFramesPerPeriod)
+#if SCENE_NFRAMES_EDITABLE
+{
+PERF_STATS_PROCESS_SCOPE
+TRACE_SPAN(TRACE_SPAN_PROCESS)
 DEBUG_TRACE_JACK_PROCESS_CALLBACK_IN
 
 //if (!CurrentScene->loops.size()) return 0 ; // KLUDGE: win init
 
 #  if JACK_IO_READ_WRITE
-  // get JACK buffers
-  Sample* in1  = (Sample*)jack_port_get_buffer(InputPort1  , nFramesPerPeriod) ;
-  Sample* out1 = (Sample*)jack_port_get_buffer(OutputPort1 , nFramesPerPeriod) ;
-  Sample* in2  = (Sample*)jack_port_get_buffer(InputPort2  , nFramesPerPeriod) ;
-  Sample* out2 = (Sample*)jack_port_get_buffer(OutputPort2 , nFramesPerPeriod) ;
-
-  // index into the record buffers and mix out
-  list<Loop*>::iterator loopIter , loopsBeginIter , loopsEndIter ; Loop* aLoop ; float vol ;
-  loopsBeginIter      = CurrentScene->loops.begin() ;
-  loopsEndIter        = CurrentScene->loops.end() ;
-  Uint32 sceneFrameN  = CurrentScene->currentFrameN , frameN ;
-  Uint32 offsetFrameN = CurrentScene->currentFrameN ;//+ BufferMarginSize ;
-  Uint32 mixFrameN    = offsetFrameN ;
-  for (frameN = 0 ; frameN < nFramesPerPeriod ; ++frameN && ++mixFrameN && ++sceneFrameN)
+  // emit test signal and capture loopback while calibrating - the scene is held
+  if (Calibration::IsCapturing)
   {
-    // write input to outputs mix buffers
-    if (!ShouldMonitorInputs) RecordBuffer1[mixFrameN] = RecordBuffer2[mixFrameN] = 0 ;
-    else { RecordBuffer1[mixFrameN] = in1[frameN] ; RecordBuffer2[mixFrameN] = in2[frameN] ; }
-
-    // mix unmuted tracks into outputs mix buffers
-    for (loopIter = loopsBeginIter ; loopIter != loopsEndIter ; ++loopIter)
-    {
-      if (CurrentScene->isMuted && (*loopIter)->isMuted) continue ;
-
-      aLoop = *loopIter ; vol = aLoop->vol ;
-      RecordBuffer1[mixFrameN] += aLoop->buffer1[sceneFrameN] * vol ;
-      RecordBuffer2[mixFrameN] += aLoop->buffer2[sceneFrameN] * vol ;
-    }
+    for (Uint32 channelN = 1 ; channelN < NChannels ; ++channelN)
+      memset(OutBuffers[channelN] , 0 , BytesPerPeriod) ;
+    SilenceStems(nFramesPerPeriod) ;
+    Calibration::ProcessPeriod(InBuffers[0] , OutBuffers[0] , nFramesPerPeriod) ; return 0 ;
   }
 
-  // write output mix buffers to outputs and write input to record buffers
-  Sample* mixBegin1 = RecordBuffer1 + offsetFrameN ;
-  Sample* mixBegin2 = RecordBuffer2 + offsetFrameN ;
-  memcpy(out1      , mixBegin1 , BytesPerPeriod) ;
-  memcpy(out2      , mixBegin2 , BytesPerPeriod) ;
-  memcpy(mixBegin1 , in1       , BytesPerPeriod) ;
-  memcpy(mixBegin2 , in2       , BytesPerPeriod) ;
+  // mix out and write input to the record buffers
+  Uint32 recordFrameN = CurrentScene->currentFrameN ;//+ BufferMarginSize ;
+  Mix(nFramesPerPeriod , recordFrameN , CurrentScene->currentFrameN) ;
 #  endif // #if JACK_IO_READ_WRITE
 
   // increment ring buffer index
@@ -385,6 +490,9 @@ DEBUG_TRACE_JACK_PROCESS_CALLBACK_IN
     CurrentScene->currentFrameN = BeginFrameN ;
   else return 0 ;
 
+PERF_STATS_ROLLOVER_SCOPE
+TRACE_SPAN(TRACE_SPAN_ROLLOVER)
+
   Uint32 beginFrameN = CurrentScene->beginFrameN ;
   Uint32 endFrameN   = CurrentScene->endFrameN ;
   Uint32 nLoops      = CurrentScene->loops.size() ;
@@ -409,16 +517,16 @@ DEBUG_TRACE_JACK_PROCESS_CALLBACK_ROLLOVER
 #    endif // #if INIT_JACK_BEFORE_SCENES
 #  else // ALLOW_BUFFER_ROLLOVER
 #    if INIT_JACK_BEFORE_SCENES
-  // bail if currentFrameN rolls over implicitly (issue #11)
+  // bail if currentFrameN rolls over implicitly (issue #11) - the main thread resets the scene
   if (isBaseLoop && endFrameN == EndFrameN)
-    { Loopidity::ResetCurrentScene() ; return 0 ; }
+    { SceneResetEventSceneN = CurrentScene->sceneN ; SDL_PushEvent(&SceneResetEvent) ; return 0 ; }
   // bail if loop too short (issue #12)
   if (isBaseLoop && nFrames < MinLoopSize)
     { CurrentScene->endFrameN = EndFrameN ; return 0 ; }
 #    else // INIT_JACK_BEFORE_SCENES
-  // bail if currentFrameN rolls over implicitly (issue #11)
+  // bail if currentFrameN rolls over implicitly (issue #11) - the main thread resets the scene
   if (isBaseLoop && endFrameN == RecordBufferSize)
-    { Loopidity::ResetCurrentScene() ; return 0 ; }
+    { SceneResetEventSceneN = CurrentScene->sceneN ; SDL_PushEvent(&SceneResetEvent) ; return 0 ; }
   // bail if loop too short (issue #12)
   if (isBaseLoop && nFrames < MinLoopSize)
     { CurrentScene->endFrameN = RecordBufferSize ; return 0 ; }
@@ -433,20 +541,21 @@ DEBUG_TRACE_JACK_PROCESS_CALLBACK_ROLLOVER
   // create new Loop instance
   if (CurrentScene->shouldSaveLoop && nLoops < Loopidity::N_LOOPS)
   {
+TRACE_SPAN(TRACE_SPAN_LOOP_COMMIT)
+
 // TODO: adjustable loop seams (issue #14)
 
-    // copy audio samples - (see note on RecordBuffer layout in jack_io.h)
-    if ((NewLoopEventLoop = new (nothrow) Loop(nFrames + BufferMarginsSize)))
+    // take the prefaulted spare (see note on the spare loop in jack_io.h)
+    Uint32 nLoopFrames = nFrames + BufferMarginsSize ;
+    if ((NewLoopEventLoop = TakeSpareLoop(nLoopFrames))                 ||
+        (NewLoopEventLoop = new (nothrow) Loop(nLoopFrames , NChannels))  )
     {
 DEBUG_TRACE_JACK_PROCESS_CALLBACK_NEW_LOOP
 
+      // copy audio samples - (see note on RecordBuffer layout in jack_io.h)
 #  if JACK_IO_COPY
       size_t  thisLeadInFrameN = beginFrameN       - BufferMarginSize ;
       size_t  nextLeadInFrameN = thisLeadInFrameN  + nFrames ;
-      Sample* thisLeadInBegin1 = RecordBuffer1     + thisLeadInFrameN ;
-      Sample* thisLeadInBegin2 = RecordBuffer2     + thisLeadInFrameN ;
-      Sample* nextLeadInBegin1 = RecordBuffer1     + nextLeadInFrameN ;
-      Sample* nextLeadInBegin2 = RecordBuffer2     + nextLeadInFrameN ;
 //       Sample* loopBegin1       = RecordBuffer1 +  beginFrameN ;//+ BufferMarginSize ;
 //       Sample* loopBegin2       = RecordBuffer2 +  beginFrameN ;//+ BufferMarginSize ;
 //       Sample* leadOutBegin1    = RecordBuffer1 + endFrameN   + BufferMarginSize ;
@@ -460,8 +569,11 @@ DEBUG_TRACE_JACK_PROCESS_CALLBACK_NEW_LOOP
 //         memcpy(NewLoop->buffer2 , loopBegin2 , nLoopBytes) ;
 //       memcpy(NewLoop->buffer1 , leadInBegin1 , nLoopBytes + BufferMarginBytes) ;
 //       memcpy(NewLoop->buffer2 , leadInBegin1 , nLoopBytes + BufferMarginBytes) ;
-      memcpy(NewLoopEventLoop->buffer1 , thisLeadInBegin1 , nThisLoopBytes) ;
-      memcpy(NewLoopEventLoop->buffer2 , thisLeadInBegin2 , nThisLoopBytes) ;
+      for (Uint32 channelN = 0 ; channelN < NChannels ; ++channelN)
+      {
+        Sample* thisLeadInBegin = RecordBuffers[channelN] + thisLeadInFrameN ;
+        memcpy(NewLoopEventLoop->buffers[channelN] , thisLeadInBegin , nThisLoopBytes) ;
+      }
 #  endif // #if JACK_IO_COPY
 
       if (isBaseLoop)
@@ -474,8 +586,11 @@ DEBUG_TRACE_JACK_PROCESS_CALLBACK_NEW_LOOP
 #  if JACK_IO_COPY
         // 'shift' last BufferMarginSize + TriggerLatencySize back for next loop leadIn
         nNextLeadInBytes += TriggerLatencyBytes ;
-        memcpy(RecordBuffer1 , nextLeadInBegin1 , nNextLeadInBytes) ;
-        memcpy(RecordBuffer2 , nextLeadInBegin2 , nNextLeadInBytes) ;
+        for (Uint32 channelN = 0 ; channelN < NChannels ; ++channelN)
+        {
+          Sample* nextLeadInBegin = RecordBuffers[channelN] + nextLeadInFrameN ;
+          memcpy(RecordBuffers[channelN] , nextLeadInBegin , nNextLeadInBytes) ;
+        }
 #  endif // #if JACK_IO_COPY
 
         // align buffer indicies to base loop
@@ -486,7 +601,7 @@ DEBUG_TRACE_JACK_PROCESS_CALLBACK_NEW_LOOP
 
       NewLoopEventSceneN = CurrentScene->sceneN ; SDL_PushEvent(&NewLoopEvent) ;
     }
-    else Loopidity::OOM() ;
+    else SDL_PushEvent(&OutOfMemoryEvent) ;
   }
 /*
 #if JACK_IO_COPY
@@ -500,51 +615,27 @@ DEBUG_TRACE_JACK_PROCESS_CALLBACK_NEW_LOOP
   if (CurrentScene != NextScene)
   {
     CurrentScene = NextScene ; SceneChangeEventSceneN = NextScene->sceneN ;
-    SDL_PushEvent(&SceneChangeEvent) ;
+    SDL_PushEvent(&SceneChangeEvent) ; TraceRing::Write(TRACE_EVT_NEXT_SCENE , NextScene->sceneN , 0) ;
   }
 
   return 0 ;
 }
 #else // SCENE_NFRAMES_EDITABLE
 {
-  // get JACK buffers
-Sample* in1  = (Sample*)jack_port_get_buffer(InputPort1  , nFrames) ;
-Sample* out1 = (Sample*)jack_port_get_buffer(OutputPort1 , nFrames) ;
-Sample* in2  = (Sample*)jack_port_get_buffer(InputPort2  , nFrames) ;
-Sample* out2 = (Sample*)jack_port_get_buffer(OutputPort2 , nFrames) ;
-
-  // index into the record buffers and mix out
-Uint32 currFrameN = CurrentScene->frameN , frameN , frameIdx ;
-list<Loop*>::iterator loopsBeginIter = CurrentScene->loops.begin() ;
-list<Loop*>::iterator loopsEndIter   = CurrentScene->loops.end() ;
-list<Loop*>::iterator loopIter ; Loop* aLoop ; float vol ;
-  for (frameN = 0 ; frameN < nFrames ; ++frameN)
-  {
-    frameIdx = currFrameN + frameN ;
+PERF_STATS_PROCESS_SCOPE
+TRACE_SPAN(TRACE_SPAN_PROCESS)
 
-    // write input to outputs mix buffers
-    if (!ShouldMonitorInputs) RecordBuffer1[frameIdx] = RecordBuffer2[frameIdx] = 0 ;
-    else { RecordBuffer1[frameIdx] = in1[frameN] ; RecordBuffer2[frameIdx] = in2[frameN] ; }
+  Uint32 nFrames = nFramesPerPeriod ;
 
-    // mix unmuted tracks into outputs mix buffers
-    for (loopIter = loopsBeginIter ; loopIter != loopsEndIter ; ++loopIter)
-    {
-      if (CurrentScene->isMuted && (*loopIter)->isMuted) continue ;
-
-      aLoop = *loopIter ; vol = aLoop->vol ;
-      RecordBuffer1[frameIdx] += aLoop->buffer1[frameIdx] * vol ;
-      RecordBuffer2[frameIdx] += aLoop->buffer2[frameIdx] * vol ;
-    }
-  }
-
-  // write output mix buffers to outputs and write input to record buffers
-  Sample* buf1 = RecordBuffer1 + currFrameN ; Sample* buf2 = RecordBuffer2 + currFrameN ;
-  memcpy(out1 , buf1 , BytesPerPeriod) ; memcpy(out2 , buf2 , BytesPerPeriod) ;
-  memcpy(buf1 , in1  , BytesPerPeriod) ; memcpy(buf2 , in2  , BytesPerPeriod) ;
+  // mix out and write input to the record buffers
+  Mix(nFrames , CurrentScene->frameN , CurrentScene->frameN) ;
 
   // increment sample rollover
   if (!(CurrentScene->frameN = (CurrentScene->frameN + nFrames) % CurrentScene->nFrames))
   {
+PERF_STATS_ROLLOVER_SCOPE
+TRACE_SPAN(TRACE_SPAN_ROLLOVER)
+
 #  if AUTO_UNMUTE_LOOPS_ON_ROLLOVER
     // unmute 'paused' loops
     CurrentScene->isMuted = false ;
@@ -553,20 +644,25 @@ list<Loop*>::iterator loopIter ; Loop* aLoop ; float vol ;
     // create new Loop instance and copy record buffers to it
     if (CurrentScene->shouldSaveLoop && CurrentScene->loops.size() < Loopidity::N_LOOPS)
     {
-      if ((NewLoopEventLoop = new (nothrow) Loop(CurrentScene->nFrames)))
+TRACE_SPAN(TRACE_SPAN_LOOP_COMMIT)
+
+      // take the prefaulted spare (see note on the spare loop in jack_io.h)
+      Uint32 nLoopFrames = CurrentScene->nFrames ;
+      if ((NewLoopEventLoop = TakeSpareLoop(nLoopFrames))                 ||
+          (NewLoopEventLoop = new (nothrow) Loop(nLoopFrames , NChannels))  )
       {
-        memcpy(EventLoopCreationLoop->buffer1 , RecordBuffer1 , CurrentScene->nBytes) ;
-        memcpy(EventLoopCreationLoop->buffer2 , RecordBuffer2 , CurrentScene->nBytes) ;
+        for (Uint32 channelN = 0 ; channelN < NChannels ; ++channelN)
+          memcpy(NewLoopEventLoop->buffers[channelN] , RecordBuffers[channelN] , CurrentScene->nBytes) ;
         NewLoopEventSceneN = CurrentScene->sceneN ; SDL_PushEvent(&NewLoopEvent) ;
       }
-      else Loopidity::OOM() ;
+      else SDL_PushEvent(&OutOfMemoryEvent) ;
     }
 
     // switch to NextScene if necessary
     if (CurrentScene != NextScene)
     {
       CurrentScene = NextScene ; SceneChangeEventSceneN = NextScene->sceneN ;
-      SDL_PushEvent(&SceneChangeEvent) ;
+      SDL_PushEvent(&SceneChangeEvent) ; TraceRing::Write(TRACE_EVT_NEXT_SCENE , NextScene->sceneN , 0) ;
     }
   }
 
@@ -574,50 +670,194 @@ list<Loop*>::iterator loopIter ; Loop* aLoop ; float vol ;
 }
 #endif // #if SCENE_NFRAMES_EDITABLE
 
-#if SCENE_NFRAMES_EDITABLE
-int JackIO::SampleRateCallback(jack_nframes_t sampleRate , void* unused)
-  { SetMetadata(sampleRate , jack_get_buffer_size(Client)) ; return 0 ; }
-#endif // #if SCENE_NFRAMES_EDITABLE
+Loop* JackIO::TakeSpareLoop(Uint32 nFrames)
+{
+  Loop* loop = SpareLoop.exchange(0) ; if (!loop || loop->nFrames >= nFrames) return loop ;
+
+  // too short - the main thread frees it (see note on the spare loop in jack_io.h)
+  ReturnedLoop.store(loop) ; return 0 ;
+}
 
-int JackIO::BufferSizeCallback(jack_nframes_t nFramesPerPeriod , void* unused)
+// DSP
+
+template <Uint32 N_CHANNELS_T , bool IS_MONITORING_T , Uint32 N_LOOPS_T>
+struct JackIO::MixKernelRow
+{
+  static void Fill(MixKernel* kernels)
+  {
+    kernels[N_LOOPS_T] = MixPeriod<N_CHANNELS_T , IS_MONITORING_T , N_LOOPS_T> ;
+    MixKernelRow<N_CHANNELS_T , IS_MONITORING_T , N_LOOPS_T - 1>::Fill(kernels) ;
+  }
+} ;
+
+template <Uint32 N_CHANNELS_T , bool IS_MONITORING_T>
+struct JackIO::MixKernelRow<N_CHANNELS_T , IS_MONITORING_T , 0>
+{
+  static void Fill(MixKernel* kernels)
+    { kernels[0] = MixPeriod<N_CHANNELS_T , IS_MONITORING_T , 0> ; }
+} ;
+
+template <Uint32 N_LOOPS_T>
+struct JackIO::SpanKernelRow
+{
+  static void Fill(SpanKernel* kernels)
+  {
+    kernels[N_LOOPS_T] = MixSpan<false , N_LOOPS_T> ;
+    SpanKernelRow<N_LOOPS_T - 1>::Fill(kernels) ;
+  }
+} ;
+
+template <>
+struct JackIO::SpanKernelRow<0>
+{
+  static void Fill(SpanKernel* kernels) { kernels[0] = MixSpan<false , 0> ; }
+} ;
+
+void JackIO::InitMixKernels()
+{
+  MixKernelRow<1 , false , NUM_LOOPS>::Fill(MixKernels[0][0]) ;
+  MixKernelRow<1 , true  , NUM_LOOPS>::Fill(MixKernels[0][1]) ;
+  MixKernelRow<2 , false , NUM_LOOPS>::Fill(MixKernels[1][0]) ;
+  MixKernelRow<2 , true  , NUM_LOOPS>::Fill(MixKernels[1][1]) ;
+  MixKernelRow<4 , false , NUM_LOOPS>::Fill(MixKernels[2][0]) ;
+  MixKernelRow<4 , true  , NUM_LOOPS>::Fill(MixKernels[2][1]) ;
+  MixKernelRow<8 , false , NUM_LOOPS>::Fill(MixKernels[3][0]) ;
+  MixKernelRow<8 , true  , NUM_LOOPS>::Fill(MixKernels[3][1]) ;
+  MixKernelRow<0 , false , NUM_LOOPS>::Fill(MixKernels[4][0]) ;
+  MixKernelRow<0 , true  , NUM_LOOPS>::Fill(MixKernels[4][1]) ;
+  SpanKernelRow<NUM_LOOPS>::Fill(SpanKernels) ;
+}
+
+void JackIO::Mix(Uint32 nFrames , Uint32 recordFrameN , Uint32 sceneFrameN)
+{
+  // gather unmuted loops - muting is resolved here so that the kernels never branch on it
+  list<Loop*>::iterator loopIter = CurrentScene->loops.begin() ;
+  list<Loop*>::iterator loopsEnd = CurrentScene->loops.end() ;
+  Uint32 nLoops = 0 ; bool isSceneMuted = CurrentScene->isMuted ;
+  for ( ; loopIter != loopsEnd && nLoops < NUM_LOOPS ; ++loopIter)
+  {
+    Loop* aLoop = *loopIter ; if (isSceneMuted && aLoop->isMuted) continue ;
+
+    for (Uint32 channelN = 0 ; channelN < NChannels ; ++channelN)
+      ActiveBuffers[nLoops][channelN] = aLoop->buffers[channelN] ;
+    ActiveVols[nLoops++] = aLoop->vol ;
+  }
+
+  // play loops ahead by the round trip so that overdubs line up with what was heard
 #if SCENE_NFRAMES_EDITABLE
-  { SetMetadata(jack_get_sample_rate(Client) , nFramesPerPeriod) ; return 0 ; }
+  Uint32 loopEndN    = CurrentScene->endFrameN ;
+  Uint32 loopNFrames = CurrentScene->nFrames ;
+  Uint32 loopFrameN  = sceneFrameN + RecordOffsetSize ;
 #else
+  Uint32 loopEndN    = CurrentScene->nFrames ;
+  Uint32 loopNFrames = CurrentScene->nFrames ;
+  Uint32 loopFrameN  = sceneFrameN ;
+#endif // #if SCENE_NFRAMES_EDITABLE
+  if (loopFrameN >= loopEndN) loopFrameN -= loopNFrames ;
+
+  // the read position wraps at most once per period - split the period at the seam
+  Uint32 nFramesToSeam = loopEndN - loopFrameN ;
+  if (nFramesToSeam > nFrames) nFramesToSeam = nFrames ;
+
+  Uint32 seamFrameN = loopEndN - loopNFrames ;
+  MixKernels[MixKernelN][ShouldMonitorInputs][nLoops]
+      (nFrames , recordFrameN , loopFrameN , nFramesToSeam , seamFrameN) ;
+
+  // per loop direct outputs
+  if (ShouldOutputStems) WriteStems(nFrames , loopFrameN , nFramesToSeam , seamFrameN) ;
+}
+
+void JackIO::WriteStems(Uint32 nFrames    , Uint32 loopFrameN , Uint32 nFramesToSeam ,
+                        Uint32 seamFrameN                                             )
 {
-  BytesPerPeriod       = N_BYTES_PER_FRAME * nFramesPerPeriod ;
-//  NBytesPerSecond       = N_BYTES_PER_FRAME * (SampleRate = jack_get_sample_rate(Client)) ;
-  FramesPerGuiInterval = (Uint32)(SampleRate * (float)GUI_UPDATE_IVL * 0.001) ;
-#  if INIT_JACK_BEFORE_SCENES
-  Loopidity::SetMetadata(SampleRate , nFramesPerPeriod , RecordBufferSize) ;
-#  else
-  Loopidity::SetMetadata(SampleRate , nFramesPerPeriod) ;
-#  endif // #if INIT_JACK_BEFORE_SCENES
+  // stem slots follow the loop order of the current scene - empty or muted slots are silent
+  list<Loop*>::iterator loopIter = CurrentScene->loops.begin() ;
+  list<Loop*>::iterator loopsEnd = CurrentScene->loops.end() ;
+  bool isSceneMuted = CurrentScene->isMuted ;
+  for (Uint32 slotN = 0 ; slotN < NUM_LOOPS ; ++slotN)
+  {
+    Loop* aLoop    = (loopIter != loopsEnd)? *(loopIter++) : 0 ;
+    bool  isSilent = !aLoop || (isSceneMuted && aLoop->isMuted) ;
+    for (Uint32 channelN = 0 ; channelN < NChannels ; ++channelN)
+    {
+      // unconnected ports are never touched
+      Sample* out = Backend->getStemBuffer((slotN * NChannels) + channelN , nFrames) ;
+      if (!out) continue ;
+
+      // write the gained loop straight into the port buffer
+      if (isSilent) { memset(out , 0 , nFrames * N_BYTES_PER_FRAME) ; continue ; }
+
+      Sample* loopSpan = aLoop->buffers[channelN] + loopFrameN ; float vol = aLoop->vol ;
+      for (Uint32 frameN = 0 ; frameN < nFramesToSeam ; ++frameN)
+        out[frameN] = loopSpan[frameN] * vol ;
+      loopSpan = aLoop->buffers[channelN] + seamFrameN ; out += nFramesToSeam ;
+      for (Uint32 frameN = 0 ; frameN < nFrames - nFramesToSeam ; ++frameN)
+        out[frameN] = loopSpan[frameN] * vol ;
+    }
+  }
+}
 
-  return 0 ;
+void JackIO::SilenceStems(Uint32 nFrames)
+{
+  if (!ShouldOutputStems) return ;
+
+  for (Uint32 stemN = 0 ; stemN < NUM_LOOPS * NChannels ; ++stemN)
+  {
+    Sample* out = Backend->getStemBuffer(stemN , nFrames) ;
+    if (out) memset(out , 0 , nFrames * N_BYTES_PER_FRAME) ;
+  }
 }
-#endif // #if SCENE_NFRAMES_EDITABLE
 
-void JackIO::ShutdownCallback(void* unused)
+template <Uint32 N_CHANNELS_T , bool IS_MONITORING_T , Uint32 N_LOOPS_T>
+void JackIO::MixPeriod(Uint32 nFrames       , Uint32 recordFrameN , Uint32 loopFrameN ,
+                       Uint32 nFramesToSeam , Uint32 seamFrameN                       )
 {
-  // close client and free resouces
-  if (Client)        { jack_client_close(Client) ; }
-  if (Client)        { free(Client) ;         Client        = 0 ; }
-  if (InputPort1)    { free(InputPort1) ;     InputPort1    = 0 ; }
-  if (InputPort2)    { free(InputPort2) ;     InputPort2    = 0 ; }
-  if (OutputPort1)   { free(OutputPort1) ;    OutputPort1   = 0 ; }
-  if (OutputPort2)   { free(OutputPort2) ;    OutputPort2   = 0 ; }
-  if (RecordBuffer1) { delete RecordBuffer1 ; RecordBuffer1 = 0 ; }
-  if (RecordBuffer2) { delete RecordBuffer2 ; RecordBuffer2 = 0 ; }
-  exit(1) ;
+  // N_CHANNELS_T is 0 for the generic kernel - otherwise the channel loop is unrolled
+  const Uint32 nChannels = (N_CHANNELS_T)? N_CHANNELS_T : NChannels ;
+  for (Uint32 channelN = 0 ; channelN < nChannels ; ++channelN)
+  {
+    Sample*       in     = InBuffers [channelN] ;
+    Sample*       out    = OutBuffers[channelN] ;
+    Sample*       record = RecordBuffers[channelN] + recordFrameN ;
+    const Sample* loops[N_LOOPS_T + 1] ; // + 1 - zero length arrays are not portable
+    for (Uint32 loopN = 0 ; loopN < N_LOOPS_T ; ++loopN)
+      loops[loopN] = ActiveBuffers[loopN][channelN] + loopFrameN ;
+    MixSpan<IS_MONITORING_T , N_LOOPS_T>(in , out , record , loops , ActiveVols , nFramesToSeam) ;
+
+    if (nFramesToSeam == nFrames) continue ;
+
+    for (Uint32 loopN = 0 ; loopN < N_LOOPS_T ; ++loopN)
+      loops[loopN] = ActiveBuffers[loopN][channelN] + seamFrameN ;
+    MixSpan<IS_MONITORING_T , N_LOOPS_T>(in     + nFramesToSeam , out + nFramesToSeam ,
+                                         record + nFramesToSeam , loops               ,
+                                         ActiveVols             , nFrames - nFramesToSeam) ;
+  }
 }
 
+template <bool IS_MONITORING_T , Uint32 N_LOOPS_T>
+void JackIO::MixSpan(const Sample* __restrict__ in , Sample* __restrict__ out ,
+                     Sample* __restrict__ record   , const Sample* const* loops ,
+                     const float* loopVols         , Uint32 nFrames             )
+{
+  // hoist the loop gains and read pointers so that the frame loop vectorizes
+  const Sample* __restrict__ loopBuffers[N_LOOPS_T + 1] ; float vols[N_LOOPS_T + 1] ;
+  for (Uint32 loopN = 0 ; loopN < N_LOOPS_T ; ++loopN)
+    { loopBuffers[loopN] = loops[loopN] ; vols[loopN] = loopVols[loopN] ; }
 
-// helpers
+  // write the mix straight to the output port and the input to the record buffer
+  for (Uint32 frameN = 0 ; frameN < nFrames ; ++frameN)
+  {
+    Sample sample = in[frameN] ; Sample mix = (IS_MONITORING_T)? sample : 0.0 ;
+    for (Uint32 loopN = 0 ; loopN < N_LOOPS_T ; ++loopN)
+      mix += loopBuffers[loopN][frameN] * vols[loopN] ;
+    record[frameN] = sample ; out[frameN] = mix ;
+  }
+}
 
-jack_port_t* JackIO::RegisterPort(const char* portName , unsigned long portFlags)
-  { return jack_port_register(Client , portName , JACK_DEFAULT_AUDIO_TYPE , portFlags , 0) ; }
 
 #if SCENE_NFRAMES_EDITABLE
+// helpers
+
 void JackIO::SetMetadata(jack_nframes_t sampleRate , jack_nframes_t nFramesPerPeriod)
 {
   SampleRate           = sampleRate ;
@@ -635,6 +875,7 @@ void JackIO::SetMetadata(jack_nframes_t sampleRate , jack_nframes_t nFramesPerPe
   BufferMarginBytes    = BufferMarginSize   *  N_BYTES_PER_FRAME ;
   TriggerLatencyBytes  = TriggerLatencySize *  N_BYTES_PER_FRAME ;
   FramesPerGuiInterval = (Uint32)((float)SampleRate * (float)GUI_UPDATE_IVL * 0.001) ;
+  PerfStats::SetPeriod(SampleRate , nFramesPerPeriod) ;
 
 #  if INIT_JACK_BEFORE_SCENES
 DEBUG_TRACE_JACK_SETMETADATA
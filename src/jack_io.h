@@ -22,11 +22,14 @@
 #define _JACK_IO_H_
 
 
+#include <atomic>
 #include <jack/jack.h>
 typedef jack_default_audio_sample_t Sample ;
 #include "loopidity.h"
+class AudioBackend ;
 class Loop ;
 class Scene ;
+class ScopeHistory ;
 
 
 using namespace std ;
@@ -34,13 +37,28 @@ using namespace std ;
 
 class JackIO
 {
+  friend class Bounce ;
+  friend class DummyBackend ;
+  friend class JackBackend ;
+
+
   private:
 
+    /* JackIO class side private types */
+
+    typedef void (*MixKernel)(Uint32 nFrames       , Uint32 recordFrameN , Uint32 loopFrameN ,
+                              Uint32 nFramesToSeam , Uint32 seamFrameN                       ) ;
+    template <Uint32 N_CHANNELS_T , bool IS_MONITORING_T , Uint32 N_LOOPS_T>
+    struct MixKernelRow ;
+    typedef void (*SpanKernel)(const Sample* in , Sample* out , Sample* record ,
+                               const Sample* const* loops , const float* vols  ,
+                               Uint32 nFrames                                  ) ;
+    template <Uint32 N_LOOPS_T>
+    struct SpanKernelRow ;
+
+
     /* JackIO class side private constants */
 
-    static const Uint32 N_PORTS ;
-    static const Uint32 N_INPUT_PORTS ;
-    static const Uint32 N_OUTPUT_PORTS ;
     static const Uint32 N_TRANSIENT_PEAKS ;
     static const Uint32 DEFAULT_BUFFER_SIZE ;
     static const Uint32 N_BYTES_PER_FRAME ;
@@ -49,44 +67,34 @@ class JackIO
 
     /* JackIO class side private varables */
 
-    // JACK handles
-    static jack_client_t* Client ;
-#if FIXED_N_AUDIO_PORTS
-    static jack_port_t*   InputPort1 ;
-    static jack_port_t*   InputPort2 ;
-    static jack_port_t*   OutputPort1 ;
-    static jack_port_t*   OutputPort2 ;
-#else // TODO: much
-#endif // #if FIXED_N_AUDIO_PORTS
+    // audio backend
+    static AudioBackend* Backend ;
 
     // app state
     static Scene* CurrentScene ;
     static Scene* NextScene ;
 
     // audio data
-    static Uint32  RecordBufferSize ;
-#if FIXED_N_AUDIO_PORTS
-    static Sample* RecordBuffer1 ;
-    static Sample* RecordBuffer2 ;
-#  if SCENE_NFRAMES_EDITABLE
+    static Uint32          NChannels ;     // per direction
+    static Uint32          RecordBufferSize ;
+    static vector<Sample*> RecordBuffers ; // planar - one buffer per channel
+    static vector<Sample*> InBuffers ;     // backend port buffers (per period)
+    static vector<Sample*> OutBuffers ;    // backend port buffers (per period)
+    static atomic<Loop*>   SpareLoop ;     // prefaulted for the next commit (main thread fills)
+    static atomic<Loop*>   ReturnedLoop ;  // a spare that did not fit (main thread frees)
+#if SCENE_NFRAMES_EDITABLE
 /*
     static Sample* LeadInBuffer1 ;
     static Sample* LeadInBuffer2 ;
     static Sample* LeadOutBuffer1 ;
     static Sample* LeadOutBuffer2 ;
 */
-#  endif // #if SCENE_NFRAMES_EDITABLE
-#else // TODO: much
-#endif // #if FIXED_N_AUDIO_PORTS
+#endif // #if SCENE_NFRAMES_EDITABLE
 
     // peaks data
-    static vector<Sample> PeaksIn ;                       // scope peaks (mono mix)
-    static vector<Sample> PeaksOut ;                      // scope peaks (mono mix)
-#if FIXED_N_AUDIO_PORTS
-    static Sample         TransientPeaks[N_AUDIO_PORTS] ; // VU peaks (per channel)
-#else // TODO:
-    static Sample         TransientPeaks[N_AUDIO_PORTS] ; // VU peaks (per channel)
-#endif // #if FIXED_N_AUDIO_PORTS
+    static ScopeHistory   PeaksIn ;                       // scope peaks (mono mix)
+    static ScopeHistory   PeaksOut ;                      // scope peaks (mono mix)
+    static vector<Sample> TransientPeaks ;                // VU peaks (inputs then outputs)
     static Sample         TransientPeakInMix ;
 //    static Sample         TransientPeakOutMix ;
 
@@ -96,6 +104,9 @@ class JackIO
     static Loop*     NewLoopEventLoop ;
     static SDL_Event SceneChangeEvent ;
     static Uint32    SceneChangeEventSceneN ;
+    static SDL_Event SceneResetEvent ;
+    static Uint32    SceneResetEventSceneN ;
+    static SDL_Event OutOfMemoryEvent ;
 
     // metadata
     static jack_nframes_t SampleRate ;
@@ -120,9 +131,18 @@ class JackIO
     static Uint32         BytesPerPeriod ;
 #endif // #if SCENE_NFRAMES_EDITABLE
     static Uint32         FramesPerGuiInterval ;
+    static Uint32         RecordOffsetSize ;
+
+    // DSP kernels
+    static MixKernel  MixKernels[N_MIX_KERNELS][2][NUM_LOOPS + 1] ; // [channels][monitor][nLoops]
+    static Uint32     MixKernelN ;                                  // channels row
+    static SpanKernel SpanKernels[NUM_LOOPS + 1] ;                  // [nLoops] - unmonitored (Bounce)
+    static Sample*    ActiveBuffers[NUM_LOOPS][MAX_N_CHANNELS] ;    // unmuted loops (per period)
+    static float      ActiveVols[NUM_LOOPS] ;                       // unmuted loops (per period)
 
     // misc flags
     static bool ShouldMonitorInputs ;
+    static bool ShouldOutputStems ;
 
 
   public:
@@ -131,12 +151,18 @@ class JackIO
 
     // setup
 #if INIT_JACK_BEFORE_SCENES
-    static Uint32 Init(bool shouldMonitorInputs , Uint32 recordBufferSize) ;
+    static Uint32 Init(AudioBackend* backend          , bool   shouldMonitorInputs ,
+                       Uint32        recordBufferSize , Uint32 nChannels           ,
+                       bool          shouldOutputStems                             ) ;
 #else
-    static Uint32 Init(Scene* currentScene     , bool shouldMonitorInputs ,
-                       Uint32 recordBufferSize                            ) ;
+    static Uint32 Init(AudioBackend* backend             , Scene* currentScene      ,
+                       bool          shouldMonitorInputs , Uint32 recordBufferSize ,
+                       Uint32        nChannels           , bool   shouldOutputStems) ;
 #endif // #if INIT_JACK_BEFORE_SCENES
     static void Reset( Scene* currentScene) ;
+    static void Cleanup(void) ;
+    static bool BeginCalibration(void) ;
+    static void PrepareSpareLoop(Scene* currentScene) ;
 
     // getters/setters
 #if !INIT_JACK_BEFORE_SCENES
@@ -150,9 +176,12 @@ class JackIO
 */
     static void            SetCurrentScene(   Scene* currentScene) ;
     static void            SetNextScene(      Scene* nextScene) ;
-    static vector<Sample>* GetPeaksIn(        void) ;
-    static vector<Sample>* GetPeaksOut(       void) ;
-    static Sample*         GetTransientPeaks( void) ;
+    static float           GetDspLoad(        void) ;
+    static Uint32          GetNChannels(      void) ;
+    static void            SetRecordOffset(   Uint32 nFrames) ;
+    static ScopeHistory*   GetPeaksIn(        void) ;
+    static ScopeHistory*   GetPeaksOut(       void) ;
+    static vector<Sample>* GetTransientPeaks( void) ;
     static Sample*         GetTransientPeakIn(void) ;
 //    static Sample*         GetTransientPeakOut(   void) ;
 
@@ -160,21 +189,48 @@ class JackIO
     static void   ScanTransientPeaks(void) ;
     static Sample GetPeak(           Sample* buffer , Uint32 nFrames) ;
 
+    // offline driver
+    static Uint32 InitOffline(     bool   shouldMonitorInputs , Uint32 recordBufferSize ,
+                                   Uint32 nChannels                                   ) ;
+    static void   SetOfflinePeriod(Uint32 sampleRate , Uint32 nFramesPerPeriod) ;
+    static void   ProcessOffline(  Sample** inBuffers , Sample** outBuffers , Uint32 nFrames) ;
+
 
   private:
 
     /* JackIO class side private functions */
 
-    // JACK server callbacks
-    static int  ProcessCallback(   jack_nframes_t nFramesPerPeriod , void* unused) ;
-    static int  SampleRateCallback(jack_nframes_t sampleRate ,       void* unused) ;
-    static int  BufferSizeCallback(jack_nframes_t nFramesPerPeriod , void* unused) ;
-    static void ShutdownCallback(                                    void* unused) ;
+    // setup
+    static Uint32 InitEngine(bool shouldMonitorInputs , Uint32 recordBufferSize , Uint32 nChannels) ;
+
+    // backend callbacks (see note on audio backends in audio_backend.h)
+    static int  ProcessCallback(   Uint32 nFramesPerPeriod) ;
+    static void FormatCallback(    Uint32 sampleRate , Uint32 nFramesPerPeriod) ;
+    static void ShutdownCallback(  void) ;
+    static void ThreadInitCallback(void) ;
+    static void XrunCallback(      void) ;
+
+    // JACK thread
+    static int   ProcessPeriod(Uint32 nFramesPerPeriod) ;
+    static Loop* TakeSpareLoop(Uint32 nFrames) ;
+
+    // DSP
+    static void InitMixKernels(void) ;
+    static void Mix(           Uint32 nFrames , Uint32 recordFrameN , Uint32 sceneFrameN) ;
+    template <Uint32 N_CHANNELS_T , bool IS_MONITORING_T , Uint32 N_LOOPS_T>
+    static void MixPeriod(Uint32 nFrames       , Uint32 recordFrameN , Uint32 loopFrameN ,
+                          Uint32 nFramesToSeam , Uint32 seamFrameN                       ) ;
+    static void WriteStems(  Uint32 nFrames       , Uint32 loopFrameN , Uint32 nFramesToSeam ,
+                             Uint32 seamFrameN                                             ) ;
+    static void SilenceStems(Uint32 nFrames) ;
+    template <bool IS_MONITORING_T , Uint32 N_LOOPS_T>
+    static void MixSpan(  const Sample* __restrict__ in , Sample* __restrict__ out ,
+                          Sample* __restrict__ record   , const Sample* const* loops ,
+                          const float* loopVols         , Uint32 nFrames             ) ;
 
-    // helpers
-    static jack_port_t* RegisterPort(const char* portName , unsigned long portType) ;
 #if SCENE_NFRAMES_EDITABLE
-    static void         SetMetadata( jack_nframes_t sampleRate , jack_nframes_t nFramesPerPeriod) ;
+    // helpers
+    static void SetMetadata(jack_nframes_t sampleRate , jack_nframes_t nFramesPerPeriod) ;
 #endif // #if SCENE_NFRAMES_EDITABLE
 } ;
 
@@ -184,6 +240,9 @@ class JackIO
 
 /* NOTE: on RecordBuffer layout
 
+    there is one RecordBuffer per channel (RecordBuffers[channelN]) and one buffer per
+      channel in each Loop - all channels share the offsets below
+
     to allow for dynamic adjustment of seams and compensation for SDL key event delay
       the following are the buffer offsets used:
 
@@ -293,3 +352,65 @@ thisLeadInBegin |                                |                            //
  |<--------------------------NewLoop--------------------------->|           | // dest
  |<------------------------------RecordBuffer------------------------------>| // source
 */
+
+
+/* NOTE: on mix kernels
+
+    Mix() resolves everything that varies per period before entering the kernel
+        unmuted loops are gathered into ActiveBuffers/ActiveVols
+        the loop read position is split at the loop seam into at most two contiguous spans
+    MixKernels[MixKernelN][ShouldMonitorInputs][nLoops] then selects a MixPeriod() instance
+      specialized on channel count , input monitoring and loop count
+      so that the frame loop in MixSpan() has no branches and no unknown trip counts
+    mutes are not a kernel axis - they are resolved when Mix() gathers ActiveBuffers
+    MixKernelN is chosen once in Init() - channel counts other than 1 , 2 , 4 , 8
+      use the generic row which loops over NChannels at runtime
+    SpanKernels[nLoops] are the unmonitored MixSpan() instances on their own - they take
+      the loop gains as an argument rather than reading ActiveVols so that Bounce can run
+      them on its worker thread without touching the JACK thread state
+*/
+
+
+/* NOTE: on stems
+
+    STEMS_ARG registers one output port per channel for each of the NUM_LOOPS loop slots
+      (loop1L/loop1R .. for stereo - loop1_1 .. otherwise) - slot N carries the Nth loop
+      of the current scene with its vol applied and follows the same mutes as the main mix
+    stems are written directly into the JACK port buffers from the loop buffers
+      with the same seam split as the main mix - there is no intermediate copy
+    JackBackend refreshes its connection flags from the JACK port connect callback on the
+      notification thread and getStemBuffer() returns 0 for unconnected stem ports
+      so they are skipped entirely and unused stems cost nothing
+*/
+
+
+/* NOTE: on the offline driver
+
+    ProcessCallback() only fetches the backend port buffers - everything else that happens
+      in a period is ProcessPeriod() which reads InBuffers and writes OutBuffers
+    InitOffline() , SetOfflinePeriod() , and ProcessOffline() drive the same engine
+      without any backend - the caller supplies the period buffers and the Scene
+      (via SetCurrentScene()) and calls ProcessOffline() once per period
+    stems are never registered offline and the SDL events pushed on rollover are
+      only meaningful if the caller has initialized SDL
+*/
+
+
+/* NOTE: on the spare loop
+
+    committing a loop on rollover must not allocate so the JACK thread takes SpareLoop
+      - a Loop allocated and prefaulted ahead of time on the main thread
+    all loops of a scene share its length so one spare sized for the current scene suffices
+        before the base loop exists  --> RecordBufferSize frames (the longest possible loop)
+        once the base loop exists    --> nFrames + BufferMarginsSize (the scene length)
+    PrepareSpareLoop() is called from JackIO::Reset() and after every event on the main
+      thread - it is a no-op while the spare fits the current scene and otherwise
+      replaces it (e.g. after a commit , a scene change , or a reset)
+    ownership passes only by atomic exchange - a spare that turns out too short (the main
+      thread has not yet caught up with a scene change) is handed back via ReturnedLoop
+    if no spare fits the commit falls back to allocating on the JACK thread - this is
+      the one known exception to the rule (see note on real-time hardening in rt_guard.h)
+
+    a base loop committed before its exactly sized spare is ready keeps the
+      RecordBufferSize spare - the excess is not used
+*/
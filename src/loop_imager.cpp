@@ -0,0 +1,133 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+
+#include "loop_imager.h"
+#include "scene_sdl.h"
+
+
+/* LoopImager class side private varables */
+
+// jobs
+list<LoopImageJob*> LoopImager::Jobs ;
+LoopImageJob*       LoopImager::CurrentJob = 0 ; // Worker()
+SDL_mutex*          LoopImager::JobsMutex  = 0 ; // Init()
+SDL_sem*            LoopImager::JobsSem    = 0 ; // Init()
+SDL_mutex*          LoopImager::ViewMutex  = 0 ; // Init()
+
+// worker thread
+SDL_Thread*  LoopImager::WorkerThread = 0 ; // Init()
+atomic<bool> LoopImager::IsRunning(false) ; // Init() , Cleanup()
+
+
+/* LoopImager class side private functions */
+
+// setup
+
+bool LoopImager::Init(SDL_mutex* viewMutex)
+{
+  if (WorkerThread || !(ViewMutex = viewMutex)) return false ;
+
+  IsRunning = true ;
+  if (!(JobsMutex    = SDL_CreateMutex())            ||
+      !(JobsSem      = SDL_CreateSemaphore(0))       ||
+      !(WorkerThread = SDL_CreateThread(Worker , 0))  )
+    { Cleanup() ; return false ; }
+
+  return true ;
+}
+
+void LoopImager::Cleanup()
+{
+  IsRunning = false ;
+  if (WorkerThread) { SDL_SemPost(JobsSem) ; SDL_WaitThread(WorkerThread , 0) ; WorkerThread = 0 ; }
+
+  while (!Jobs.empty()) { delete Jobs.front() ; Jobs.pop_front() ; }
+  if (JobsSem)   { SDL_DestroySemaphore(JobsSem) ; JobsSem   = 0 ; }
+  if (JobsMutex) { SDL_DestroyMutex(JobsMutex) ;   JobsMutex = 0 ; }
+}
+
+
+// GUI thread
+
+void LoopImager::Enqueue(SceneSdl* sdlScene , LoopSdl* histogramImg , Loop* aLoop)
+{
+  LoopImageJob* job = new LoopImageJob ;
+  job->sdlScene     = sdlScene ;
+  job->histogramImg = histogramImg ;
+  for (Uint16 peakN = 0 ; peakN < N_PEAKS_COURSE ; ++peakN)
+    job->peaksCourse[peakN] = aLoop->getPeakCourse(peakN) ;
+
+  SDL_mutexP(JobsMutex) ; Jobs.push_back(job) ; SDL_mutexV(JobsMutex) ;
+  SDL_SemPost(JobsSem) ;
+}
+
+void LoopImager::Cancel(SceneSdl* sdlScene , LoopSdl* histogramImg)
+{
+  // a null histogramImg cancels every job for sdlScene
+  SDL_mutexP(JobsMutex) ;
+  list<LoopImageJob*>::iterator jobIter = Jobs.begin() ;
+  while (jobIter != Jobs.end())
+  {
+    LoopImageJob* job = *jobIter ;
+    if (job->sdlScene == sdlScene && (!histogramImg || job->histogramImg == histogramImg))
+      { delete job ; jobIter = Jobs.erase(jobIter) ; }
+    else ++jobIter ;
+  }
+  if (CurrentJob && CurrentJob->sdlScene == sdlScene &&
+      (!histogramImg || CurrentJob->histogramImg == histogramImg))
+    CurrentJob = 0 ;
+  SDL_mutexV(JobsMutex) ;
+}
+
+
+// worker thread
+
+int LoopImager::Worker(void* unused)
+{
+  TraceRing::NameThread("imager") ;
+
+  while (IsRunning)
+  {
+    SDL_SemWait(JobsSem) ; if (!IsRunning) break ;
+
+    // cancelled jobs leave the semaphore ahead of the queue
+    SDL_mutexP(JobsMutex) ;
+    LoopImageJob* job = (Jobs.empty())? 0 : Jobs.front() ;
+    if (job) Jobs.pop_front() ;
+    CurrentJob = job ;
+    SDL_mutexV(JobsMutex) ;
+    if (!job) continue ;
+
+    SDL_Surface* playingImg = 0 ; SDL_Surface* mutedImg = 0 ;
+    bool isDrawn = job->sdlScene->drawHistogram(job->peaksCourse , &playingImg , &mutedImg) ;
+
+    SDL_mutexP(ViewMutex) ; SDL_mutexP(JobsMutex) ;
+    bool isCurrent = isDrawn && CurrentJob == job ;
+    if (isCurrent) { job->histogramImg->setSurfaces(playingImg , mutedImg) ; job->sdlScene->isDirty = true ; }
+    CurrentJob = 0 ;
+    SDL_mutexV(JobsMutex) ; SDL_mutexV(ViewMutex) ;
+
+    if (!isCurrent) { SDL_FreeSurface(playingImg) ; SDL_FreeSurface(mutedImg) ; }
+    delete job ; FrameScheduler::Wake() ;
+  }
+
+  return 0 ;
+}
@@ -0,0 +1,100 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+
+#ifndef _LOOP_IMAGER_H_
+#define _LOOP_IMAGER_H_
+
+
+#include <atomic>
+
+#include "loopidity.h"
+class Loop ;
+class LoopSdl ;
+class SceneSdl ;
+
+
+using namespace std ;
+
+
+typedef struct LoopImageJob
+{
+  SceneSdl* sdlScene ;
+  LoopSdl*  histogramImg ;                // placeholder - receives the finished surfaces
+  Sample    peaksCourse[N_PEAKS_COURSE] ; // snapshot - the loop may be deleted meanwhile
+} LoopImageJob ;
+
+
+class LoopImager
+{
+  friend class Loopidity ;
+  friend class SceneSdl ;
+
+
+  private:
+
+    /* LoopImager class side private varables */
+
+    // jobs
+    static list<LoopImageJob*> Jobs ;
+    static LoopImageJob*       CurrentJob ; // 0 if cancelled while in progress
+    static SDL_mutex*          JobsMutex ;
+    static SDL_sem*            JobsSem ;
+    static SDL_mutex*          ViewMutex ;  // Loopidity::ViewMutex
+
+    // worker thread
+    static SDL_Thread*  WorkerThread ;
+    static atomic<bool> IsRunning ;
+
+
+    /* LoopImager class side private functions */
+
+    // setup
+    static bool Init(   SDL_mutex* viewMutex) ;
+    static void Cleanup(void) ;
+
+    // GUI thread (holding ViewMutex)
+    static void Enqueue(SceneSdl* sdlScene , LoopSdl* histogramImg , Loop* aLoop) ;
+    static void Cancel( SceneSdl* sdlScene , LoopSdl* histogramImg) ;
+
+    // worker thread
+    static int Worker(void* unused) ;
+} ;
+
+
+#endif // #ifndef _LOOP_IMAGER_H_
+
+
+/* NOTE: on loop images
+
+    SceneSdl::addLoop() appends a placeholder LoopSdl (no surfaces - drawn as a pending frame)
+      and enqueues a job with a snapshot of the loop's course peaks
+
+    worker thread -->
+        builds the playing and muted histogram surfaces via SceneSdl::drawHistogram()
+        then , holding ViewMutex , swaps them into the placeholder and marks the scene dirty
+        and wakes the render thread
+
+    Cancel() is called by SceneSdl::deleteLoop() and SceneSdl::reset() - a queued job is dropped
+      and a job in progress is discarded when it completes
+    lock order is ViewMutex then JobsMutex on every thread
+
+    the loop rings need no job - they are drawn per frame from SceneSdl::PolarLut
+*/
@@ -44,6 +44,12 @@ SceneSdl* Loopidity::SdlScenes[N_SCENES] = {0} ;
 Uint32 Loopidity::CurrentSceneN = 0 ;
 Uint32 Loopidity::NextSceneN    = 0 ;
 
+// render thread
+SDL_Thread*    Loopidity::RenderThread = 0 ;   // Main()
+SDL_mutex*     Loopidity::ViewMutex    = 0 ;   // Main()
+atomic<bool>   Loopidity::IsRendering(false) ; // Main() , RenderLoop()
+atomic<Uint32> Loopidity::StaleSceneMask(0) ;  // UpdateView() , RenderLoop()
+
 // runtime flags
 #if WAIT_FOR_JACK_INIT
 bool Loopidity::IsJackReady           = false ;
@@ -51,6 +57,7 @@ bool Loopidity::IsJackReady           = false ;
 bool Loopidity::IsRolling             = false ;
 bool Loopidity::ShouldSceneAutoChange = false ;
 bool Loopidity::IsEditMode            = false ;
+bool Loopidity::IsPerfOverlayShown    = false ;
 
 
 /* Loopidity class side public functions */
@@ -63,10 +70,45 @@ int Loopidity::Main(int argc , char** argv)
   if (IsInitialized()) return false ;
 
   // parse command line arguments
-  bool isMonitorInputs = true , isAutoSceneChange = true ; Uint32 recordBufferSize ;
+  bool isMonitorInputs = true , isAutoSceneChange = true , isCalibrate = false ;
+  bool isLockMemory    = false , isOutputStems = false , isHeadless = false ;
+  bool isFreeRun       = false ;
+  Uint32 recordBufferSize , nChannels = DEFAULT_N_CHANNELS , fps = GUI_DEFAULT_FPS ;
+  Uint32 nBounceReps = BOUNCE_N_REPETITIONS , loopbackSize = 0 ;
+  const char* perfDumpPath = 0 , *tracePath = 0 , *dummyInPath = 0 , *dummyOutPath = 0 ;
+  const char* bounceDir    = 0 , *dummyScriptPath = 0 ;
   for (int argN = 0 ; argN < argc ; ++argN)
     if      (!strcmp(argv[argN] , MONITOR_ARG))      isMonitorInputs   = false ;
     else if (!strcmp(argv[argN] , SCENE_CHANGE_ARG)) isAutoSceneChange = false ;
+    else if (!strcmp(argv[argN] , CALIBRATE_ARG))    isCalibrate       = true ;
+    else if (!strcmp(argv[argN] , LOCK_MEMORY_ARG))  isLockMemory      = true ;
+    else if (!strcmp(argv[argN] , STEMS_ARG))        isOutputStems     = true ;
+    else if (!strcmp(argv[argN] , HEADLESS_ARG))     isHeadless        = true ;
+    else if (!strcmp(argv[argN] , FREE_RUN_ARG))     isFreeRun         = true ;
+    else if (!strcmp(argv[argN] , CHANNELS_ARG) && argN + 1 < argc)
+      nChannels = atoi(argv[++argN]) ;
+    else if (!strcmp(argv[argN] , FPS_ARG) && argN + 1 < argc)
+      fps = atoi(argv[++argN]) ;
+    else if (!strcmp(argv[argN] , BOUNCE_DIR_ARG) && argN + 1 < argc)
+      bounceDir = argv[++argN] ;
+    else if (!strcmp(argv[argN] , BOUNCE_REPS_ARG) && argN + 1 < argc)
+      nBounceReps = atoi(argv[++argN]) ;
+    else if (!strcmp(argv[argN] , PERF_DUMP_ARG) && argN + 1 < argc)
+      perfDumpPath = argv[++argN] ;
+    else if (!strcmp(argv[argN] , TRACE_ARG) && argN + 1 < argc)
+      tracePath = argv[++argN] ;
+    else if (!strcmp(argv[argN] , DUMMY_IO_ARG) && argN + 2 < argc)
+      { dummyInPath = argv[++argN] ; dummyOutPath = argv[++argN] ; }
+    else if (!strcmp(argv[argN] , DUMMY_LOOPBACK_ARG) && argN + 1 < argc)
+      loopbackSize = atoi(argv[++argN]) ;
+    else if (!strcmp(argv[argN] , DUMMY_SCRIPT_ARG) && argN + 1 < argc)
+      dummyScriptPath = argv[++argN] ;
+    else if (!strcmp(argv[argN] , TRACE_CATS_ARG) && argN + 1 < argc)
+      Trace::SetCategories(strtoul(argv[++argN] , 0 , 0)) ;
+    else if (!strcmp(argv[argN] , DECODE_TRACE_ARG) && argN + 1 < argc)
+      return (TraceRing::Decode(argv[++argN]))? EXIT_SUCCESS : EXIT_FAILURE ;
+    else if (!strcmp(argv[argN] , EXPORT_TRACE_ARG) && argN + 2 < argc)
+      return (TraceRing::Export(argv[argN + 1] , argv[argN + 2]))? EXIT_SUCCESS : EXIT_FAILURE ;
     // TODO: user defined buffer sizes via command line
 #if FIXED_AUDIO_BUFFER_SIZE
     else if (!strcmp(argv[argN] , BUFFER_SIZE_ARG)) isAutoSceneChange = !!(bufferSize = arg) ;
@@ -74,72 +116,77 @@ int Loopidity::Main(int argc , char** argv)
   recordBufferSize = 0 ;
 #endif // #if FIXED_AUDIO_BUFFER_SIZE
 
+  // record binary trace events (see note on the binary trace in trace_ring.h)
+  if (tracePath && !TraceRing::Init(tracePath)) printf(TRACE_FAIL_FMT , tracePath) ;
+  TraceRing::NameThread("main") ;
+
+  // lock all current and future pages (before JackIO allocates the record buffers)
+  if (isLockMemory && !RtGuard::LockMemory()) LoopiditySdl::Alert(LOCK_MEMORY_FAIL_MSG) ;
+
+  // select the audio backend (see note on audio backends in audio_backend.h)
+  AudioBackend* backend = (dummyInPath)?
+      (AudioBackend*)new (nothrow) DummyBackend(dummyInPath  , dummyOutPath    , !isFreeRun ,
+                                                loopbackSize , dummyScriptPath              ) :
+      (AudioBackend*)new (nothrow) JackBackend() ;
+
+  // guards the views from here on (see note on threads in loopidity_sdl.h)
+  if (!(ViewMutex = SDL_CreateMutex())) return EXIT_FAILURE ;
+
   // initialize Loopidity (controller) and instantiate Scenes (models and SdlScenes (views))
-  if (!Init(isMonitorInputs , isAutoSceneChange , recordBufferSize)) return EXIT_FAILURE ;
+  if (nChannels < 1 || nChannels > MAX_N_CHANNELS) nChannels = DEFAULT_N_CHANNELS ;
+  if (!Init(backend   , isMonitorInputs , isAutoSceneChange , recordBufferSize ,
+            nChannels , isOutputStems                                          ))
+    return EXIT_FAILURE ;
 
   // initialize LoopiditySdl (view)
-  vector<Sample>* peaksIn  = JackIO::GetPeaksIn() ;
-  vector<Sample>* peaksOut = JackIO::GetPeaksOut() ;
-  Sample* transientPeaks   = JackIO::GetTransientPeaks() ;
-  if (!LoopiditySdl::Init(SdlScenes , peaksIn , peaksOut , transientPeaks))
+  ScopeHistory*   peaksIn        = JackIO::GetPeaksIn() ;
+  ScopeHistory*   peaksOut       = JackIO::GetPeaksOut() ;
+  vector<Sample>* transientPeaks = JackIO::GetTransientPeaks() ;
+  if (!LoopiditySdl::Init(SdlScenes , peaksIn , peaksOut , transientPeaks , isHeadless))
     return EXIT_FAILURE ;
 
 DEBUG_TRACE_LOOPIDITY_MAIN_MID
 
-  // draw initial
-  LoopiditySdl::BlankScreen() ; LoopiditySdl::DrawHeader() ;
+  // measure round trip latency (see note on latency calibration in calibration.h)
+  if (isCalibrate)
+    SetCalibrationStatus((JackIO::BeginCalibration())? CALIBRATION_BEGIN_FMT : CALIBRATION_FAIL_FMT) ;
 
-  // main loop
-  bool done           = false ; SDL_Event event ;
-  Uint16 timerStart   = SDL_GetTicks() , elapsed ;
-  Uint16 guiLongCount = 0 ;
-  while (!done)
+  // offline scene render (see note on bouncing in bounce.h)
+  Bounce::Init(bounceDir , nBounceReps) ;
+
+  // render on a dedicated thread (see note on threads in loopidity_sdl.h)
+  IsRendering = true ;
+  if (!FrameScheduler::Init(fps)                          ||
+      !LoopImager::Init(ViewMutex)                        ||
+      !(RenderThread = SDL_CreateThread(RenderLoop , 0))   )
+    { IsRendering = false ; return EXIT_FAILURE ; }
+
+  // main loop - block on events and pass them off to our controller
+  bool done = false ; SDL_Event event ;
+  while (!done && SDL_WaitEvent(&event))
   {
-    // poll events and pass them off to our controller
-    while (SDL_PollEvent(&event))
+    switch (event.type)
     {
-      switch (event.type)
-      {
-        case SDL_QUIT:            done = true ;              break ;
-        case SDL_KEYDOWN:         HandleKeyEvent(  &event) ; break ;
-        case SDL_MOUSEBUTTONDOWN: HandleMouseEvent(&event) ; break ;
-        case SDL_USEREVENT:       HandleUserEvent( &event) ; break ;
-        default:                                             break ;
-      }
+      case SDL_QUIT:            done = true ;              break ;
+      case SDL_KEYDOWN:         HandleKeyEvent(  &event) ; break ;
+      case SDL_MOUSEBUTTONDOWN: HandleMouseEvent(&event) ; break ;
+      case SDL_USEREVENT:       HandleUserEvent( &event) ; break ;
+      default:                                             break ;
     }
-/*
-Uint64 now = SDL_GetPerformanceCounter() ;
-Uint64 elapsed = (now - DbgMainLoopTs) / SDL_GetPerformanceFrequency() ; DbgMainLoopTs = now ;
-if (guiLongCount == GUI_UPDATE_LOW_PRIORITY_NICE)
-  cout << "DbgMainLoopTs=" << elapsed << endl ;
-*/
-    // throttle framerate
-    elapsed = SDL_GetTicks() - timerStart ;
-    if (elapsed >= GUI_UPDATE_INTERVAL) timerStart = SDL_GetTicks() ;
-    else { SDL_Delay(1) ; continue ; }
-
-    // draw high priority
-    JackIO::ScanTransientPeaks() ;
-    LoopiditySdl::DrawScenes() ;
-#if SCENE_NFRAMES_EDITABLE
-    if (IsEditMode) LoopiditySdl::DrawEditScopes() ;
-    else LoopiditySdl::DrawTransientScopes() ;
-#else
-    LoopiditySdl::DrawScopes() ;
-#endif // #if SCENE_NFRAMES_EDITABLE
 
-    // draw low priority
-    if (!(guiLongCount = (guiLongCount + 1) % GUI_UPDATE_LOW_PRIORITY_NICE))
-    {
-      // LoopiditySdl::DrawMemory() ; // TODO: available system memory
-      if (!Scenes[CurrentSceneN]->getDoesPulseExist())
-        LoopiditySdl::SetStatusL(SdlScenes[CurrentSceneN]->makeDurationStatusText()) ;
-      LoopiditySdl::DrawStatusArea() ;
-    }
+    // keep a prefaulted loop ready for the next commit (see note on the spare loop in jack_io.h)
+    JackIO::PrepareSpareLoop(Scenes[CurrentSceneN]) ;
 
-    LoopiditySdl::FlipScreen() ;
+    // draw the outcome now rather than at the next deadline
+    FrameScheduler::Wake() ;
   } // while (!done)
 
+  IsRendering = false ; FrameScheduler::Wake() ;
+  SDL_WaitThread(RenderThread , 0) ; RenderThread = 0 ;
+
+  // write process timing histograms (see note on timing histograms in perf_stats.h)
+  if (perfDumpPath && !PerfStats::Dump(perfDumpPath)) printf(PERF_DUMP_FAIL_FMT , perfDumpPath) ;
+
 DEBUG_TRACE_LOOPIDITY_MAIN_OUT
 
   return EXIT_SUCCESS ;
@@ -171,8 +218,9 @@ bool Loopidity::GetIsRolling() { return IsRolling ; }
 #else
   bool Loopidity::IsInitialized() { return !!Scenes[0] ; }
 #endif // #if WAIT_FOR_JACK_INIT
-bool Loopidity::Init(bool   shouldMonitorInputs , bool shouldAutoSceneChange ,
-                     Uint32 recordBufferSize                                 )
+bool Loopidity::Init(AudioBackend* backend           , bool   shouldMonitorInputs ,
+                     bool          shouldAutoSceneChange , Uint32 recordBufferSize ,
+                     Uint32        nChannels             , bool   shouldOutputStems)
 {
   // disable AutoSceneChange if SCENE_CHANGE_ARG given
   if (!shouldAutoSceneChange) ToggleAutoSceneChange() ;
@@ -182,7 +230,8 @@ bool Loopidity::Init(bool   shouldMonitorInputs , bool shouldAutoSceneChange ,
   if (N_SCENES + 2 < N_SCENES) return false ;
 
   // initialize JACK
-  switch (JackIO::Init(shouldMonitorInputs , recordBufferSize))
+  switch (JackIO::Init(backend   , shouldMonitorInputs , recordBufferSize ,
+                       nChannels , shouldOutputStems                      ))
   {
     case JACK_MEM_FAIL: LoopiditySdl::Alert(INSUFFICIENT_MEMORY_MSG) ; return false ;
     case JACK_SW_FAIL:  LoopiditySdl::Alert(JACK_SW_FAIL_MSG       ) ; return false ;
@@ -219,7 +268,8 @@ bool Loopidity::Init(bool   shouldMonitorInputs , bool shouldAutoSceneChange ,
   JackIO::Reset(Scenes[0]) ; return true ;
 #else
   // initialize JACK
-  switch (JackIO::Init(Scenes[0] , shouldMonitorInputs , recordBufferSize))
+  switch (JackIO::Init(backend          , Scenes[0] , shouldMonitorInputs ,
+                       recordBufferSize , nChannels , shouldOutputStems   ))
   {
     case JACK_MEM_FAIL: LoopiditySdl::Alert(INSUFFICIENT_MEMORY_MSG) ; return false ;
     case JACK_SW_FAIL:  LoopiditySdl::Alert(JACK_SW_FAIL_MSG       ) ; return false ;
@@ -268,12 +318,80 @@ void Loopidity::SetMetadata(Uint32 sampleRate , Uint32 nFramesPerPeriod)
 
 void Loopidity::Cleanup()
 {
+  JackIO::Cleanup() ; // first - the backend clock may still be driving the Scenes
+  Calibration::Cleanup() ;
+  Bounce::Cleanup() ;
+  if (RenderThread) { IsRendering = false ; FrameScheduler::Wake() ; SDL_WaitThread(RenderThread , 0) ; RenderThread = 0 ; }
+  LoopImager::Cleanup() ; // after the render thread and before ViewMutex
+  TraceRing::Cleanup() ;
+  if (ViewMutex)    { SDL_DestroyMutex(ViewMutex) ; ViewMutex = 0 ; }
+  FrameScheduler::Cleanup() ;
+
   for (Uint32 sceneN = 0 ; sceneN < N_SCENES ; ++sceneN)
     if (SdlScenes[sceneN]) SdlScenes[sceneN]->cleanup() ;
   LoopiditySdl::Cleanup() ;
 }
 
 
+// render thread
+
+int Loopidity::RenderLoop(void* unused)
+{
+  TraceRing::NameThread("render") ;
+
+  // draw initial
+  LoopiditySdl::BlankScreen() ; LoopiditySdl::DrawHeader() ;
+
+  ViewState view ; Uint32 lastScopeTime = 0 , lastStatusTime = 0 ;
+  bool wasPerfOverlayShown = false ; char perfText[PERF_N_LINES][PERF_LINE_LEN] ;
+  while (IsRendering)
+  {
+    Uint32 frameBeginUsecs = PerfStats::NowUsecs() ;
+
+    // the controller restructures models and views only while holding ViewMutex
+    SDL_mutexP(ViewMutex) ;
+    Uint32 staleSceneMask = StaleSceneMask.exchange(0) ;
+    for (Uint32 sceneN = 0 ; sceneN < N_SCENES ; ++sceneN)
+      if (staleSceneMask & (1 << sceneN)) SdlScenes[sceneN]->updateState() ;
+    view.currentSceneN      = CurrentSceneN ;
+    view.nextSceneN         = NextSceneN ;
+    view.isEditMode         = IsEditMode ;
+    view.isPerfOverlayShown = IsPerfOverlayShown ;
+
+    // draw high priority - the scopes advance on their own timebase
+    bool isScopeDue = FrameScheduler::IsDue(&lastScopeTime , GUI_UPDATE_INTERVAL) ;
+    if (isScopeDue) JackIO::ScanTransientPeaks() ;
+    LoopiditySdl::DrawScenes(&view) ;
+#if SCENE_NFRAMES_EDITABLE
+    if      (view.isEditMode) LoopiditySdl::DrawEditScopes(&view) ;
+    else if (isScopeDue)      LoopiditySdl::DrawTransientScopes() ;
+#else
+    if (isScopeDue) LoopiditySdl::DrawScopes() ;
+#endif // #if SCENE_NFRAMES_EDITABLE
+
+    // draw low priority
+    bool isStatusDue = FrameScheduler::IsDue(&lastStatusTime , GUI_STATUS_INTERVAL) ;
+    if (isStatusDue && !Scenes[view.currentSceneN]->getDoesPulseExist())
+      LoopiditySdl::SetStatusL(SdlScenes[view.currentSceneN]->makeDurationStatusText()) ;
+    SDL_mutexV(ViewMutex) ;
+
+    LoopiditySdl::DrawStatusArea() ; // only if changed
+    if ((view.isPerfOverlayShown && isStatusDue) || view.isPerfOverlayShown != wasPerfOverlayShown)
+    {
+      if (view.isPerfOverlayShown) PerfStats::MakeOverlayText(perfText) ;
+      LoopiditySdl::DrawPerfOverlay((view.isPerfOverlayShown)? perfText : 0) ;
+      wasPerfOverlayShown = view.isPerfOverlayShown ;
+    }
+    LoopiditySdl::FlipScreen() ;
+    PerfStats::AddFrameTime(PerfStats::NowUsecs() - frameBeginUsecs) ;
+
+    FrameScheduler::WaitForNextFrame(!IsRolling) ;
+  }
+
+  return 0 ;
+}
+
+
 // event handlers
 
 void Loopidity::HandleKeyEvent(SDL_Event* event)
@@ -287,6 +405,8 @@ DEBUG_TRACE_LOOPIDITYSDL_HANDLEKEYEVENT
     case SDLK_KP0:      ToggleNextScene()      ; break ;
     case SDLK_KP_ENTER: ToggleSceneIsMuted()   ; break ;
     case SDLK_RETURN:   ToggleEditMode()       ; break ;
+    case SDLK_F1:       TogglePerfOverlay()    ; break ;
+    case SDLK_F2:       BounceScene()          ; break ;
     case SDLK_ESCAPE:   switch (event->key.keysym.mod)
     {
       case KMOD_RCTRL:    Reset()              ; break ;
@@ -325,9 +445,14 @@ void Loopidity::HandleUserEvent(SDL_Event* event)
   void* data1 = event->user.data1 ; void* data2 = event->user.data2 ;
   switch (event->user.code)
   {
-    case EVT_NEW_LOOP:      OnLoopCreation((Uint32*)data1 , (Loop**)data2) ; break ;
-    case EVT_SCENE_CHANGED: OnSceneChange((Uint32*)data1) ;                  break ;
-    default:                                                                 break ;
+    case EVT_NEW_LOOP:         OnLoopCreation((Uint32*)data1 , (Loop**)data2) ;   break ;
+    case EVT_SCENE_CHANGED:    OnSceneChange((Uint32*)data1) ;                    break ;
+    case EVT_CALIBRATION_DONE: OnCalibrationDone((Uint32*)data1 , (bool*)data2) ; break ;
+    case EVT_BOUNCE_DONE:      OnBounceDone((Uint32*)data1 , (Uint32*)data2) ;    break ;
+    case EVT_SCENE_RESET:      OnSceneReset((Uint32*)data1) ;                     break ;
+    case EVT_OUT_OF_MEMORY:    OOM() ;                                            break ;
+    case EVT_DUMMY_SYNC:       SDL_SemPost((SDL_sem*)data1) ;                     break ;
+    default:                                                                      break ;
   }
 #endif // #if HANDLE_USER_EVENTS
 }
@@ -338,7 +463,9 @@ DEBUG_TRACE_LOOPIDITY_ONLOOPCREATION_IN
 
   Uint32 sceneN = *sceneNum ;      Loop*     aLoop    = *newLoop ;
   Scene* scene  = Scenes[sceneN] ; SceneSdl* sdlScene = SdlScenes[sceneN] ;
+  SDL_mutexP(ViewMutex) ;
   if (scene->addLoop(aLoop)) sdlScene->addLoop(aLoop , scene->loops.size() - 1) ;
+  SDL_mutexV(ViewMutex) ;
 
   UpdateView(sceneN) ;
 
@@ -352,10 +479,12 @@ DEBUG_TRACE_LOOPIDITY_ONSCENECHANGE_IN
 //  if (!Scenes[CurrentSceneN]->isRolling) { Scenes[CurrentSceneN]->reset() ; }
 //else { Scenes[CurrentSceneN]->startRolling() ; SdlScenes[CurrentSceneN]->startRolling() ; }
 
+  SDL_mutexP(ViewMutex) ;
   Uint32    prevSceneN   = CurrentSceneN ; CurrentSceneN = NextSceneN = *nextSceneN ;
   SceneSdl* prevSdlScene = SdlScenes[prevSceneN] ;
   Scene*    nextScene    = Scenes   [NextSceneN] ;
   prevSdlScene->drawScene(prevSdlScene->inactiveSceneSurface , 0 , 0) ;
+  SDL_mutexV(ViewMutex) ;
   UpdateView(prevSceneN) ; UpdateView(NextSceneN) ;
 
   if (ShouldSceneAutoChange) do ToggleNextScene() ; while (!nextScene->loops.size()) ;
@@ -363,6 +492,28 @@ DEBUG_TRACE_LOOPIDITY_ONSCENECHANGE_IN
 DEBUG_TRACE_LOOPIDITY_ONSCENECHANGE_OUT
 }
 
+void Loopidity::OnCalibrationDone(Uint32* roundTripLatency , bool* isSuccess)
+{
+  Calibration::Cleanup() ; // join the worker
+
+  if (!*isSuccess) { SetCalibrationStatus(CALIBRATION_FAIL_FMT) ; return ; }
+
+  char statusText[64] ;
+  snprintf(statusText , 64 , CALIBRATION_DONE_FMT , *roundTripLatency) ;
+  LoopiditySdl::SetStatusC(statusText) ;
+}
+
+void Loopidity::OnBounceDone(Uint32* sceneNum , Uint32* nFrames)
+{
+  if (!*nFrames || !Bounce::SampleRate) { LoopiditySdl::SetStatusC(BOUNCE_FAIL_MSG) ; return ; }
+
+  char statusText[64] ;
+  snprintf(statusText , 64 , BOUNCE_DONE_FMT , *sceneNum + 1 , *nFrames / Bounce::SampleRate) ;
+  LoopiditySdl::SetStatusC(statusText) ;
+}
+
+void Loopidity::OnSceneReset(Uint32* sceneNum) { ResetScene(*sceneNum) ; }
+
 
 // user actions
 
@@ -389,8 +540,10 @@ DEBUG_TRACE_LOOPIDITY_TOGGLENEXTSCENE_IN
 
   if (!IsRolling)
   {
+    SDL_mutexP(ViewMutex) ;
     prevSceneN = CurrentSceneN ; CurrentSceneN = NextSceneN ;
     Scenes[prevSceneN]->reset() ; // SdlScenes[prevSceneN]->reset() ;
+    SDL_mutexV(ViewMutex) ;
     UpdateView(prevSceneN) ; UpdateView(NextSceneN) ;
     JackIO::SetCurrentScene(Scenes[NextSceneN]) ;
   }
@@ -403,7 +556,12 @@ void Loopidity::DeleteLoop(Uint32 sceneN , Uint32 loopN)
 DEBUG_TRACE_LOOPIDITY_DELETELOOP_IN
 
   if (!loopN) ResetScene(sceneN) ;
-  else { SdlScenes[sceneN]->deleteLoop(loopN) ; Scenes[sceneN]->deleteLoop(loopN) ; }
+  else
+  {
+    SDL_mutexP(ViewMutex) ;
+    SdlScenes[sceneN]->deleteLoop(loopN) ; Scenes[sceneN]->deleteLoop(loopN) ;
+    SDL_mutexV(ViewMutex) ;
+  }
 
 DEBUG_TRACE_LOOPIDITY_DELETELOOP_OUT
 }
@@ -427,6 +585,8 @@ DEBUG_TRACE_LOOPIDITY_INCLOOPVOL_IN
   if (isInc) { *vol += LOOP_VOL_INC ; if (*vol > 1.0) *vol = 1.0 ; }
   else { *vol -= LOOP_VOL_INC ; if (*vol < 0.0) *vol = 0.0 ; }
 
+  SDL_mutexP(ViewMutex) ; SdlScenes[sceneN]->updateLoopRadii(loopN) ; SDL_mutexV(ViewMutex) ;
+
 DEBUG_TRACE_LOOPIDITY_INCLOOPVOL_OUT
 }
 
@@ -444,11 +604,22 @@ void Loopidity::ToggleSceneIsMuted()
 
 void Loopidity::ToggleEditMode() { IsEditMode = !IsEditMode ; }
 
+void Loopidity::TogglePerfOverlay() { IsPerfOverlayShown = !IsPerfOverlayShown ; }
+
+void Loopidity::BounceScene()
+{
+  bool isBouncing = Bounce::Begin(Scenes[CurrentSceneN]) ;
+  LoopiditySdl::SetStatusC((isBouncing)? BOUNCE_BEGIN_MSG : BOUNCE_FAIL_MSG) ;
+}
+
 void Loopidity::ResetScene(Uint32 sceneN)
 {
 DEBUG_TRACE_LOOPIDITY_RESETSCENE_IN
 
-  Scenes[sceneN]->reset() ; SdlScenes[sceneN]->reset() ; UpdateView(sceneN) ;
+  SDL_mutexP(ViewMutex) ;
+  Scenes[sceneN]->reset() ; SdlScenes[sceneN]->reset() ;
+  SDL_mutexV(ViewMutex) ;
+  UpdateView(sceneN) ;
 
   bool doesAnyPulseExist = false ;
   for (sceneN = 0 ; sceneN < N_SCENES ; ++sceneN)
@@ -477,6 +648,16 @@ DEBUG_TRACE_LOOPIDITY_RESET_OUT
 
 // helpers
 
-void Loopidity::UpdateView(Uint32 sceneN) { SdlScenes[sceneN]->updateState() ; }
+// marks the view stale - the render thread updates it at the start of its next frame
+void Loopidity::UpdateView(Uint32 sceneN) { StaleSceneMask |= 1 << sceneN ; }
 
 void Loopidity::OOM() { DEBUG_TRACE_LOOPIDITY_OOM_IN LoopiditySdl::SetStatusC(OUT_OF_MEMORY_MSG) ; }
+
+// names the ports to patch as JackBackend registers them for the current channel count
+void Loopidity::SetCalibrationStatus(const char* statusFmt)
+{
+  char inName[32] , outName[32] , statusText[96] ;
+  JackBackend::MakePortNames(JackIO::GetNChannels() , 0 , inName , outName) ;
+  snprintf(statusText , 96 , statusFmt , outName , inName) ;
+  LoopiditySdl::SetStatusC(statusText) ;
+}
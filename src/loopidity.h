@@ -27,10 +27,10 @@
 //#define INIT_LOOPIDITY          1
 #define INIT_JACK_BEFORE_SCENES 1
 #define WAIT_FOR_JACK_INIT      0
-#define FIXED_N_AUDIO_PORTS     1
 //#define MEMORY_CHECK            1 // if 0 choose DEFAULT_AUDIO_BUFFER_SIZE wisely
 #define FIXED_AUDIO_BUFFER_SIZE 0 // TODO: user defined/adjustable buffer sizes
 #define SCENE_NFRAMES_EDITABLE  1
+#define RT_ALLOC_GUARD          0 // if 1 report malloc/free/mutex calls from ProcessCallback
 
 // runtime features
 #define JACK_IO_READ_WRITE            1
@@ -46,6 +46,7 @@
 #define DRAW_SCOPES                   1
 #define DRAW_EDIT_HISTOGRAM           SCENE_NFRAMES_EDITABLE && 1
 #define DRAW_DEBUG_TEXT               1
+#define DRAW_DIRTY_RECTS              1
 #define AUTO_UNMUTE_LOOPS_ON_ROLLOVER 1
 
 #if DRAW_STATUS
@@ -88,6 +89,7 @@
 #define DEBUG_TRACE_EVS          DEBUG_TRACE && 1
 #define DEBUG_TRACE_IN           DEBUG_TRACE && 1
 #define DEBUG_TRACE_OUT          DEBUG_TRACE && 1
+#define DEBUG_TRACE_CHECK        DEBUG_TRACE && 0 // mvc sanity checks on trace points
 // DEBUG end
 
 // quantities
@@ -100,15 +102,9 @@
 #define NUM_SCENES                 3
 #define NUM_LOOPS                  9 // per scene
 #define LOOP_VOL_INC               0.1
-#if FIXED_N_AUDIO_PORTS
-#  define N_INPUT_CHANNELS         2
-#  define N_OUTPUT_CHANNELS        2
-#  define N_AUDIO_PORTS            N_INPUT_CHANNELS + N_OUTPUT_CHANNELS
-#else // TODO: implement setting N_CHANNELS via cmd line arg - GetTransientPeaks and updateVUMeters are especially brittle now
-#  define N_INPUT_CHANNELS         2 // TODO: nyi - only used for memory check and scope cache
-#  define N_OUTPUT_CHANNELS        2 // TODO: nyi - only used for N_AUDIO_PORTS
-#  define N_AUDIO_PORTS            N_INPUT_CHANNELS + N_OUTPUT_CHANNELS // TODO: nyi - only used for scope cache
-#endif // #if FIXED_N_AUDIO_PORTS
+#define DEFAULT_N_CHANNELS         2  // per direction (stereo)
+#define MAX_N_CHANNELS             32 // per direction
+#define N_MIX_KERNELS              5  // channel count rows - 1 , 2 , 4 , 8 and any
 #if SCENE_NFRAMES_EDITABLE
 #  define BUFFER_MARGIN_SIZE       SampleRate
 #  define TRIGGER_LATENCY_SIZE     1280 // nFrames - kludge to compensate for keyboard delay - optimized for BufferSize <= 128
@@ -129,26 +125,80 @@
 #define PEAK_RADIUS                50 // TODO: PEAK_RADIUS and LOOP_DIAMETER are GUI specific - should probably be defined elsewhere
 #define LOOP_DIAMETER              ((PEAK_RADIUS * 2) + 1)
 #define N_PEAKS_COURSE             LOOP_DIAMETER
+#define CALIBRATION_IMPULSE_SIZE   256  // nFrames
+#define CALIBRATION_MIN_CORR       0.5  // normalized - weaker peaks are rejected as noise
+#define RT_PAGE_SIZE               4096
+#define RT_PREFAULT_STACK_SIZE     65536 // nBytes of JACK thread stack to touch on startup
+#define RT_GUARD_N_FRAMES          32    // max stack depth reported by RT_ALLOC_GUARD
+#define PERF_N_LINES               4     // performance overlay
+#define PERF_LINE_LEN              48    // performance overlay
+#define DUMMY_IO_BUFFER_SIZE       256   // nFrames per simulated period (DUMMY_IO_ARG)
+#define BOUNCE_PERIOD_SIZE         4096  // nFrames per bounce kernel call
+#define BOUNCE_N_REPETITIONS       4     // default loop repetitions per bounce
+#define BOUNCE_PATH_LEN            1024
 
 // string constants
 #define APP_NAME                "Loopidity"
 //#define CONNECT_ARG             "--connect"
 #define MONITOR_ARG             "--nomon"
 #define SCENE_CHANGE_ARG        "--noautoscenechange"
+#define CALIBRATE_ARG           "--calibrate"
+#define LOCK_MEMORY_ARG         "--mlock"
+#define CHANNELS_ARG            "--channels"
+#define STEMS_ARG               "--stems"
+#define FPS_ARG                 "--fps"
+#define HEADLESS_ARG            "--headless"
+#define PERF_DUMP_ARG           "--perfdump"
+#define TRACE_ARG               "--trace"
+#define DECODE_TRACE_ARG        "--decodetrace"
+#define EXPORT_TRACE_ARG        "--exporttrace"
+#define TRACE_CATS_ARG          "--tracecats"
+#define DUMMY_IO_ARG            "--dummyio"
+#define FREE_RUN_ARG            "--freerun"
+#define DUMMY_LOOPBACK_ARG      "--dummyloopback"
+#define DUMMY_SCRIPT_ARG        "--dummyscript"
+#define BOUNCE_DIR_ARG          "--bouncedir"
+#define BOUNCE_REPS_ARG         "--bouncereps"
+#define BOUNCE_DEFAULT_DIR      "."
+#define DUMMY_SCRIPT_TRIGGER    "trigger" // DUMMY_SCRIPT_ARG actions
+#define DUMMY_SCRIPT_SCENE      "scene"
+#define BOUNCE_FILE_FMT         "%s/loopidity_scene%d.wav"
 #define JACK_INPUT1_PORT_NAME   "inL"
 #define JACK_INPUT2_PORT_NAME   "inR"
 #define JACK_OUTPUT1_PORT_NAME  "outL"
 #define JACK_OUTPUT2_PORT_NAME  "outR"
+#define JACK_INPUT_PORT_FMT     "in%d"  // non-stereo
+#define JACK_OUTPUT_PORT_FMT    "out%d" // non-stereo
+#define JACK_STEM_L_PORT_FMT    "loop%dL"
+#define JACK_STEM_R_PORT_FMT    "loop%dR"
+#define JACK_STEM_PORT_FMT      "loop%d_%d" // non-stereo
 #define INVALID_METADATA_MSG    "ERROR: Scene metadata state insane"
 //#define FREEMEM_FAIL_MSG        "ERROR: Could not determine available memory - quitting"
 #define INSUFFICIENT_MEMORY_MSG "ERROR: Insufficient memory initializng buffers"
 #define JACK_SW_FAIL_MSG        "ERROR: Could not register JACK client"
 #define JACK_HW_FAIL_MSG        "ERROR: Could not open ports for JACK"
 #define OUT_OF_MEMORY_MSG       "ERROR: Out of Memory"
+#define CALIBRATION_BEGIN_FMT   "Calibrating - patch %s into %s"            // first output , first input
+#define CALIBRATION_FAIL_FMT    "Calibration failed - no loopback %s to %s" // first output , first input
+#define CALIBRATION_DONE_FMT    "Round trip latency: %d frames"
+#define BOUNCE_BEGIN_MSG        "Bouncing scene"
+#define BOUNCE_FAIL_MSG         "Bounce failed"
+#define BOUNCE_DONE_FMT         "Bounced scene %d: %d seconds"
+#define LOCK_MEMORY_FAIL_MSG    "WARNING: Could not lock memory - check RLIMIT_MEMLOCK"
+#define PERF_DUMP_FAIL_FMT      "WARNING: Could not write process timing to '%s'\n"
+#define TRACE_FAIL_FMT          "WARNING: Could not open trace file '%s'\n"
+#define DUMMY_IO_FAIL_FMT       "ERROR: Could not open WAV file '%s' for the dummy backend\n"
+#define DUMMY_SCRIPT_FAIL_FMT   "ERROR: Could not read trigger script '%s' for the dummy backend\n"
+#define RT_GUARD_REPORT_FMT     "\nRT_GUARD: %s() called from ProcessCallback()\n"
 
 // sdl user events
-#define EVT_NEW_LOOP      1
-#define EVT_SCENE_CHANGED 2
+#define EVT_NEW_LOOP          1
+#define EVT_SCENE_CHANGED     2
+#define EVT_CALIBRATION_DONE  3
+#define EVT_BOUNCE_DONE       4
+#define EVT_SCENE_RESET       5
+#define EVT_OUT_OF_MEMORY     6
+#define EVT_DUMMY_SYNC        7
 
 // error states
 #define JACK_INIT_SUCCESS 0
@@ -159,6 +209,8 @@
 
 // dependencies
 
+#include <atomic>              // Loopidity::IsRendering
+#include <cmath>               // SceneSdl::InitPolarLut()
 #include <cstdlib>
 #include <exception>           // Scene::Scene()
 #include <iostream>
@@ -170,7 +222,6 @@
 #include <jack/jack.h>
 #include <SDL.h>
 #include <SDL_gfxPrimitives.h>
-#include <SDL_rotozoom.h>
 #include <SDL_ttf.h>
 #ifdef _WIN32
 #  undef main
@@ -183,11 +234,25 @@
 typedef jack_default_audio_sample_t Sample ;
 
 // local includes
+#include "audio_backend.h"
+#include "bounce.h"
+#include "calibration.h"
+#include "dummy_backend.h"
+#include "frame_scheduler.h"
+#include "glyph_atlas.h"
+#include "jack_backend.h"
 #include "jack_io.h"
+#include "loop_imager.h"
 #include "loopidity_sdl.h"
+#include "perf_stats.h"
+#include "pixel_ops.h"
+#include "rt_guard.h"
 #include "scene.h"
 #include "scene_sdl.h"
+#include "scope_history.h"
 #include "trace.h"
+#include "trace_ring.h"
+#include "wav_file.h"
 
 
 using namespace std ;
@@ -222,6 +287,12 @@ class Loopidity
     static Uint32 CurrentSceneN ;
     static Uint32 NextSceneN ;
 
+    // render thread
+    static SDL_Thread*    RenderThread ;
+    static SDL_mutex*     ViewMutex ;
+    static atomic<bool>   IsRendering ;
+    static atomic<Uint32> StaleSceneMask ;
+
     // runtime flags
 #if WAIT_FOR_JACK_INIT
     static bool IsJackReady ;
@@ -229,6 +300,7 @@ class Loopidity
     static bool IsRolling ;
     static bool ShouldSceneAutoChange ;
     static bool IsEditMode ;
+    static bool IsPerfOverlayShown ;
 
   public:
 
@@ -252,8 +324,9 @@ class Loopidity
 
     // setup
     static bool IsInitialized(void) ; // TODO: make singleton
-    static bool Init(         bool   shouldMonitorInputs , bool shouldAutoSceneChange ,
-                              Uint32 recordBufferSize                                 ) ;
+    static bool Init(         AudioBackend* backend               , bool   shouldMonitorInputs ,
+                              bool          shouldAutoSceneChange , Uint32 recordBufferSize    ,
+                              Uint32        nChannels             , bool   shouldOutputStems   ) ;
 #if INIT_JACK_BEFORE_SCENES
 #  if SCENE_NFRAMES_EDITABLE
     static void SetMetadata(  SceneMetadata* sceneMetadata) ;
@@ -266,12 +339,18 @@ class Loopidity
 #endif // #if INIT_JACK_BEFORE_SCENES
     static void Cleanup(      void) ;
 
+    // render thread
+    static int RenderLoop(void* unused) ;
+
     // event handlers
     static void HandleKeyEvent(  SDL_Event* event) ;
     static void HandleMouseEvent(SDL_Event* event) ;
     static void HandleUserEvent( SDL_Event* event) ;
     static void OnLoopCreation(  Uint32* sceneNum , Loop** newLoop) ;
     static void OnSceneChange(   Uint32* sceneNum) ;
+    static void OnCalibrationDone(Uint32* roundTripLatency , bool* isSuccess) ;
+    static void OnBounceDone(    Uint32* sceneNum , Uint32* nFrames) ;
+    static void OnSceneReset(    Uint32* sceneNum) ;
 
     // user actions
     static void ToggleAutoSceneChange(void) ;
@@ -283,13 +362,16 @@ class Loopidity
     static void ToggleLoopIsMuted(    Uint32 sceneN , Uint32 loopN) ;
     static void ToggleSceneIsMuted(   void) ;
     static void ToggleEditMode(       void) ;
+    static void TogglePerfOverlay(    void) ;
+    static void BounceScene(          void) ;
     static void ResetScene(           Uint32 sceneN) ;
     static void ResetCurrentScene(    void) ;
     static void Reset(                void) ;
 
     // helpers
-    static void UpdateView(Uint32 sceneN) ;
-    static void OOM(       void) ;
+    static void UpdateView(          Uint32 sceneN) ;
+    static void OOM(                 void) ;
+    static void SetCalibrationStatus(const char* statusFmt) ;
 } ;
 
 #endif // #ifndef _LOOPIDITY_H_
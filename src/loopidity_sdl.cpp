@@ -29,6 +29,11 @@ SDL_Rect     LoopiditySdl::WinRect    = WIN_RECT ;
 Uint32       LoopiditySdl::WinBgColor = 0 ;
 const Uint16 LoopiditySdl::WinCenter  = WIN_CENTER ;
 
+// compositor
+SDL_Rect LoopiditySdl::DirtyRects[MAX_DIRTY_RECTS] ;
+Uint16   LoopiditySdl::NDirtyRects = 0 ;
+bool     LoopiditySdl::IsWinDirty  = true ;
+
 // header
 SDL_Rect        LoopiditySdl::HeaderRectDim = HEADER_RECT_DIM ;
 SDL_Rect        LoopiditySdl::HeaderRectC   = HEADER_RECT_C ;
@@ -45,6 +50,16 @@ const SDL_Color LoopiditySdl::StatusColor   = STATUS_TEXT_COLOR ;
 string          LoopiditySdl::StatusTextL   = "" ;
 string          LoopiditySdl::StatusTextC   = "" ;
 string          LoopiditySdl::StatusTextR   = "" ;
+bool            LoopiditySdl::IsStatusDirty = true ;
+bool            LoopiditySdl::IsStatusEchoed = false ; // Init()
+SDL_mutex*      LoopiditySdl::StatusMutex   = 0 ;
+GlyphAtlas      LoopiditySdl::StatusAtlas ;       // Init()
+string          LoopiditySdl::StatusDrawnL  = "" ;
+string          LoopiditySdl::StatusDrawnC  = "" ;
+string          LoopiditySdl::StatusDrawnR  = "" ;
+
+// performance overlay
+SDL_Rect LoopiditySdl::PerfOverlayRects[PERF_N_LINES] = PERF_OVERLAY_RECTS ;
 
 // scenes
 SceneSdl**   LoopiditySdl::SdlScenes         = 0 ;
@@ -54,14 +69,22 @@ SDL_Surface* LoopiditySdl::LoopGradient      = 0 ;
 
 // scopes
 SDL_Rect        LoopiditySdl::ScopeRect      = SCOPE_RECT ;
-SDL_Rect        LoopiditySdl::MaskRect       = { 0 , 0 , 1 , 0 } ;
-SDL_Rect        LoopiditySdl::GradientRect   = { 0 , 0 , 0 , 0 } ;
 const Sint16    LoopiditySdl::Scope0         = SCOPE_0 ;
 const Uint16    LoopiditySdl::ScopeR         = SCOPE_R ;
 const float     LoopiditySdl::ScopePeakH     = SCOPE_PEAK_H ;
-vector<Sample>* LoopiditySdl::PeaksIn ;
-vector<Sample>* LoopiditySdl::PeaksOut ;
-Sample*         LoopiditySdl::PeaksTransient = 0 ;
+ScopeHistory*   LoopiditySdl::PeaksIn        = 0 ;
+ScopeHistory*   LoopiditySdl::PeaksOut       = 0 ;
+vector<Sample>* LoopiditySdl::PeaksTransient = 0 ;
+Sample          LoopiditySdl::ScopePeaksIn[N_PEAKS_TRANSIENT]  = { 0 } ;
+Sample          LoopiditySdl::ScopePeaksOut[N_PEAKS_TRANSIENT] = { 0 } ;
+Sint16          LoopiditySdl::ScopeHeights[SCOPE_W + 1] ;
+#if SCENE_NFRAMES_EDITABLE
+
+// edit overlay
+SDL_Surface* LoopiditySdl::EditOverlay               = 0 ; // Init()
+Uint32       LoopiditySdl::EditOverlayNFrames        = 0 ; // DrawEditOverlay()
+Uint32       LoopiditySdl::EditOverlayNFramesPerPeak = 0 ; // DrawEditOverlay()
+#endif // #if SCENE_NFRAMES_EDITABLE
 
 // DrawScenes() 'local' variables
 Uint16       LoopiditySdl::CurrentSceneN = 0 ;
@@ -72,6 +95,7 @@ Uint16       LoopiditySdl::SceneN        = 0 ;
 SceneSdl*    LoopiditySdl::SdlScene      = 0 ;
 SDL_Surface* LoopiditySdl::SceneSurface  = 0 ;
 SDL_Rect*    LoopiditySdl::SceneRect     = 0 ;
+SDL_Rect     LoopiditySdl::DirtyRect     = { 0 , 0 , 0 , 0 } ;
 
 
 /* LoopiditySdl class side private functions */
@@ -80,8 +104,9 @@ SDL_Rect*    LoopiditySdl::SceneRect     = 0 ;
 
 bool LoopiditySdl::IsInitialized() { return !!Screen ; }
 
-bool LoopiditySdl::Init(SceneSdl** sdlScenes , vector<Sample>* peaksIn ,
-                        vector<Sample>* peaksOut , Sample* peaksTransient)
+bool LoopiditySdl::Init(SceneSdl** sdlScenes , ScopeHistory* peaksIn ,
+                        ScopeHistory* peaksOut , vector<Sample>* peaksTransient ,
+                        bool isHeadless                                        )
 {
   if (IsInitialized()) return false ;
   if (!sdlScenes || !peaksIn || !peaksOut || !peaksTransient) return false ;
@@ -92,16 +117,24 @@ bool LoopiditySdl::Init(SceneSdl** sdlScenes , vector<Sample>* peaksIn ,
   PeaksOut       = peaksOut ;
   PeaksTransient = peaksTransient ;
 
+  // draw offscreen - the dummy video driver gives a plain memory Screen surface
+  if (isHeadless) SDL_putenv(const_cast<char*>(SDL_HEADLESS_DRIVER)) ;
+  IsStatusEchoed = isHeadless ; // nothing is presented so messages go to stdout
+
   // detect screen resolution
 #ifdef _WIN32
   // TODO:
 #else // _WIN32
-  Display* display = XOpenDisplay(NULL) ; XWindowAttributes winAttr ;
-  Uint16 screenN   = DefaultScreen(display) ;
-  if (!XGetWindowAttributes(display, RootWindow(display , screenN) , &winAttr))
-    { printf(X11_ERROR_MSG) ; return false ; }
-  if (winAttr.width < SCREEN_W || winAttr.height < SCREEN_H)
-    { printf(RESOLUTION_ERROR_MSG , SCREEN_W , SCREEN_H) ; return false ; }
+  if (!isHeadless)
+  {
+    XInitThreads() ; // the render thread presents while the main thread pumps events
+    Display* display = XOpenDisplay(NULL) ; XWindowAttributes winAttr ;
+    Uint16 screenN   = DefaultScreen(display) ;
+    if (!display || !XGetWindowAttributes(display, RootWindow(display , screenN) , &winAttr))
+      { printf(X11_ERROR_MSG) ; return false ; }
+    if (winAttr.width < SCREEN_W || winAttr.height < SCREEN_H)
+      { printf(RESOLUTION_ERROR_MSG , SCREEN_W , SCREEN_H) ; return false ; }
+  }
 #endif // _WIN32
 
   // initialize SDL
@@ -109,6 +142,7 @@ bool LoopiditySdl::Init(SceneSdl** sdlScenes , vector<Sample>* peaksIn ,
   atexit(SDL_Quit) ;
   Screen = SDL_SetVideoMode(WinRect.w , WinRect.h , PIXEL_DEPTH , SDL_SCREEN_FLAGS) ;
   if (!Screen) { SdlError(SDL_SETVIDEOMODE_ERROR_TEXT) ; return false ; }
+  if (!(StatusMutex = SDL_CreateMutex())) { SdlError(SDL_CREATEMUTEX_ERROR_TEXT) ; return false ; }
 
   // set input params
   if (SDL_EnableKeyRepeat(0 , 0)) { SdlError(SDL_KEYREPEAT_ERROR_TEXT) ; return false ; }
@@ -129,15 +163,44 @@ bool LoopiditySdl::Init(SceneSdl** sdlScenes , vector<Sample>* peaksIn ,
       !(LoopGradient      = SDL_LoadBMP(LOOP_IMG_PATH     ))  )
     { SdlError(SDL_LOADBMP_ERROR_TEXT) ; return false ; }
 
+  // convert gradients to the formats of the surfaces they are drawn into (see note on gradient columns)
+  SDL_PixelFormat* sceneFormat = SdlScenes[0]->activeSceneSurface->format ;
+  if (!(ScopeGradient     = ConvertGradient(ScopeGradient     , Screen->format)) ||
+      !(HistogramGradient = ConvertGradient(HistogramGradient , sceneFormat   ))  )
+    { SdlError(SDL_CONVERTSURF_ERROR_TEXT) ; return false ; }
+
+#if SCENE_NFRAMES_EDITABLE
+  // create edit overlay (see DrawEditOverlay())
+  SDL_PixelFormat* fmt = Screen->format ;
+  if (!(EditOverlay = SDL_CreateRGBSurface(SDL_SWSURFACE , EDIT_OVERLAY_W , EDIT_OVERLAY_H ,
+                                           fmt->BitsPerPixel , fmt->Rmask , fmt->Gmask ,
+                                           fmt->Bmask , 0)))
+    { SdlError(SDL_CREATESURF_ERROR_TEXT) ; return false ; }
+#endif // #if SCENE_NFRAMES_EDITABLE
+
+  // build loop ring LUTs in the scene surface format
+  if (!SceneSdl::InitPolarLut(LoopGradient , sceneFormat))
+    { SdlError(SDL_CONVERTSURF_ERROR_TEXT) ; return false ; }
+
   // load fonts
   if (TTF_Init()) { TtfError(TTF_INIT_ERROR_MSG) ; return false ; }
   if (!(HeaderFont = TTF_OpenFont(HEADER_FONT_PATH , HEADER_FONT_SIZE)) ||
       !(StatusFont = TTF_OpenFont(STATUS_FONT_PATH , STATUS_FONT_SIZE))  )
     { TtfError(TTF_OPENFONT_ERROR_MSG) ; return false ; }
+  if (!StatusAtlas.init(StatusFont , StatusColor , Screen->format))
+    { TtfError(TTF_RENDERGLYPH_ERROR_MSG) ; return false ; }
 
   return true ;
 }
 
+SDL_Surface* LoopiditySdl::ConvertGradient(SDL_Surface* gradient , SDL_PixelFormat* fmt)
+{
+  SDL_Surface* converted = SDL_ConvertSurface(gradient , fmt , SDL_SWSURFACE) ;
+  SDL_FreeSurface(gradient) ;
+
+  return converted ;
+}
+
 void LoopiditySdl::SdlError(const char* functionName) { printf(SDL_ERROR_FMT , functionName , SDL_GetError()) ; }
 
 void LoopiditySdl::TtfError(const char* functionName) { printf(TTF_ERROR_FMT , functionName , TTF_GetError()) ; }
@@ -146,27 +209,47 @@ void LoopiditySdl::Cleanup()
 {
   if (HeaderFont)        TTF_CloseFont(HeaderFont) ;
   if (StatusFont)        TTF_CloseFont(StatusFont) ;
+  StatusAtlas.cleanup() ;
   if (ScopeGradient)     SDL_FreeSurface(ScopeGradient) ;
   if (HistogramGradient) SDL_FreeSurface(HistogramGradient) ;
   if (LoopGradient)      SDL_FreeSurface(LoopGradient) ;
+#if SCENE_NFRAMES_EDITABLE
+  if (EditOverlay)       SDL_FreeSurface(EditOverlay) ;
+#endif // #if SCENE_NFRAMES_EDITABLE
+  if (StatusMutex)       SDL_DestroyMutex(StatusMutex) ;
   if (Screen)            SDL_FreeSurface(Screen) ;
 }
 
 
 // drawing
 
-void LoopiditySdl::BlankScreen() { SDL_FillRect(Screen , 0 , WinBgColor) ; }
+void LoopiditySdl::BlankScreen()
+{
+  SDL_FillRect(Screen , 0 , WinBgColor) ; DamageAll() ;
+
+  // force DrawStatusArea() to redraw every slot
+  SDL_mutexP(StatusMutex) ;
+  StatusDrawnL.clear() ; StatusDrawnC.clear() ; StatusDrawnR.clear() ; IsStatusDirty = true ;
+  SDL_mutexV(StatusMutex) ;
+}
 
 void LoopiditySdl::DrawHeader() { DrawText(HEADER_TEXT , Screen , HeaderFont , &HeaderRectC , &HeaderRectDim , HeaderColor) ; }
 
-void LoopiditySdl::DrawScenes()
+void LoopiditySdl::DrawScenes(const ViewState* view)
 {
 #if DRAW_SCENES
-  CurrentSceneN = Loopidity::GetCurrentSceneN() ; NextSceneN = Loopidity::GetNextSceneN() ;
+  CurrentSceneN = view->currentSceneN ; NextSceneN = view->nextSceneN ;
+  bool isAnySceneDirty = false ;
   for (SceneN = 0 ; SceneN < Loopidity::N_SCENES ; ++SceneN)
   {
     SdlScene = SdlScenes[SceneN] ; SceneRect = const_cast<SDL_Rect*>(&SdlScene->sceneRect) ;
-    SDL_FillRect(Screen , SceneRect , WinBgColor) ;
+#if DRAW_DIRTY_RECTS
+    if (SceneN != CurrentSceneN && !SdlScene->isDirty) continue ;
+#else
+    SdlScene->isDirty = true ;
+#endif // #if DRAW_DIRTY_RECTS
+
+    if (SdlScene->isDirty) SDL_FillRect(Screen , SceneRect , WinBgColor) ;
     if (SceneN == CurrentSceneN)
     {
       SceneSurface = SdlScene->activeSceneSurface ;
@@ -181,8 +264,22 @@ void LoopiditySdl::DrawScenes()
     }
     else SceneSurface = SdlScene->inactiveSceneSurface ;
 
-    SDL_BlitSurface(SceneSurface , 0 , Screen , SceneRect) ;
-    SdlScene->drawSceneStateIndicator(Screen) ;
+    // drawScene() draws nothing outside of DynamicRect
+    DirtyRect    = SceneSdl::DynamicRect ;
+    DirtyRect.x += SceneRect->x ; DirtyRect.y += SceneRect->y ;
+    SDL_Rect destRect = DirtyRect ; // SDL_BlitSurface() clips destRect
+    SDL_BlitSurface(SceneSurface , const_cast<SDL_Rect*>(&SceneSdl::DynamicRect) , Screen , &destRect) ;
+    if (SdlScene->isDirty) { Damage(SceneRect) ; isAnySceneDirty = true ; SdlScene->isDirty = false ; }
+    else                   Damage(&DirtyRect) ;
+  }
+
+  // scene state indicators are outside of DynamicRect
+  if (isAnySceneDirty) for (SceneN = 0 ; SceneN < Loopidity::N_SCENES ; ++SceneN)
+  {
+    SdlScene = SdlScenes[SceneN] ; SdlScene->drawSceneStateIndicator(Screen) ;
+    DirtyRect = { 0 , (Sint16)(SdlScene->sceneFrameT - SCENE_INDICATOR_PAD) , WinRect.w ,
+                (Uint16)(SdlScene->sceneFrameB - SdlScene->sceneFrameT + (SCENE_INDICATOR_PAD * 2) + 1) } ;
+    Damage(&DirtyRect) ;
   }
 
 //SDL_FillRect(Screen , SceneRect , WinBgColor) ;
@@ -191,12 +288,12 @@ DRAW_DEBUG_TEXT_L
 }
 
 #if SCENE_NFRAMES_EDITABLE
-void LoopiditySdl::DrawEditScopes()
+void LoopiditySdl::DrawEditScopes(const ViewState* view)
 {
 #  if DRAW_EDIT_HISTOGRAM
-  SDL_FillRect(Screen , &ScopeRect , WinBgColor) ;
+  SDL_FillRect(Screen , &ScopeRect , WinBgColor) ; Damage(&ScopeRect) ;
 
-  CurrentSceneN       = Loopidity::GetCurrentSceneN() ;
+  CurrentSceneN       = view->currentSceneN ;
   Scene* currentScene = SdlScenes[CurrentSceneN]->scene ;
   Loop* baseLoop      = currentScene->getLoop(0) ;
   if (baseLoop)
@@ -204,65 +301,87 @@ void LoopiditySdl::DrawEditScopes()
     const Uint16 scopeL = (WIN_CENTER - (N_PEAKS_FINE / 2)) ;
     CurrentPeakN        = currentScene->getCurrentPeakN() ;
     SceneProgress       = ((float)CurrentPeakN / N_PEAKS_FINE) * N_PEAKS_FINE ;
+    const Uint16 maxH   = (Uint16)ScopePeakH ;
+
+    // histogram
     for (Uint16 peakN = 0 ; peakN < N_PEAKS_FINE ; ++peakN)
     {
-      // histogram
-      Sint16 histogramH = (Uint16)(baseLoop->getPeakFine(peakN) * ScopePeakH) ;
-      MaskRect.y        = (Sint16)ScopePeakH - histogramH ;
-      MaskRect.h        = (histogramH * 2) + 1 ;
-      GradientRect.x    = scopeL + peakN ;
-      GradientRect.y    = Scope0 - histogramH ;
-      SDL_BlitSurface(ScopeGradient , &MaskRect , Screen , &GradientRect) ;
-
-      if (peakN != CurrentPeakN) continue ;
-
-      // progress
-      Sint16 progressX = scopeL + SceneProgress ;
-      Sint16 progressT = Scope0 - ScopePeakH ;
-      Sint16 progressB = Scope0 + ScopePeakH ;
-      vlineColor(Screen , progressX , progressT , progressB , PEAK_CURRENT_COLOR) ;
+      Uint16 histogramH   = (Uint16)(baseLoop->getPeakFine(peakN) * ScopePeakH) ;
+      ScopeHeights[peakN] = (histogramH < maxH)? histogramH : maxH ;
     }
+    DrawGradientColumns(Screen , scopeL , Scope0 , maxH , ScopeHeights , N_PEAKS_FINE ,
+                        ScopeGradient , 0 , maxH , true , WinBgColor) ;
 
-    // graduations
+    // graduations and seams
     Uint32 nFrames        = currentScene->nFrames ;
     Uint32 nFramesPerPeak = currentScene->nFramesPerPeak ;
-    for (Uint32 frameN = 0 ; frameN < nFrames ; frameN = frameN + 10)
-    {
-      if (!(frameN % EDIT_HISTOGRAM_GRADUATIONS_GRANULARITY))
-      {
-        Sint16 gradX = scopeL + (frameN / nFramesPerPeak) ;
-        Sint16 gradT = Scope0 + ScopePeakH - EDIT_HISTOGRAM_GRADUATION_H ;
-        Sint16 gradB = Scope0 + ScopePeakH ;
-        vlineColor(Screen , gradX , gradT , gradB , SCOPE_PEAK_ZERO_COLOR) ;
-      }
-    }
+    if (nFrames != EditOverlayNFrames || nFramesPerPeak != EditOverlayNFramesPerPeak)
+      DrawEditOverlay(nFrames , nFramesPerPeak) ;
+    SDL_Rect overlayRect = { (Sint16)scopeL , (Sint16)(Scope0 - maxH) , 0 , 0 } ;
+    SDL_BlitSurface(EditOverlay , 0 , Screen , &overlayRect) ;
+
+    // progress
+    Sint16 progressX = scopeL + SceneProgress ;
+    Sint16 progressT = Scope0 - ScopePeakH ;
+    Sint16 progressB = Scope0 + ScopePeakH ;
+    vlineColor(Screen , progressX , progressT , progressB , PEAK_CURRENT_COLOR) ;
   }
 #  endif // #if DRAW_EDIT_HISTOGRAM
 }
 
+void LoopiditySdl::DrawEditOverlay(Uint32 nFrames , Uint32 nFramesPerPeak)
+{
+  EditOverlayNFrames = nFrames ; EditOverlayNFramesPerPeak = nFramesPerPeak ;
+
+  // magenta is transparent - the color key is dropped while drawing so that
+  //     the RLE encoding is rebuilt once per overlay rather than once per line
+  Uint32 keyColor = SDL_MapRGB(EditOverlay->format , 255 , 0 , 255) ;
+  SDL_SetColorKey(EditOverlay , 0 , 0) ; SDL_FillRect(EditOverlay , 0 , keyColor) ;
+
+  // seams - the base loop wraps from the right edge back to the left edge
+  const Sint16 overlayB = EDIT_OVERLAY_H - 1 ;
+  vlineColor(EditOverlay , 0                  , 0 , overlayB , EDIT_HISTOGRAM_SEAM_COLOR) ;
+  vlineColor(EditOverlay , EDIT_OVERLAY_W - 1 , 0 , overlayB , EDIT_HISTOGRAM_SEAM_COLOR) ;
+
+  // graduations - one per column that spans a multiple of EDIT_HISTOGRAM_GRADUATIONS_GRANULARITY
+  const Uint32 granularity = EDIT_HISTOGRAM_GRADUATIONS_GRANULARITY ;
+  const Sint16 gradT       = overlayB - EDIT_HISTOGRAM_GRADUATION_H ;
+  for (Uint16 peakN = 0 ; nFramesPerPeak && peakN < EDIT_OVERLAY_W ; ++peakN)
+  {
+    Uint32 beginFrameN = peakN * nFramesPerPeak ; if (beginFrameN >= nFrames) break ;
+    Uint32 endFrameN   = beginFrameN + nFramesPerPeak ;
+    Uint32 gradFrameN  = ((beginFrameN + granularity - 1) / granularity) * granularity ;
+    if (gradFrameN < endFrameN && gradFrameN < nFrames)
+      vlineColor(EditOverlay , peakN , gradT , overlayB , SCOPE_PEAK_ZERO_COLOR) ;
+  }
+
+  SDL_SetColorKey(EditOverlay , SDL_SRCCOLORKEY | SDL_RLEACCEL , keyColor) ;
+}
+
 void LoopiditySdl::DrawTransientScopes()
 #else
 void LoopiditySdl::DrawScopes()
 #endif // #if SCENE_NFRAMES_EDITABLE
 {
 #if DRAW_SCOPES
-  SDL_FillRect(Screen , &ScopeRect , WinBgColor) ;
+  // snapshot the newest peaks - on a torn read the previous snapshot is redrawn
+  PeaksIn->read(ScopePeaksIn , N_PEAKS_TRANSIENT) ;
+  PeaksOut->read(ScopePeaksOut , N_PEAKS_TRANSIENT) ;
+
+  // outputs then inputs left to right - newest peaks nearest the centre
+  const Uint16 maxH = (Uint16)ScopePeakH ;
+  ScopeHeights[0]   = -1 ; // SCOPE_L
   for (Uint16 peakN = 0 ; peakN < N_PEAKS_TRANSIENT ; ++peakN)
   {
-    Sint16 inX  = ScopeR - peakN , outX = WinCenter - peakN ;
-    Sint16 inH  = (Uint16)((*PeaksIn)[peakN] * ScopePeakH) ;
-    Sint16 outH = (Uint16)((*PeaksOut)[peakN] * ScopePeakH) ;
-
-    // input scope
-    MaskRect.y     = (Sint16)ScopePeakH - inH ; MaskRect.h = (inH * 2) + 1 ;
-    GradientRect.x = inX ; GradientRect.y = Scope0 - inH ;
-    SDL_BlitSurface(ScopeGradient , &MaskRect , Screen , &GradientRect) ;
-
-    // output scope
-    MaskRect.y     = (Sint16)ScopePeakH - outH ; MaskRect.h = (outH * 2) + 1 ;
-    GradientRect.x = outX ; GradientRect.y = Scope0 - outH ;
-    SDL_BlitSurface(ScopeGradient , &MaskRect , Screen , &GradientRect) ;
+    Uint16 inH  = (Uint16)(ScopePeaksIn[peakN]  * ScopePeakH) ;
+    Uint16 outH = (Uint16)(ScopePeaksOut[peakN] * ScopePeakH) ;
+    ScopeHeights[ScopeR    - peakN - ScopeRect.x] = (inH  < maxH)? inH  : maxH ;
+    ScopeHeights[WinCenter - peakN - ScopeRect.x] = (outH < maxH)? outH : maxH ;
   }
+
+  DrawGradientColumns(Screen , ScopeRect.x , Scope0 , maxH , ScopeHeights , ScopeRect.w ,
+                      ScopeGradient , 0 , maxH , true , WinBgColor) ;
+  Damage(&ScopeRect) ;
 #endif // #if DRAW_SCOPES
 }
 
@@ -276,25 +395,150 @@ void LoopiditySdl::DrawText(string text , SDL_Surface* surface , TTF_Font* font
 
   SDL_FillRect(surface , screenRect , WinBgColor) ;
   SDL_BlitSurface(textSurface , cropRect , surface , screenRect) ; SDL_FreeSurface(textSurface) ;
+
+  // the previous text may have been wider than this one
+  DirtyRect = { screenRect->x , screenRect->y , cropRect->w , cropRect->h } ; Damage(&DirtyRect) ;
 #endif // #if DRAW_STATUS
 }
 
+void LoopiditySdl::DrawGradientColumns(SDL_Surface* surface  , Sint16 l         , Sint16 zeroY          ,
+                                       Uint16 maxH           , const Sint16* heights , Uint16 nColumns ,
+                                       SDL_Surface* gradient , Sint16 gradientL , Sint16 gradientZeroY  ,
+                                       bool isSingleColumn   , Uint32 bgColor                           )
+{
+  // the row writes below assume 32 bit pixels (see note on gradient columns)
+  if (surface->format->BytesPerPixel != 4 || gradient->format->BytesPerPixel != 4)
+  {
+    BlitGradientColumns(surface  , l         , zeroY         , maxH           , heights , nColumns ,
+                        gradient , gradientL , gradientZeroY , isSingleColumn , bgColor            ) ;
+    return ;
+  }
+
+  SDL_LockSurface(surface) ; SDL_LockSurface(gradient) ;
+  for (Sint16 rowN = -maxH ; rowN <= maxH ; ++rowN)
+  {
+    Sint16 distance = (rowN < 0)? -rowN : rowN ;
+    Uint32* __restrict__ destRow = (Uint32*)((Uint8*)surface->pixels + ((zeroY + rowN) * surface->pitch)) + l ;
+    const Uint32* __restrict__ srcRow =
+        (const Uint32*)((Uint8*)gradient->pixels + ((gradientZeroY + rowN) * gradient->pitch)) + gradientL ;
+
+    if (isSingleColumn)
+    {
+      Uint32 color = *srcRow ;
+      for (Uint16 columnN = 0 ; columnN < nColumns ; ++columnN)
+        destRow[columnN] = (heights[columnN] >= distance)? color : bgColor ;
+    }
+    else
+      for (Uint16 columnN = 0 ; columnN < nColumns ; ++columnN)
+        destRow[columnN] = (heights[columnN] >= distance)? srcRow[columnN] : bgColor ;
+  }
+  SDL_UnlockSurface(gradient) ; SDL_UnlockSurface(surface) ;
+}
+
+void LoopiditySdl::BlitGradientColumns(SDL_Surface* surface  , Sint16 l         , Sint16 zeroY          ,
+                                       Uint16 maxH           , const Sint16* heights , Uint16 nColumns ,
+                                       SDL_Surface* gradient , Sint16 gradientL , Sint16 gradientZeroY  ,
+                                       bool isSingleColumn   , Uint32 bgColor                           )
+{
+  SDL_Rect bgRect = { l , (Sint16)(zeroY - maxH) , nColumns , (Uint16)((maxH * 2) + 1) } ;
+  SDL_FillRect(surface , &bgRect , bgColor) ;
+  for (Uint16 columnN = 0 ; columnN < nColumns ; ++columnN)
+  {
+    Sint16 h = heights[columnN] ; if (h < 0) continue ;
+
+    Sint16   gradientX = (isSingleColumn)? gradientL : gradientL + columnN ;
+    SDL_Rect maskRect  = { gradientX , (Sint16)(gradientZeroY - h) , 1 , (Uint16)((h * 2) + 1) } ;
+    SDL_Rect destRect  = { (Sint16)(l + columnN) , (Sint16)(zeroY - h) , 0 , 0 } ;
+    SDL_BlitSurface(gradient , &maskRect , surface , &destRect) ;
+  }
+}
+
 void LoopiditySdl::DrawStatusArea()
 {
-  DrawText(StatusTextL , Screen , StatusFont , &StatusRectL , &StatusRectDim , StatusColor) ;
-  DrawText(StatusTextC , Screen , StatusFont , &StatusRectC , &StatusRectDim , StatusColor) ;
-  DrawText(StatusTextR , Screen , StatusFont , &StatusRectR , &StatusRectDim , StatusColor) ;
+  SDL_mutexP(StatusMutex) ;
+  if (!IsStatusDirty) { SDL_mutexV(StatusMutex) ; return ; }
+
+  // copy only the slots that changed - the drawn strings keep their capacity so this does not allocate
+  bool isDirtyL = StatusDrawnL != StatusTextL ; if (isDirtyL) StatusDrawnL = StatusTextL ;
+  bool isDirtyC = StatusDrawnC != StatusTextC ; if (isDirtyC) StatusDrawnC = StatusTextC ;
+  bool isDirtyR = StatusDrawnR != StatusTextR ; if (isDirtyR) StatusDrawnR = StatusTextR ;
+  IsStatusDirty = false ; SDL_mutexV(StatusMutex) ;
+
+  if (isDirtyL) DrawStatusText(&StatusDrawnL , &StatusRectL) ;
+  if (isDirtyC) DrawStatusText(&StatusDrawnC , &StatusRectC) ;
+  if (isDirtyR) DrawStatusText(&StatusDrawnR , &StatusRectR) ;
 }
 
-void LoopiditySdl::FlipScreen() { SDL_Flip(Screen) ; }
+void LoopiditySdl::DrawStatusText(const string* text , SDL_Rect* screenRect)
+{
+#if DRAW_STATUS
+  DirtyRect = { screenRect->x , screenRect->y , StatusRectDim.w , StatusRectDim.h } ;
+  SDL_FillRect(Screen , &DirtyRect , WinBgColor) ;
+  StatusAtlas.drawText(text->c_str() , Screen , screenRect->x , screenRect->y , StatusRectDim.w) ;
+  Damage(&DirtyRect) ;
+#endif // #if DRAW_STATUS
+}
+
+void LoopiditySdl::DrawPerfOverlay(char text[PERF_N_LINES][PERF_LINE_LEN])
+{
+#if DRAW_STATUS
+  // null text clears the overlay
+  for (Uint32 lineN = 0 ; lineN < PERF_N_LINES ; ++lineN)
+  {
+    DirtyRect = PerfOverlayRects[lineN] ; SDL_FillRect(Screen , &DirtyRect , WinBgColor) ;
+    if (text) StatusAtlas.drawText(text[lineN] , Screen , DirtyRect.x , DirtyRect.y , DirtyRect.w) ;
+    Damage(&DirtyRect) ;
+  }
+#endif // #if DRAW_STATUS
+}
+
+void LoopiditySdl::FlipScreen()
+{
+TRACE_SPAN(TRACE_SPAN_FLIP)
+
+#if DRAW_DIRTY_RECTS
+  if      (IsWinDirty)  SDL_UpdateRect( Screen , 0 , 0 , 0 , 0) ;
+  else if (NDirtyRects) SDL_UpdateRects(Screen , NDirtyRects , DirtyRects) ;
+  IsWinDirty = false ; NDirtyRects = 0 ;
+#else
+  SDL_Flip(Screen) ;
+#endif // #if DRAW_DIRTY_RECTS
+}
+
+void LoopiditySdl::Damage(SDL_Rect* rect)
+{
+#if DRAW_DIRTY_RECTS
+  if (IsWinDirty) return ;
+  if (NDirtyRects == MAX_DIRTY_RECTS) { DamageAll() ; return ; }
+
+  // SDL_UpdateRects() does not clip
+  Sint32 l = (rect->x < 0)? 0 : rect->x ; Sint32 r = rect->x + rect->w ; if (r > WinRect.w) r = WinRect.w ;
+  Sint32 t = (rect->y < 0)? 0 : rect->y ; Sint32 b = rect->y + rect->h ; if (b > WinRect.h) b = WinRect.h ;
+  if (l >= r || t >= b) return ;
+
+  DirtyRects[NDirtyRects++] = { (Sint16)l , (Sint16)t , (Uint16)(r - l) , (Uint16)(b - t) } ;
+#endif // #if DRAW_DIRTY_RECTS
+}
+
+void LoopiditySdl::DamageAll() { IsWinDirty = true ; }
 
 void LoopiditySdl::Alert(string msg) { cout << msg << endl ; }
 
 
 // getters/settters
 
-void LoopiditySdl::SetStatusL(string text) { StatusTextL = text ; }
+void LoopiditySdl::SetStatusL(const string& text) { SetStatus(&StatusTextL , text) ; }
+
+void LoopiditySdl::SetStatusC(const string& text) { SetStatus(&StatusTextC , text) ; }
 
-void LoopiditySdl::SetStatusC(string text) { StatusTextC = text ; }
+void LoopiditySdl::SetStatusR(const string& text) { SetStatus(&StatusTextR , text) ; }
 
-void LoopiditySdl::SetStatusR(string text) { StatusTextR = text ; }
+void LoopiditySdl::SetStatus(string* statusText , const string& text)
+{
+  SDL_mutexP(StatusMutex) ;
+  bool isChanged = text != *statusText ;
+  if (isChanged) { *statusText = text ; IsStatusDirty = true ; }
+  SDL_mutexV(StatusMutex) ;
+
+  if (isChanged && IsStatusEchoed && statusText == &StatusTextC) printf(STATUS_ECHO_FMT , text.c_str()) ;
+}
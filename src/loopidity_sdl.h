@@ -23,14 +23,19 @@
 
 
 #include "loopidity.h"
+class GlyphAtlas ;
 class SceneSdl ;
+class ScopeHistory ;
 
 using namespace std ;
 
 
 // intervals
-#define GUI_UPDATE_INTERVAL          125
-#define GUI_UPDATE_LOW_PRIORITY_NICE 8   // n high priority updates to pass
+#define GUI_UPDATE_INTERVAL 125 // nMsecs per transient scope column (see note on frame pacing in frame_scheduler.h)
+
+// compositor
+#define MAX_DIRTY_RECTS     32 // more than this in one frame and the whole window is updated
+#define SCENE_INDICATOR_PAD 5  // SceneSdl::drawSceneStateIndicator() next scene frame offset
 
 // window magnitudes
 #define SCREEN_W        1024 // minimum screen resolution
@@ -38,7 +43,10 @@ using namespace std ;
 #define WIN_TITLE_H     20   // approximate window decoration size
 #define WIN_BORDER_W    2    // approximate window decoration size
 #define WIN_BORDER_H    2    // approximate window decoration size
-#define PIXEL_DEPTH     32
+#define PIXEL_DEPTH     32 // all surfaces - SDL shadows a display of any other depth
+#if PIXEL_DEPTH != 32
+#  error "SceneSdl::drawLoopRing() writes 32 bit pixels into the scene surfaces"
+#endif // #if PIXEL_DEPTH != 32
 #define WIN_W           (SCREEN_W - (WIN_BORDER_W * 2))
 #define WIN_H           (SCREEN_H - WIN_TITLE_H - WIN_BORDER_H)
 #define WIN_RECT        { 0 , 0 , WIN_W , WIN_H }
@@ -80,6 +88,15 @@ using namespace std ;
 #define STATUS_RECT_C    { (Sint16)STATUS_C , (Sint16)STATUS_Y , 0 , 0 }
 #define STATUS_RECT_R    { (Sint16)STATUS_R , (Sint16)STATUS_Y , 0 , 0 }
 
+// performance overlay magnitudes (either side of the header)
+#define PERF_OVERLAY_W     300 // approx 42 chars @ STATUS_FONT_SIZE 12
+#define PERF_OVERLAY_L     0
+#define PERF_OVERLAY_R     (WinRect.w - PERF_OVERLAY_W)
+#define PERF_OVERLAY_RECTS { { (Sint16)PERF_OVERLAY_L , 0        , PERF_OVERLAY_W , STATUS_H } , \
+                             { (Sint16)PERF_OVERLAY_L , STATUS_H , PERF_OVERLAY_W , STATUS_H } , \
+                             { (Sint16)PERF_OVERLAY_R , 0        , PERF_OVERLAY_W , STATUS_H } , \
+                             { (Sint16)PERF_OVERLAY_R , STATUS_H , PERF_OVERLAY_W , STATUS_H } }
+
 // mouse magnitudes
 #define MOUSE_SCENES_L (LOOPS_L - BORDER_PAD)
 #define MOUSE_SCENES_R (MOUSE_SCENES_L + (LOOP_W * Loopidity::N_LOOPS))
@@ -90,6 +107,9 @@ using namespace std ;
 #if SCENE_NFRAMES_EDITABLE
 #  define EDIT_HISTOGRAM_GRADUATIONS_GRANULARITY 500
 #  define EDIT_HISTOGRAM_GRADUATION_H            12
+#  define EDIT_HISTOGRAM_SEAM_COLOR              0xff00ffff
+#  define EDIT_OVERLAY_W                         N_PEAKS_FINE
+#  define EDIT_OVERLAY_H                         (SCOPE_H + 1)
 #endif // #if SCENE_NFRAMES_EDITABLE
 
 // external assets
@@ -116,19 +136,39 @@ using namespace std ;
 #define RESOLUTION_ERROR_MSG        "ERROR: screen resolution must be at least %dx%d - quitting\n"
 #define SDL_ERROR_FMT               "ERROR: %s(): %s\n"
 #define SDL_INIT_ERROR_TEXT         "SDL_Init"
+#define SDL_HEADLESS_DRIVER         "SDL_VIDEODRIVER=dummy"
 #define SDL_SETVIDEOMODE_ERROR_TEXT "SDL_SetVideoMode"
 #define SDL_KEYREPEAT_ERROR_TEXT    "SDL_EnableKeyRepeat"
 #define SDL_LOADBMP_ERROR_TEXT      "SDL_LoadBMP"
+#define SDL_CONVERTSURF_ERROR_TEXT  "SDL_ConvertSurface"
+#define SDL_CREATEMUTEX_ERROR_TEXT  "SDL_CreateMutex"
+#define SDL_CREATESURF_ERROR_TEXT   "SDL_CreateRGBSurface"
 #define TTF_ERROR_FMT               "ERROR: %s(): %s\n"
 #define TTF_INIT_ERROR_MSG          "TTF_Init"
 #define TTF_OPENFONT_ERROR_MSG      "TTF_OpenFont"
+#define TTF_RENDERGLYPH_ERROR_MSG   "TTF_RenderGlyph_Solid"
+#define STATUS_ECHO_FMT             "%s\n"
 
 // flags
-#define SDL_SCREEN_FLAGS SDL_HWSURFACE | SDL_DOUBLEBUF
+#if DRAW_DIRTY_RECTS
+#  define SDL_SCREEN_FLAGS SDL_SWSURFACE // SDL_UpdateRects() is not valid on a double buffered screen
+#else
+#  define SDL_SCREEN_FLAGS SDL_HWSURFACE | SDL_DOUBLEBUF
+#endif // #if DRAW_DIRTY_RECTS
+
+
+typedef struct ViewState
+{
+  Uint32 currentSceneN ;
+  Uint32 nextSceneN ;
+  bool   isEditMode ;
+  bool   isPerfOverlayShown ;
+} ViewState ;
 
 
 class LoopiditySdl
 {
+  friend class GuiBench ;
   friend class Loopidity ;
   friend class SceneSdl ;
   friend class Trace ;
@@ -144,6 +184,11 @@ class LoopiditySdl
     static Uint32       WinBgColor ;
     static const Uint16 WinCenter ;
 
+    // compositor
+    static SDL_Rect DirtyRects[MAX_DIRTY_RECTS] ;
+    static Uint16   NDirtyRects ;
+    static bool     IsWinDirty ;
+
     // header
     static SDL_Rect        HeaderRectDim ;
     static SDL_Rect        HeaderRectC ;
@@ -160,6 +205,16 @@ class LoopiditySdl
     static string          StatusTextL ;
     static string          StatusTextC ;
     static string          StatusTextR ;
+    static bool            IsStatusDirty ;
+    static bool            IsStatusEchoed ; // headless - StatusTextC is printed to stdout
+    static SDL_mutex*      StatusMutex ;
+    static GlyphAtlas      StatusAtlas ;
+    static string          StatusDrawnL ; // DrawStatusArea() - render thread only
+    static string          StatusDrawnC ; // DrawStatusArea() - render thread only
+    static string          StatusDrawnR ; // DrawStatusArea() - render thread only
+
+    // performance overlay
+    static SDL_Rect PerfOverlayRects[PERF_N_LINES] ;
 
     // scenes
     static SceneSdl**   SdlScenes ;
@@ -169,14 +224,22 @@ class LoopiditySdl
 
     // scopes
     static SDL_Rect        ScopeRect ;
-    static SDL_Rect        MaskRect ;
-    static SDL_Rect        GradientRect ;
     static const Sint16    Scope0 ;
     static const Uint16    ScopeR ;
     static const float     ScopePeakH ;
-    static vector<Sample>* PeaksIn ;
-    static vector<Sample>* PeaksOut ;
-    static Sample*         PeaksTransient ;
+    static ScopeHistory*   PeaksIn ;
+    static ScopeHistory*   PeaksOut ;
+    static vector<Sample>* PeaksTransient ;
+    static Sample          ScopePeaksIn[N_PEAKS_TRANSIENT] ;  // DrawTransientScopes() snapshot
+    static Sample          ScopePeaksOut[N_PEAKS_TRANSIENT] ; // DrawTransientScopes() snapshot
+    static Sint16          ScopeHeights[SCOPE_W + 1] ; // DrawGradientColumns() (-1 is no column)
+#if SCENE_NFRAMES_EDITABLE
+
+    // edit overlay
+    static SDL_Surface* EditOverlay ;
+    static Uint32       EditOverlayNFrames ;        // DrawEditOverlay()
+    static Uint32       EditOverlayNFramesPerPeak ; // DrawEditOverlay()
+#endif // #if SCENE_NFRAMES_EDITABLE
 
     // DrawScenes() 'local' variables
     static Uint16       CurrentSceneN ;
@@ -187,14 +250,17 @@ class LoopiditySdl
     static SceneSdl*    SdlScene ;
     static SDL_Surface* SceneSurface ;
     static SDL_Rect*    SceneRect ;
+    static SDL_Rect     DirtyRect ;
 
 
     /* LoopiditySdl class side private functions */
 
     // setup
     static bool IsInitialized(void) ; // TODO: make singleton
-    static bool Init(         SceneSdl** sdlScenes , vector<Sample>* peaksIn ,
-                              vector<Sample>* peaksOut , Sample* peaksTransient) ;
+    static bool Init(         SceneSdl** sdlScenes , ScopeHistory* peaksIn ,
+                              ScopeHistory* peaksOut , vector<Sample>* peaksTransient ,
+                              bool isHeadless                                        ) ;
+    static SDL_Surface* ConvertGradient(SDL_Surface* gradient , SDL_PixelFormat* fmt) ;
     static void SdlError(     const char* functionName) ;
     static void TtfError(     const char* functionName) ;
     static void Cleanup(      void) ;
@@ -202,9 +268,10 @@ class LoopiditySdl
     // drawing
     static void DrawHeader(         void) ;
     static void BlankScreen(        void) ;
-    static void DrawScenes(         void) ;
+    static void DrawScenes(         const ViewState* view) ;
 #if SCENE_NFRAMES_EDITABLE
-    static void DrawEditScopes(     void) ;
+    static void DrawEditScopes(     const ViewState* view) ;
+    static void DrawEditOverlay(    Uint32 nFrames , Uint32 nFramesPerPeak) ;
     static void DrawTransientScopes(void) ;
 #else
     static void DrawScopes(         void) ;
@@ -213,15 +280,89 @@ class LoopiditySdl
                                     SDL_Rect* screenRect , SDL_Rect* cropRect ,
                                     SDL_Color fgColor) ;
     static void DrawStatusArea(     void) ;
+    static void DrawPerfOverlay(    char text[PERF_N_LINES][PERF_LINE_LEN]) ;
+    static void DrawStatusText(     const string* text , SDL_Rect* screenRect) ;
+    static void DrawGradientColumns(SDL_Surface* surface  , Sint16 l         , Sint16 zeroY          ,
+                                    Uint16 maxH           , const Sint16* heights , Uint16 nColumns ,
+                                    SDL_Surface* gradient , Sint16 gradientL , Sint16 gradientZeroY  ,
+                                    bool isSingleColumn   , Uint32 bgColor                           ) ;
+    static void BlitGradientColumns(SDL_Surface* surface  , Sint16 l         , Sint16 zeroY          ,
+                                    Uint16 maxH           , const Sint16* heights , Uint16 nColumns ,
+                                    SDL_Surface* gradient , Sint16 gradientL , Sint16 gradientZeroY  ,
+                                    bool isSingleColumn   , Uint32 bgColor                           ) ;
     static void FlipScreen(         void) ;
+    static void Damage(             SDL_Rect* rect) ;
+    static void DamageAll(          void) ;
     static void Alert(              string msg) ;
 
     // getters/settters
-    static void SetStatusL(string msg) ;
-    static void SetStatusC(string msg) ;
-    static void SetStatusR(string msg) ;
+    static void SetStatusL(const string& msg) ;
+    static void SetStatusC(const string& msg) ;
+    static void SetStatusR(const string& msg) ;
+    static void SetStatus( string* statusText , const string& text) ;
 //    static Uint32 GetAvailableMemory() ;
 } ;
 
 
 #endif // #ifndef _LOOPIDITY_SDL_H_
+
+
+/* NOTE: on gradient columns
+
+    the scopes , the edit histogram , and the loop histograms are drawn as columns
+      of a gradient image masked to each peak height (formerly one blit per column)
+
+    DrawGradientColumns() instead writes the whole rect row by row directly into the
+      locked surface - each pixel is either the gradient (row centered on zeroY) or bgColor
+      so the inner loop is a branchless select that the compiler vectorizes
+    the gradients are converted to the format of the surfaces they are drawn into
+      once in Init() so no pixel conversion happens per frame
+    the row writes assume 32 bit pixels - scene and histogram surfaces are created at
+      PIXEL_DEPTH and the Screen is requested at PIXEL_DEPTH without SDL_ANYFORMAT so SDL
+      shadows a display of any other depth - should a surface still arrive at another
+      depth the columns fall back to BlitGradientColumns() (the former one blit per column)
+*/
+
+
+/* NOTE: on threads
+
+    main thread   -->
+        sets the video mode then blocks in SDL_WaitEvent() and dispatches to the controller
+        user actions that only flip flags (e.g. triggers) never wait on the render thread -
+          Loopidity::UpdateView() only marks the scene stale in Loopidity::StaleSceneMask
+        user actions that restructure models or views (adding , deleting , or resetting loops
+          and changing scenes) hold Loopidity::ViewMutex so may wait up to one frame
+    render thread -->
+        Loopidity::RenderLoop() holds ViewMutex for the whole of its drawing -
+          it updates the stale scene views , copies the scalar controller state into a
+          ViewState , and draws the live models and views (there are no deep snapshots)
+        the status text is copied under StatusMutex and presentation happens unlocked
+    JACK thread   -->
+        takes no locks and never touches the views - new loops , scene changes , scene resets ,
+          and allocation failures reach the main thread as preallocated SDL user events
+    X11           -->
+        XInitThreads() is called before any other Xlib call as both threads reach Xlib
+*/
+
+
+/* NOTE: on the compositor
+
+    each widget adds the screen rect it has redrawn via Damage()
+      and FlipScreen() presents only those rects via SDL_UpdateRects()
+
+    scenes     -->
+        the current scene redraws and presents only SceneSdl::DynamicRect
+          (scene scope , loop rings , histograms , and the recording loop)
+        other scenes are redrawn only when SceneSdl::isDirty is set by a state change
+        when any scene is redrawn entirely all scene state indicators are redrawn
+          as the next scene indicator overlaps the neighbouring scene rect
+    scopes     -->
+        scroll every frame so ScopeRect is always damaged
+    status     -->
+        redrawn only when SetStatus*() changes the text
+        a headless run presents nothing so changes to the center text are printed instead
+    everything -->
+        BlankScreen() or overflowing MAX_DIRTY_RECTS presents the entire window
+
+    if DRAW_DIRTY_RECTS is not set every frame presents the entire window via SDL_Flip()
+*/
@@ -0,0 +1,232 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#ifndef _WIN32
+#  include <unistd.h> // GetFreeBytes()
+#endif // _WIN32
+
+#include "perf_stats.h"
+
+
+/* PerfStats class side private varables */
+
+// JACK thread
+atomic<Uint32>       PerfStats::PeriodUsecs(0) ; // SetPeriod()
+PerfStats::Histogram PerfStats::PeriodTimes ;    // AddProcessTime() - zero-initialized
+PerfStats::Histogram PerfStats::RolloverTimes ;  // AddProcessTime() - zero-initialized
+atomic<Uint32>       PerfStats::NXruns(0) ;      // AddXrun()
+
+// memory
+atomic<size_t> PerfStats::RecordBytes(0) ; // SetRecordBytes()
+atomic<size_t> PerfStats::LoopBytes(0) ;   // AddLoopBytes() , SubLoopBytes()
+
+// render thread only
+Uint32 PerfStats::FrameUsecs[PERF_N_FRAME_TIMES] = { 0 } ; // AddFrameTime()
+Uint32 PerfStats::FrameTimeN                     = 0 ;     // AddFrameTime()
+Uint32 PerfStats::NFrameTimes                    = 0 ;     // AddFrameTime()
+
+
+/* PerfStats::ProcessScope public functions */
+
+PerfStats::ProcessScope::ProcessScope(Histogram* aHistogram)
+  { histogram = aHistogram ; beginUsecs = NowUsecs() ; }
+
+PerfStats::ProcessScope::~ProcessScope() { AddProcessTime(histogram , NowUsecs() - beginUsecs) ; }
+
+
+/* PerfStats class side public functions */
+
+// main thread
+
+bool PerfStats::Dump(const char* path)
+{
+  FILE* file = fopen(path , "w") ; if (!file) return false ;
+
+  const char* names[2]      = { "period" , "rollover" } ;
+  Histogram*  histograms[2] = { &PeriodTimes , &RolloverTimes } ;
+  fprintf(file , PERF_DUMP_HEADER_FMT , PeriodUsecs.load(memory_order_relaxed) ,
+          NXruns.load(memory_order_relaxed) , "" , "n" , "p50" , "p99" , "max" , "over") ;
+  for (Uint32 histogramN = 0 ; histogramN < 2 ; ++histogramN)
+  {
+    Histogram* histogram = histograms[histogramN] ; Uint32 nSamples = 0 ;
+    for (Uint32 bucketN = 0 ; bucketN < PERF_N_BUCKETS ; ++bucketN)
+      nSamples += histogram->counts[bucketN].load(memory_order_relaxed) ;
+    fprintf(file , PERF_DUMP_ROW_FMT , names[histogramN] , nSamples ,
+            GetPercentile(histogram , 50) , GetPercentile(histogram , 99) ,
+            histogram->maxUsecs.load(memory_order_relaxed) ,
+            histogram->nOverruns.load(memory_order_relaxed)) ;
+  }
+
+  // non-empty buckets only
+  for (Uint32 histogramN = 0 ; histogramN < 2 ; ++histogramN)
+  {
+    Histogram* histogram = histograms[histogramN] ;
+    fprintf(file , PERF_DUMP_HIST_FMT , names[histogramN] , "lower us" , "upper us" , "count") ;
+    for (Uint32 bucketN = 0 ; bucketN < PERF_N_BUCKETS ; ++bucketN)
+    {
+      Uint32 count = histogram->counts[bucketN].load(memory_order_relaxed) ;
+      if (count) fprintf(file , PERF_DUMP_BUCKET_FMT , GetBucketLower(bucketN) ,
+                         GetBucketUpper(bucketN) , count) ;
+    }
+  }
+
+  return !fclose(file) ;
+}
+
+
+/* PerfStats class side private functions */
+
+// JACK threads
+
+void PerfStats::SetPeriod(Uint32 sampleRate , Uint32 nFramesPerPeriod)
+{
+  if (!sampleRate) return ;
+
+  PeriodUsecs.store((Uint32)(((Uint64)nFramesPerPeriod * 1000000) / sampleRate) ,
+                    memory_order_relaxed) ;
+}
+
+void PerfStats::AddXrun() { NXruns.fetch_add(1 , memory_order_relaxed) ; }
+
+void PerfStats::AddProcessTime(Histogram* histogram , Uint32 usecs)
+{
+  histogram->counts[GetBucketN(usecs)].fetch_add(1 , memory_order_relaxed) ;
+  StoreMax(&histogram->maxUsecs , usecs) ;
+  Uint32 periodUsecs = PeriodUsecs.load(memory_order_relaxed) ;
+  if (periodUsecs && usecs > periodUsecs) histogram->nOverruns.fetch_add(1 , memory_order_relaxed) ;
+}
+
+
+// memory
+
+void PerfStats::SetRecordBytes(size_t nBytes) { RecordBytes.store(nBytes , memory_order_relaxed) ; }
+
+void PerfStats::AddLoopBytes(size_t nBytes) { LoopBytes.fetch_add(nBytes , memory_order_relaxed) ; }
+
+void PerfStats::SubLoopBytes(size_t nBytes) { LoopBytes.fetch_sub(nBytes , memory_order_relaxed) ; }
+
+size_t PerfStats::GetFreeBytes()
+{
+#ifdef _WIN32
+  return 0 ;
+#else // _WIN32
+  long nPages = sysconf(_SC_AVPHYS_PAGES) ; long pageSize = sysconf(_SC_PAGESIZE) ;
+
+  return (nPages > 0 && pageSize > 0)? (size_t)nPages * (size_t)pageSize : 0 ;
+#endif // _WIN32
+}
+
+
+// render thread
+
+void PerfStats::AddFrameTime(Uint32 usecs)
+{
+  FrameUsecs[FrameTimeN] = usecs ; FrameTimeN = (FrameTimeN + 1) % PERF_N_FRAME_TIMES ;
+  if (NFrameTimes < PERF_N_FRAME_TIMES) ++NFrameTimes ;
+}
+
+void PerfStats::MakeOverlayText(char text[PERF_N_LINES][PERF_LINE_LEN])
+{
+  // JACK thread counters
+  snprintf(text[0] , PERF_LINE_LEN , PERF_DSP_FMT , JackIO::GetDspLoad() ,
+           NXruns.load(memory_order_relaxed) , PeriodTimes.nOverruns.load(memory_order_relaxed) ,
+           PeriodUsecs.load(memory_order_relaxed)) ;
+  snprintf(text[1] , PERF_LINE_LEN , PERF_PROCESS_FMT ,
+           GetPercentile(&PeriodTimes   , 50) , GetPercentile(&PeriodTimes   , 99) ,
+           PeriodTimes.maxUsecs.load(memory_order_relaxed)                         ,
+           GetPercentile(&RolloverTimes , 50) , GetPercentile(&RolloverTimes , 99) ,
+           RolloverTimes.maxUsecs.load(memory_order_relaxed)                       ) ;
+
+  // GUI frame time percentiles - sorted on a copy so that the ring order is kept
+  Uint32 frameUsecs[PERF_N_FRAME_TIMES] ; Uint32 nFrames = NFrameTimes ;
+  copy(FrameUsecs , FrameUsecs + nFrames , frameUsecs) ; sort(frameUsecs , frameUsecs + nFrames) ;
+  float p50 = (nFrames)? frameUsecs[nFrames / 2]          * 0.001 : 0.0 ;
+  float p95 = (nFrames)? frameUsecs[(nFrames * 95) / 100] * 0.001 : 0.0 ;
+  float max = (nFrames)? frameUsecs[nFrames - 1]          * 0.001 : 0.0 ;
+  snprintf(text[2] , PERF_LINE_LEN , PERF_FRAME_FMT , p50 , p95 , max) ;
+
+  // memory
+  size_t usedBytes = RecordBytes.load(memory_order_relaxed) + LoopBytes.load(memory_order_relaxed) ;
+  snprintf(text[3] , PERF_LINE_LEN , PERF_MEMORY_FMT , (Uint32)(usedBytes / PERF_BYTES_PER_MB) ,
+           (Uint32)(GetFreeBytes() / PERF_BYTES_PER_MB)) ;
+}
+
+
+// helpers
+
+Uint32 PerfStats::NowUsecs()
+{
+  timespec now ; clock_gettime(CLOCK_MONOTONIC , &now) ;
+
+  return (Uint32)((now.tv_sec * 1000000) + (now.tv_nsec / 1000)) ;
+}
+
+void PerfStats::StoreMax(atomic<Uint32>* max , Uint32 usecs)
+{
+  Uint32 prevMax = max->load(memory_order_relaxed) ;
+  while (usecs > prevMax && !max->compare_exchange_weak(prevMax , usecs , memory_order_relaxed)) ;
+}
+
+Uint32 PerfStats::GetBucketN(Uint32 usecs)
+{
+  if (usecs < PERF_N_SUB_BUCKETS) return usecs ;
+
+  Uint32 msbN = 31 - __builtin_clz(usecs) ; Uint32 shift = msbN - PERF_SUB_BUCKET_BITS ;
+
+  return ((msbN - 1) * PERF_N_SUB_BUCKETS) + ((usecs >> shift) & (PERF_N_SUB_BUCKETS - 1)) ;
+}
+
+Uint32 PerfStats::GetBucketLower(Uint32 bucketN)
+{
+  if (bucketN < PERF_N_SUB_BUCKETS) return bucketN ;
+
+  Uint32 msbN = (bucketN / PERF_N_SUB_BUCKETS) + 1 ; Uint32 shift = msbN - PERF_SUB_BUCKET_BITS ;
+
+  return (PERF_N_SUB_BUCKETS + (bucketN % PERF_N_SUB_BUCKETS)) << shift ;
+}
+
+Uint32 PerfStats::GetBucketUpper(Uint32 bucketN)
+{
+  if (bucketN < PERF_N_SUB_BUCKETS) return bucketN ;
+
+  Uint32 msbN = (bucketN / PERF_N_SUB_BUCKETS) + 1 ; Uint32 shift = msbN - PERF_SUB_BUCKET_BITS ;
+
+  return GetBucketLower(bucketN) + ((1u << shift) - 1) ;
+}
+
+Uint32 PerfStats::GetPercentile(Histogram* histogram , Uint32 percent)
+{
+  // snapshot the counts - the JACK thread may add to them meanwhile
+  Uint32 counts[PERF_N_BUCKETS] ; Uint64 nSamples = 0 ;
+  for (Uint32 bucketN = 0 ; bucketN < PERF_N_BUCKETS ; ++bucketN)
+    nSamples += (counts[bucketN] = histogram->counts[bucketN].load(memory_order_relaxed)) ;
+  if (!nSamples) return 0 ;
+
+  Uint64 rank     = ((nSamples * percent) + 99) / 100 ; Uint64 nBelow = 0 ;
+  Uint32 maxUsecs = histogram->maxUsecs.load(memory_order_relaxed) ;
+  for (Uint32 bucketN = 0 ; bucketN < PERF_N_BUCKETS ; ++bucketN)
+    if ((nBelow += counts[bucketN]) >= rank) return min(GetBucketUpper(bucketN) , maxUsecs) ;
+
+  return maxUsecs ;
+}
@@ -0,0 +1,179 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+
+#ifndef _PERF_STATS_H_
+#define _PERF_STATS_H_
+
+
+#include <atomic>
+
+#include "loopidity.h"
+
+
+#define PERF_STATS_PROCESS_SCOPE  PerfStats::ProcessScope perfStatsProcessScope(&PerfStats::PeriodTimes) ;
+#define PERF_STATS_ROLLOVER_SCOPE PerfStats::ProcessScope perfStatsRolloverScope(&PerfStats::RolloverTimes) ;
+
+// timing histograms
+#define PERF_N_SUB_BUCKETS   4   // per power of two (see note on timing histograms)
+#define PERF_SUB_BUCKET_BITS 2   // log2(PERF_N_SUB_BUCKETS)
+#define PERF_N_BUCKETS       128 // covers the full range of Uint32 usecs
+
+// overlay
+#define PERF_N_FRAME_TIMES   128 // GUI frame times kept for percentiles
+#define PERF_DSP_FMT         "DSP %5.1f%%  xruns %u  over %u @ %u us"
+#define PERF_PROCESS_FMT     "period %u/%u/%u  roll %u/%u/%u us"
+#define PERF_FRAME_FMT       "GUI p50 %.1f  p95 %.1f  max %.1f ms"
+#define PERF_MEMORY_FMT      "mem %u MB used   %u MB free"
+#define PERF_BYTES_PER_MB    (1024 * 1024)
+
+// dump file
+#define PERF_DUMP_HEADER_FMT "loopidity process timing - period budget %u us - xruns %u\n\n%-10s %10s %8s %8s %8s %8s\n"
+#define PERF_DUMP_ROW_FMT    "%-10s %10u %8u %8u %8u %8u\n"
+#define PERF_DUMP_HIST_FMT   "\n%s histogram\n%10s %10s %10s\n"
+#define PERF_DUMP_BUCKET_FMT "%10u %10u %10u\n"
+
+
+using namespace std ;
+
+
+class PerfStats
+{
+  friend class JackIO ;
+  friend class Loop ;
+  friend class Loopidity ;
+
+
+  public:
+
+    /* PerfStats::Histogram - log-bucketed durations written only by the JACK thread */
+
+    struct Histogram
+    {
+      atomic<Uint32> counts[PERF_N_BUCKETS] ;
+      atomic<Uint32> maxUsecs ;
+      atomic<Uint32> nOverruns ; // durations over PeriodUsecs
+    } ;
+
+
+    /* PerfStats::ProcessScope - times the enclosing block of ProcessCallback() */
+
+    class ProcessScope
+    {
+      public:
+
+        ProcessScope(Histogram* aHistogram) ;
+        ~ProcessScope() ;
+
+
+      private:
+
+        Histogram* histogram ;
+        Uint32     beginUsecs ;
+    } ;
+
+
+    /* PerfStats class side public functions */
+
+    // main thread
+    static bool Dump(const char* path) ;
+
+
+  private:
+
+    /* PerfStats class side private varables */
+
+    // JACK thread
+    static atomic<Uint32> PeriodUsecs ;
+    static Histogram      PeriodTimes ;   // all of ProcessCallback()
+    static Histogram      RolloverTimes ; // the rollover/loop-commit branch only
+    static atomic<Uint32> NXruns ;
+
+    // memory
+    static atomic<size_t> RecordBytes ;
+    static atomic<size_t> LoopBytes ;
+
+    // render thread only
+    static Uint32 FrameUsecs[PERF_N_FRAME_TIMES] ;
+    static Uint32 FrameTimeN ;
+    static Uint32 NFrameTimes ;
+
+
+    /* PerfStats class side private functions */
+
+    // JACK threads
+    static void SetPeriod(     Uint32 sampleRate , Uint32 nFramesPerPeriod) ;
+    static void AddXrun(       void) ;
+    static void AddProcessTime(Histogram* histogram , Uint32 usecs) ;
+
+    // memory
+    static void SetRecordBytes(size_t nBytes) ;
+    static void AddLoopBytes(  size_t nBytes) ;
+    static void SubLoopBytes(  size_t nBytes) ;
+    static size_t GetFreeBytes(void) ;
+
+    // render thread
+    static void AddFrameTime(   Uint32 usecs) ;
+    static void MakeOverlayText(char text[PERF_N_LINES][PERF_LINE_LEN]) ;
+
+    // helpers
+    static Uint32 NowUsecs(      void) ;
+    static void   StoreMax(      atomic<Uint32>* max , Uint32 usecs) ;
+    static Uint32 GetBucketN(    Uint32 usecs) ;
+    static Uint32 GetBucketLower(Uint32 bucketN) ;
+    static Uint32 GetBucketUpper(Uint32 bucketN) ;
+    static Uint32 GetPercentile( Histogram* histogram , Uint32 percent) ;
+} ;
+
+
+#endif // #ifndef _PERF_STATS_H_
+
+
+/* NOTE: on the performance overlay
+
+    PERF_OVERLAY_KEY toggles an overlay in the header row that is refreshed
+      every GUI_STATUS_INTERVAL - on stage this shows trouble before it is audible
+        DSP     --> jack_cpu_load() and the xrun count (jack_set_xrun_callback())
+        DSP     --> also the number of periods that exceeded the period budget
+        period  --> ProcessCallback() p50/p99/max (see note on timing histograms)
+        roll    --> the same for the rollover/loop-commit branch alone
+        GUI     --> render thread frame time percentiles over the last PERF_N_FRAME_TIMES frames
+        mem     --> record buffers plus loop buffers against free physical memory
+
+    the JACK thread only ever stores to atomics (relaxed) and reads the monotonic clock
+      so ProcessScope adds no locks or allocations to ProcessCallback()
+    the frame times are written and read only by the render thread
+*/
+
+
+/* NOTE: on timing histograms
+
+    PERF_STATS_PROCESS_SCOPE times all of ProcessCallback() into PeriodTimes
+      and PERF_STATS_ROLLOVER_SCOPE times the rollover branch (loop copy , scene change)
+      into RolloverTimes - the rare expensive periods are then not hidden by the cheap ones
+    each histogram has PERF_N_SUB_BUCKETS linear buckets per power of two
+        0 - 3 us        --> one bucket per usec
+        otherwise       --> bucketN = ((msb - 1) * 4) + (the two bits below the msb)
+      so any duration is over-reported by at most 25% and the whole Uint32 range
+      fits in PERF_N_BUCKETS fixed counters - recording is a clz and one relaxed increment
+    percentiles report the upper bound of the bucket that contains them (clamped to max)
+
+    PERF_DUMP_ARG <path> writes both histograms to <path> when Loopidity exits
+*/
@@ -0,0 +1,206 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+
+#include "pixel_ops.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#  include <emmintrin.h>
+#  define PIXEL_OPS_SSE2 1
+#else
+#  define PIXEL_OPS_SSE2 0
+#endif // #if defined(__SSE2__) || defined(_M_X64)
+
+
+/* PixelOps class side public functions */
+
+// whole surfaces
+
+bool PixelOps::Grey(SDL_Surface* src , SDL_Surface* dest)
+  { return ScaleSurface(src , dest , 0 , 0 , true) ; }
+
+bool PixelOps::Dim(SDL_Surface* src , SDL_Surface* dest , Uint16 level)
+{
+  if (level > PIXEL_OPS_ONE) level = PIXEL_OPS_ONE ;
+
+  Uint16 mul[3] = { level , level , level } ; Uint16 add[3] = { 0 , 0 , 0 } ;
+  return ScaleSurface(src , dest , mul , add , false) ;
+}
+
+bool PixelOps::Tint(SDL_Surface* src , SDL_Surface* dest , Uint32 rgb , Uint16 amount)
+{
+  if (amount > PIXEL_OPS_ONE) amount = PIXEL_OPS_ONE ;
+
+  // rgb is 0xRRGGBB regardless of the surface format
+  Uint16 inv    = PIXEL_OPS_ONE - amount ;
+  Uint16 mul[3] = { inv , inv , inv } ;
+  Uint16 add[3] = { (Uint16)(((rgb >> 16) & 0xff) * amount) ,
+                    (Uint16)(((rgb >> 8)  & 0xff) * amount) ,
+                    (Uint16)(( rgb        & 0xff) * amount) } ;
+  return ScaleSurface(src , dest , mul , add , false) ;
+}
+
+
+// pixel arrays
+
+bool PixelOps::GreyPixels(const Uint32* src , Uint32* dest , Uint32 nPixels ,
+                          const SDL_PixelFormat* fmt                     )
+{
+  PixelOpsFormat opsFmt ; if (!MakeFormat(fmt , &opsFmt)) return false ;
+
+  GreyKernel(src , dest , nPixels , &opsFmt) ; return true ;
+}
+
+
+/* PixelOps class side private functions */
+
+// helpers
+
+bool PixelOps::MakeFormat(const SDL_PixelFormat* fmt , PixelOpsFormat* opsFmt)
+{
+  if (fmt->BytesPerPixel != 4 || fmt->Rloss || fmt->Gloss || fmt->Bloss) return false ;
+
+  opsFmt->keepMask = ~(fmt->Rmask | fmt->Gmask | fmt->Bmask) ;
+  opsFmt->rShift   = fmt->Rshift ;
+  opsFmt->gShift   = fmt->Gshift ;
+  opsFmt->bShift   = fmt->Bshift ;
+
+  return true ;
+}
+
+bool PixelOps::ScaleSurface(SDL_Surface* src , SDL_Surface* dest ,
+                            const Uint16* mul , const Uint16* add , bool isGrey)
+{
+  PixelOpsFormat opsFmt ;
+  if (!src || !dest || src->w != dest->w || src->h != dest->h ||
+      src->format->BytesPerPixel != dest->format->BytesPerPixel ||
+      !MakeFormat(src->format , &opsFmt)                         )
+    return false ;
+
+  // mul and add are in r , g , b order - the kernels are format agnostic
+  SDL_LockSurface(src) ; if (dest != src) SDL_LockSurface(dest) ;
+  for (Sint32 y = 0 ; y < src->h ; ++y)
+  {
+    const Uint32* srcRow  = (const Uint32*)((Uint8*)src->pixels  + (y * src->pitch)) ;
+    Uint32*       destRow = (Uint32*)      ((Uint8*)dest->pixels + (y * dest->pitch)) ;
+    if (isGrey) GreyKernel( srcRow , destRow , src->w , &opsFmt) ;
+    else        ScaleKernel(srcRow , destRow , src->w , &opsFmt , mul , add) ;
+  }
+  if (dest != src) SDL_UnlockSurface(dest) ;
+  SDL_UnlockSurface(src) ;
+
+  return true ;
+}
+
+
+// kernels
+
+void PixelOps::GreyKernel(const Uint32* src , Uint32* dest , Uint32 nPixels ,
+                          const PixelOpsFormat* opsFmt                   )
+{
+  const Uint32 keepMask = opsFmt->keepMask ;
+  const Uint8  rShift   = opsFmt->rShift ;
+  const Uint8  gShift   = opsFmt->gShift ;
+  const Uint8  bShift   = opsFmt->bShift ;
+  Uint32       pixelN   = 0 ;
+
+#if PIXEL_OPS_SSE2
+  const __m128i channelMask = _mm_set1_epi32(0xff) ;
+  const __m128i keep        = _mm_set1_epi32(keepMask) ;
+  const __m128i lumR        = _mm_set1_epi32(PIXEL_OPS_LUM_R) ;
+  const __m128i lumG        = _mm_set1_epi32(PIXEL_OPS_LUM_G) ;
+  const __m128i lumB        = _mm_set1_epi32(PIXEL_OPS_LUM_B) ;
+  const __m128i rCount      = _mm_cvtsi32_si128(rShift) ;
+  const __m128i gCount      = _mm_cvtsi32_si128(gShift) ;
+  const __m128i bCount      = _mm_cvtsi32_si128(bShift) ;
+  for ( ; pixelN + PIXEL_OPS_N_LANES <= nPixels ; pixelN += PIXEL_OPS_N_LANES)
+  {
+    __m128i pixels = _mm_loadu_si128((const __m128i*)(src + pixelN)) ;
+    __m128i r      = _mm_and_si128(_mm_srl_epi32(pixels , rCount) , channelMask) ;
+    __m128i g      = _mm_and_si128(_mm_srl_epi32(pixels , gCount) , channelMask) ;
+    __m128i b      = _mm_and_si128(_mm_srl_epi32(pixels , bCount) , channelMask) ;
+    __m128i lum    = _mm_add_epi32(_mm_add_epi32(_mm_mullo_epi16(r , lumR) ,
+                                                 _mm_mullo_epi16(g , lumG)) ,
+                                                 _mm_mullo_epi16(b , lumB)) ;
+    lum            = _mm_srli_epi32(lum , 8) ;
+    __m128i out    = _mm_or_si128(_mm_and_si128(pixels , keep) ,
+                     _mm_or_si128(_mm_sll_epi32(lum , rCount) ,
+                     _mm_or_si128(_mm_sll_epi32(lum , gCount) , _mm_sll_epi32(lum , bCount)))) ;
+    _mm_storeu_si128((__m128i*)(dest + pixelN) , out) ;
+  }
+#endif // #if PIXEL_OPS_SSE2
+
+  for ( ; pixelN < nPixels ; ++pixelN)
+  {
+    Uint32 pixel = src[pixelN] ;
+    Uint32 lum   = ((((pixel >> rShift) & 0xff) * PIXEL_OPS_LUM_R) +
+                    (((pixel >> gShift) & 0xff) * PIXEL_OPS_LUM_G) +
+                    (((pixel >> bShift) & 0xff) * PIXEL_OPS_LUM_B)) >> 8 ;
+    dest[pixelN] = (pixel & keepMask) | (lum << rShift) | (lum << gShift) | (lum << bShift) ;
+  }
+}
+
+void PixelOps::ScaleKernel(const Uint32* src , Uint32* dest , Uint32 nPixels ,
+                           const PixelOpsFormat* opsFmt , const Uint16* mul ,
+                           const Uint16* add                                )
+{
+  const Uint32 keepMask = opsFmt->keepMask ;
+  const Uint8  rShift   = opsFmt->rShift ;
+  const Uint8  gShift   = opsFmt->gShift ;
+  const Uint8  bShift   = opsFmt->bShift ;
+  Uint32       pixelN   = 0 ;
+
+#if PIXEL_OPS_SSE2
+  const __m128i channelMask = _mm_set1_epi32(0xff) ;
+  const __m128i keep        = _mm_set1_epi32(keepMask) ;
+  const __m128i rMul        = _mm_set1_epi32(mul[0]) ;
+  const __m128i gMul        = _mm_set1_epi32(mul[1]) ;
+  const __m128i bMul        = _mm_set1_epi32(mul[2]) ;
+  const __m128i rAdd        = _mm_set1_epi32(add[0]) ;
+  const __m128i gAdd        = _mm_set1_epi32(add[1]) ;
+  const __m128i bAdd        = _mm_set1_epi32(add[2]) ;
+  const __m128i rCount      = _mm_cvtsi32_si128(rShift) ;
+  const __m128i gCount      = _mm_cvtsi32_si128(gShift) ;
+  const __m128i bCount      = _mm_cvtsi32_si128(bShift) ;
+  for ( ; pixelN + PIXEL_OPS_N_LANES <= nPixels ; pixelN += PIXEL_OPS_N_LANES)
+  {
+    __m128i pixels = _mm_loadu_si128((const __m128i*)(src + pixelN)) ;
+    __m128i r      = _mm_and_si128(_mm_srl_epi32(pixels , rCount) , channelMask) ;
+    __m128i g      = _mm_and_si128(_mm_srl_epi32(pixels , gCount) , channelMask) ;
+    __m128i b      = _mm_and_si128(_mm_srl_epi32(pixels , bCount) , channelMask) ;
+    r              = _mm_srli_epi32(_mm_add_epi32(_mm_mullo_epi16(r , rMul) , rAdd) , 8) ;
+    g              = _mm_srli_epi32(_mm_add_epi32(_mm_mullo_epi16(g , gMul) , gAdd) , 8) ;
+    b              = _mm_srli_epi32(_mm_add_epi32(_mm_mullo_epi16(b , bMul) , bAdd) , 8) ;
+    __m128i out    = _mm_or_si128(_mm_and_si128(pixels , keep) ,
+                     _mm_or_si128(_mm_sll_epi32(r , rCount) ,
+                     _mm_or_si128(_mm_sll_epi32(g , gCount) , _mm_sll_epi32(b , bCount)))) ;
+    _mm_storeu_si128((__m128i*)(dest + pixelN) , out) ;
+  }
+#endif // #if PIXEL_OPS_SSE2
+
+  for ( ; pixelN < nPixels ; ++pixelN)
+  {
+    Uint32 pixel = src[pixelN] ;
+    Uint32 r     = ((((pixel >> rShift) & 0xff) * mul[0]) + add[0]) >> 8 ;
+    Uint32 g     = ((((pixel >> gShift) & 0xff) * mul[1]) + add[1]) >> 8 ;
+    Uint32 b     = ((((pixel >> bShift) & 0xff) * mul[2]) + add[2]) >> 8 ;
+    dest[pixelN] = (pixel & keepMask) | (r << rShift) | (g << gShift) | (b << bShift) ;
+  }
+}
@@ -0,0 +1,100 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+
+#ifndef _PIXEL_OPS_H_
+#define _PIXEL_OPS_H_
+
+
+#include "loopidity.h"
+
+
+// fixed-point weights (8 fractional bits)
+#define PIXEL_OPS_ONE      256
+#define PIXEL_OPS_LUM_R    77  // 0.30
+#define PIXEL_OPS_LUM_G    151 // 0.59
+#define PIXEL_OPS_LUM_B    28  // 0.11
+#define PIXEL_OPS_N_LANES  4   // pixels per SSE2 register
+
+
+using namespace std ;
+
+
+typedef struct PixelOpsFormat
+{
+  Uint32 keepMask ; // bits that pass through unchanged (alpha and padding)
+  Uint8  rShift ;
+  Uint8  gShift ;
+  Uint8  bShift ;
+} PixelOpsFormat ;
+
+
+class PixelOps
+{
+  public:
+
+    /* PixelOps class side public functions */
+
+    // whole surfaces - src and dest must have the same dimensions and format (may be the same surface)
+    static bool Grey(SDL_Surface* src , SDL_Surface* dest) ;
+    static bool Dim( SDL_Surface* src , SDL_Surface* dest , Uint16 level) ;
+    static bool Tint(SDL_Surface* src , SDL_Surface* dest , Uint32 rgb , Uint16 amount) ;
+
+    // pixel arrays
+    static bool GreyPixels(const Uint32* src , Uint32* dest , Uint32 nPixels ,
+                           const SDL_PixelFormat* fmt                     ) ;
+
+
+  private:
+
+    /* PixelOps class side private functions */
+
+    // helpers
+    static bool MakeFormat(     const SDL_PixelFormat* fmt , PixelOpsFormat* opsFmt) ;
+    static bool ScaleSurface(   SDL_Surface* src , SDL_Surface* dest ,
+                                const Uint16* mul , const Uint16* add , bool isGrey) ;
+
+    // kernels
+    static void GreyKernel(const Uint32* src , Uint32* dest , Uint32 nPixels ,
+                           const PixelOpsFormat* opsFmt                   ) ;
+    static void ScaleKernel(const Uint32* src , Uint32* dest , Uint32 nPixels ,
+                            const PixelOpsFormat* opsFmt , const Uint16* mul ,
+                            const Uint16* add                                ) ;
+} ;
+
+
+#endif // #ifndef _PIXEL_OPS_H_
+
+
+/* NOTE: on pixel ops
+
+    bulk colour transforms for 32 bit surfaces with 8 bit channels in any channel order
+
+    Grey()  --> lum = (r * 77 + g * 151 + b * 28) >> 8 into every channel
+    Dim()   --> c   = (c * level) >> 8                        (level 256 is unchanged)
+    Tint()  --> c   = (c * (256 - amount) + t * amount) >> 8 (amount 256 is solid rgb)
+
+    channel positions are taken from the SDL_PixelFormat once per call
+      bits outside of the r , g , b masks (alpha or padding) are passed through
+    the kernels process PIXEL_OPS_N_LANES pixels at a time with SSE2 where available
+      every intermediate fits 16 bits so the scalar and SSE2 paths are bit-identical
+
+    formats that are not 32 bit with 8 bit channels are rejected (false is returned)
+*/
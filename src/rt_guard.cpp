@@ -0,0 +1,156 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+#include "rt_guard.h"
+
+#if defined(__SSE__) || defined(_M_X64)
+#  include <xmmintrin.h>         // FlushDenormals()
+#endif // #if defined(__SSE__) || defined(_M_X64)
+#ifndef _WIN32
+#  include <sys/mman.h>          // LockMemory()
+#  if RT_ALLOC_GUARD
+#    include <dlfcn.h>           // Init()
+#    include <execinfo.h>        // Report()
+#    include <pthread.h>         // pthread_mutex_lock()
+#  endif // #if RT_ALLOC_GUARD
+#endif // _WIN32
+
+
+#if RT_ALLOC_GUARD
+/* interposed allocator and mutex entry points */
+
+extern "C" void* __libc_malloc(       size_t nBytes) ;
+extern "C" void* __libc_calloc(       size_t nMembers , size_t nBytes) ;
+extern "C" void* __libc_realloc(      void* ptr , size_t nBytes) ;
+extern "C" void  __libc_free(         void* ptr) ;
+
+// glibc >= 2.34 no longer links __pthread_mutex_lock so the real lock is looked up by name
+typedef int (*MutexLockFunction)(pthread_mutex_t* mutex) ;
+static MutexLockFunction RealMutexLock = 0 ; // RtGuard::Init()
+
+static MutexLockFunction FindMutexLock()
+  { return (MutexLockFunction)dlsym(RTLD_NEXT , "pthread_mutex_lock") ; }
+
+static thread_local bool IsProcessThread = false ; // ProcessScope
+static thread_local bool IsReporting     = false ; // Report()
+
+extern "C" void* malloc(size_t nBytes)
+  { if (IsProcessThread) RtGuard::Report("malloc") ; return __libc_malloc(nBytes) ; }
+
+extern "C" void* calloc(size_t nMembers , size_t nBytes)
+  { if (IsProcessThread) RtGuard::Report("calloc") ; return __libc_calloc(nMembers , nBytes) ; }
+
+extern "C" void* realloc(void* ptr , size_t nBytes)
+  { if (IsProcessThread) RtGuard::Report("realloc") ; return __libc_realloc(ptr , nBytes) ; }
+
+extern "C" void free(void* ptr)
+  { if (IsProcessThread && ptr) RtGuard::Report("free") ; __libc_free(ptr) ; }
+
+extern "C" int pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+  if (IsProcessThread) RtGuard::Report("pthread_mutex_lock") ;
+
+  // locks taken by static initializers before RtGuard::Init() look it up themselves
+  return ((RealMutexLock)? RealMutexLock : FindMutexLock())(mutex) ;
+}
+#endif // #if RT_ALLOC_GUARD
+
+
+/* RtGuard class side public functions */
+
+// setup
+
+void RtGuard::Init()
+{
+#if RT_ALLOC_GUARD
+  // the first backtrace() loads libgcc and allocates - get that out of the way now
+  void* frames[RT_GUARD_N_FRAMES] ; backtrace(frames , RT_GUARD_N_FRAMES) ;
+
+  // dlsym() may allocate and lock so resolve the real pthread_mutex_lock() once up front
+  RealMutexLock = FindMutexLock() ;
+#endif // #if RT_ALLOC_GUARD
+}
+
+bool RtGuard::LockMemory()
+{
+#ifdef _WIN32
+  return false ;
+#else // _WIN32
+  return !mlockall(MCL_CURRENT | MCL_FUTURE) ;
+#endif // _WIN32
+}
+
+void RtGuard::InitRtThread() { FlushDenormals() ; PrefaultStack() ; }
+
+void RtGuard::Prefault(void* buffer , size_t nBytes)
+{
+  volatile Uint8* bytes = (volatile Uint8*)buffer ;
+  for (size_t byteN = 0 ; byteN < nBytes ; byteN += RT_PAGE_SIZE) bytes[byteN] = bytes[byteN] ;
+  if (nBytes) bytes[nBytes - 1] = bytes[nBytes - 1] ;
+}
+
+#if RT_ALLOC_GUARD
+// debug
+
+void RtGuard::Report(const char* functionName)
+{
+  if (IsReporting) return ;
+
+  // backtrace_symbols_fd() writes directly to the fd and does not allocate
+  IsReporting = true ;
+  void* frames[RT_GUARD_N_FRAMES] ; int nFrames = backtrace(frames , RT_GUARD_N_FRAMES) ;
+  char msg[128] ; int msgLen = snprintf(msg , 128 , RT_GUARD_REPORT_FMT , functionName) ;
+  if (write(STDERR_FILENO , msg , msgLen) == msgLen)
+    backtrace_symbols_fd(frames , nFrames , STDERR_FILENO) ;
+  IsReporting = false ;
+}
+
+
+/* RtGuard::ProcessScope public functions */
+
+RtGuard::ProcessScope::ProcessScope() { IsProcessThread = true ; }
+
+RtGuard::ProcessScope::~ProcessScope() { IsProcessThread = false ; }
+#endif // #if RT_ALLOC_GUARD
+
+
+/* RtGuard class side private functions */
+
+// helpers
+
+void RtGuard::FlushDenormals()
+{
+#if defined(__SSE__) || defined(_M_X64)
+  // FTZ (bit 15) and DAZ (bit 6)
+  _mm_setcsr(_mm_getcsr() | 0x8040) ;
+#elif defined(__aarch64__)
+  // FZ (bit 24)
+  Uint64 fpcr ; __asm__ __volatile__("mrs %0 , fpcr" : "=r"(fpcr)) ;
+  fpcr |= (1 << 24) ; __asm__ __volatile__("msr fpcr , %0" : : "r"(fpcr)) ;
+#endif // #if defined(__SSE__) || defined(_M_X64)
+}
+
+void RtGuard::PrefaultStack()
+{
+  volatile Uint8 stack[RT_PREFAULT_STACK_SIZE] ;
+  for (Uint32 byteN = 0 ; byteN < RT_PREFAULT_STACK_SIZE ; byteN += RT_PAGE_SIZE)
+    stack[byteN] = 0 ;
+  (void)stack ; // the writes are the point - volatile keeps them
+}
@@ -0,0 +1,101 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+#ifndef _RT_GUARD_H_
+#define _RT_GUARD_H_
+
+
+#include "loopidity.h"
+
+
+#if RT_ALLOC_GUARD
+#  define RT_GUARD_PROCESS_SCOPE RtGuard::ProcessScope rtGuardProcessScope ;
+#else
+#  define RT_GUARD_PROCESS_SCOPE ;
+#endif // #if RT_ALLOC_GUARD
+
+
+using namespace std ;
+
+
+class RtGuard
+{
+  public:
+
+    /* RtGuard class side public functions */
+
+    // setup
+    static void Init(        void) ;
+    static bool LockMemory(  void) ;
+    static void InitRtThread(void) ;
+    static void Prefault(    void* buffer , size_t nBytes) ;
+
+#if RT_ALLOC_GUARD
+    // debug
+    static void Report(const char* functionName) ;
+
+
+    /* RtGuard::ProcessScope - marks the calling thread as inside ProcessCallback() */
+
+    class ProcessScope
+    {
+      public:
+
+        ProcessScope() ;
+        ~ProcessScope() ;
+    } ;
+#endif // #if RT_ALLOC_GUARD
+
+
+  private:
+
+    /* RtGuard class side private functions */
+
+    // helpers
+    static void FlushDenormals(void) ;
+    static void PrefaultStack( void) ;
+} ;
+
+
+#endif // #ifndef _RT_GUARD_H_
+
+
+/* NOTE: on real-time hardening
+
+    denormals         -->
+        FTZ/DAZ are set on the JACK thread via jack_set_thread_init_callback()
+        the flags are per-thread so other threads keep IEEE behaviour
+    prefaulting       -->
+        the JACK thread stack is touched once in the thread init callback
+        the record buffers are touched in JackIO::InitEngine() before the backend is activated
+        loops are committed into a spare Loop touched ahead of time on the main thread
+          (see note on the spare loop in jack_io.h) - if no spare fits the commit
+          allocates on the JACK thread - this is the one known exception
+    memory locking    -->
+        LOCK_MEMORY_ARG calls mlockall() before the record buffers are allocated
+    alloc/lock guard  -->
+        if RT_ALLOC_GUARD is set malloc() , calloc() , realloc() , free()
+          and pthread_mutex_lock() are interposed - any call made while the calling thread
+          is inside ProcessCallback() is reported to stderr with a stack trace
+        this is a debug aid only - the interposers themselves are not free
+        the allocators forward to the __libc_* entry points and pthread_mutex_lock()
+          forwards to dlsym(RTLD_NEXT) (hence -ldl) as __pthread_mutex_lock is only a
+          compat symbol since glibc 2.34 - checked to build , link , and report on glibc 2.36
+*/
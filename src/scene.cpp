@@ -57,18 +57,25 @@ Uint32 Scene::RecordBufferSize   = 0 ; // SetMetadata()
 
 /* Loop class side private functions */
 
-Loop::Loop(Uint32 nFrames)
+Loop::Loop(Uint32 nFrames , Uint32 nChannels)
 {
   // audio data
-  buffer1 = new Sample[nFrames] ;
-  buffer2 = new Sample[nFrames] ;
+  for (Uint32 channelN = 0 ; channelN < nChannels ; ++channelN)
+    buffers.push_back(new Sample[nFrames]) ;
+  this->nFrames = nFrames ;
+  nBytes        = (size_t)nFrames * nChannels * sizeof(Sample) ; PerfStats::AddLoopBytes(nBytes) ;
 
   // loop state
   vol     = 1.0 ;
   isMuted = false ;
 }
 
-Loop::~Loop() { delete buffer1 ; delete buffer2 ; }
+Loop::~Loop()
+{
+  for (Uint32 channelN = 0 ; channelN < buffers.size() ; ++channelN)
+    delete [] buffers[channelN] ;
+  PerfStats::SubLoopBytes(nBytes) ;
+}
 
 
 /* Loop instantce side public functions */
@@ -276,12 +283,14 @@ DEBUG_TRACE_SCENE_RESET_OUT
 void Scene::scanPeaks(Loop* loop , Uint32 loopN)
 {
 DEBUG_TRACE_SCENE_SCANPEAKS_IN
+TRACE_SPAN(TRACE_SPAN_SCAN_PEAKS)
 
 #if SCAN_LOOP_PEAKS_DATA
   if (!loop || loopN >= Loopidity::N_LOOPS) return ;
 
   // fill fine peaks arrays
-  Sample* peaks = loop->peaksFine ; Uint32 peakN , frameN ; Sample peak1 , peak2 ;
+  Sample* peaks     = loop->peaksFine ; Uint32 peakN , frameN ;
+  Uint32  nChannels = loop->buffers.size() ;
   for (peakN = 0 ; peakN < N_FINE_PEAKS ; ++peakN)
   {
 #if SCENE_NFRAMES_EDITABLE
@@ -293,13 +302,10 @@ DEBUG_TRACE_SCENE_SCANPEAKS_IN
 #else
     frameN       = nFramesPerPeak * peakN ;
 #endif // #if SCENE_NFRAMES_EDITABLE
-    peak1        = JackIO::GetPeak(&(loop->buffer1[frameN]) , nFramesPerPeak) ;
-    peak2        = JackIO::GetPeak(&(loop->buffer2[frameN]) , nFramesPerPeak) ;
-#  if FIXED_N_AUDIO_PORTS
-    peaks[peakN] = (peak1 + peak2) / N_INPUT_CHANNELS ;
-#  else
-    peaks[peakN] = (peak1 + peak2) / N_INPUT_CHANNELS ;
-#  endif // #if FIXED_N_AUDIO_PORTS
+    peaks[peakN] = 0.0 ;
+    for (Uint32 channelN = 0 ; channelN < nChannels ; ++channelN)
+      peaks[peakN] += JackIO::GetPeak(&(loop->buffers[channelN][frameN]) , nFramesPerPeak) ;
+    peaks[peakN] /= nChannels ;
 
     // find the loudest peak for this loop
     if (hiLoopPeaks[loopN] < peaks[peakN]) hiLoopPeaks[loopN] = peaks[peakN] ;
@@ -50,6 +50,9 @@ typedef struct SceneMetadata
 
 class Loop
 {
+  friend class Bounce ;
+  friend class EngineBench ;
+  friend class GuiBench ;
   friend class JackIO ;
   friend class Loopidity ;
   friend class Scene ;
@@ -60,15 +63,16 @@ friend class SceneSdl ;
 
     /* Loop class side private funcrtions  */
 
-    Loop(Uint32 nFrames) ;
+    Loop(Uint32 nFrames , Uint32 nChannels) ;
     ~Loop() ;
 
 
     /* Loop instance side private varables */
 
     // audio data
-    Sample* buffer1 ;
-    Sample* buffer2 ;
+    vector<Sample*> buffers ; // planar - one buffer per channel
+    Uint32          nFrames ; // per channel - a spare may exceed its scene (JackIO::SpareLoop)
+    size_t          nBytes ;  // all channels - PerfStats
 
     // peaks cache
     Sample peaksFine  [N_PEAKS_FINE  ] ;
@@ -90,6 +94,9 @@ friend class SceneSdl ;
 
 class Scene
 {
+  friend class Bounce ;
+  friend class EngineBench ;
+  friend class GuiBench ;
   friend class JackIO ;
   friend class Loopidity ;
   friend class LoopiditySdl ;
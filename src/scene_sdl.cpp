@@ -25,10 +25,26 @@
 
 LoopSdl::LoopSdl(SDL_Surface* playingImg , SDL_Surface* mutedImg , Sint16 x , Sint16 y)
 {
-  // drawing backbuffers
+  // drawing backbuffers - null until LoopImager has drawn them
   playingSurface = playingImg ;
   mutedSurface   = mutedImg ;
   currentSurface = playingImg ;
+  polarN         = POLAR_PLAYING ;
+
+  // drawing coordinates
+  loopL = x ;
+  loopC = x + PEAK_RADIUS ;
+  rect  = { x , y , 0 , 0 } ;
+}
+
+LoopSdl::LoopSdl(const Uint8* peakRadii , Sint16 x , Sint16 y)
+{
+  // drawing backbuffers - unused , the ring is drawn from SceneSdl::PolarLut
+  playingSurface = mutedSurface = currentSurface = 0 ;
+
+  // polar image
+  memcpy(radii , peakRadii , N_PEAKS_FINE) ;
+  polarN = POLAR_PLAYING ;
 
   // drawing coordinates
   loopL = x ;
@@ -47,13 +63,19 @@ void LoopSdl::setStatus(Uint16 loopStatus)
 {
   switch (loopStatus)
   {
-    case STATE_LOOP_PLAYING: currentSurface = playingSurface ; break ;
-    case STATE_LOOP_PENDING: currentSurface = mutedSurface ;   break ;
-    case STATE_LOOP_MUTED:   currentSurface = mutedSurface ;   break ;
-    default:                                                   break ;
+    case STATE_LOOP_PLAYING: currentSurface = playingSurface ; polarN = POLAR_PLAYING ; break ;
+    case STATE_LOOP_PENDING: currentSurface = mutedSurface ;   polarN = POLAR_MUTED ;   break ;
+    case STATE_LOOP_MUTED:   currentSurface = mutedSurface ;   polarN = POLAR_MUTED ;   break ;
+    default:                                                                            break ;
   }
 }
 
+void LoopSdl::setSurfaces(SDL_Surface* playingImg , SDL_Surface* mutedImg)
+{
+  playingSurface = playingImg ; mutedSurface = mutedImg ;
+  currentSurface = (polarN == POLAR_PLAYING)? playingSurface : mutedSurface ;
+}
+
 
 /* SceneSdl class side private constants */
 
@@ -81,13 +103,20 @@ const Uint16 SceneSdl::SceneL             = SCENE_L ;
 const Uint16 SceneSdl::SceneR             = SCENE_R ;
 const Uint16 SceneSdl::SceneFrameL        = SCENE_FRAME_L ;
 const Uint16 SceneSdl::SceneFrameR        = SCENE_FRAME_R ;
-const float  SceneSdl::PieSliceDegrees    = PIE_SLICE_DEGREES ;
+const SDL_Rect SceneSdl::DynamicRect      = SCENE_DYNAMIC_RECT ;
 const Uint8  SceneSdl::BytesPerPixel      = PIXEL_DEPTH / 8 ;
 const Uint16 SceneSdl::SECONDS_PER_HOUR   = N_SECONDS_PER_HOUR ;
 const Uint8  SceneSdl::MINUTES_PER_HOUR   = N_MINUTES_PER_HOUR ;
 const Uint8  SceneSdl::SECONDS_PER_MINUTE = N_SECONDS_PER_MINUTE ;
 
 
+/* SceneSdl class side private varables */
+
+// loop ring LUTs
+PolarPixel SceneSdl::PolarLut[LOOP_DIAMETER][LOOP_DIAMETER] ;                      // InitPolarLut()
+Uint32     SceneSdl::PolarGradients[N_POLAR_IMAGES][N_PEAKS_FINE][PEAK_RADIUS + 1] ; // InitPolarLut()
+
+
 /* SceneSdl class side private functions */
 
 SceneSdl::SceneSdl(Scene* aScene) :
@@ -104,13 +133,15 @@ SceneSdl::SceneSdl(Scene* aScene) :
   // drawScene() instance variables
   loopFrameColor  = STATE_IDLE_COLOR ;
   sceneFrameColor = (!sceneN)? STATE_PLAYING_COLOR : STATE_IDLE_COLOR ;
+  isDirty         = true ;
+
+  // status text cache
+  durationSeconds = 0 ;
 
   // drawScene() , drawHistogram() , and drawRecordingLoop() 'local' variables
   currentPeakN  = 0 ;
   hiScenePeak   = 0 ;
   loopN         = 0 ;
-  histPeakN     = 0 ;
-  peakH         = 0 ;
   loopL         = 0 ;
   loopC         = 0 ;
   histFrameL    = 0 ;
@@ -121,13 +152,9 @@ SceneSdl::SceneSdl(Scene* aScene) :
   scopeMaskRect = SCOPE_MASK_RECT ;
   scopeGradRect = SCOPE_GRADIENT_RECT ;
   histogramRect = HISTOGRAM_RECT ;
-  histMaskRect  = HISTOGRAM_MASK_RECT ;
-  histGradRect  = HISTOGRAM_GRADIENT_RECT ;
-  rotRect       = ROT_LOOP_IMG_RECT ;
   histogramImg  = NULL ;
   loopImg       = NULL ;
   loop          = NULL ;
-  rotImg        = NULL ;
 
   // drawing backbuffers
   sceneRect.x = 0 ;
@@ -142,13 +169,42 @@ SceneSdl::SceneSdl(Scene* aScene) :
   drawScene(inactiveSceneSurface , 0 , 0) ;
 }
 
+bool SceneSdl::InitPolarLut(SDL_Surface* loopGradient , SDL_PixelFormat* fmt)
+{
+  SDL_Surface* gradient = SDL_ConvertSurface(loopGradient , fmt , SDL_SWSURFACE) ;
+  if (!gradient) return false ;
+
+  // angle bin and radius of each pixel - bins run clockwise from 12 o'clock
+  for (Sint16 y = 0 ; y < LoopD ; ++y) for (Sint16 x = 0 ; x < LoopD ; ++x)
+  {
+    Sint16 dx     = x - PEAK_RADIUS ; Sint16 dy = y - PEAK_RADIUS ;
+    float  radius = sqrt((float)((dx * dx) + (dy * dy))) ;
+    float  angle  = atan2((float)dx , (float)-dy) ; if (angle < 0.0) angle += 2.0 * M_PI ;
+    Uint16 peakN  = (Uint16)(angle / PIE_SLICE_RADIANS) % N_PEAKS_FINE ;
+    Uint16 r      = (Uint16)(radius + 0.5) ;
+
+    PolarLut[y][x].peakN  = peakN ;
+    PolarLut[y][x].radius = (r <= PEAK_RADIUS)? r : POLAR_OUTSIDE ;
+  }
 
-// helpers
+  // loop gradient resampled along the centre line of each bin
+  SDL_LockSurface(gradient) ;
+  for (Uint16 peakN = 0 ; peakN < N_PEAKS_FINE ; ++peakN)
+  {
+    float angle = (peakN + 0.5) * PIE_SLICE_RADIANS ;
+    for (Uint16 r = 0 ; r <= PEAK_RADIUS ; ++r)
+    {
+      Sint16 x       = PEAK_RADIUS + (Sint16)floor((r * sin(angle)) + 0.5) ;
+      Sint16 y       = PEAK_RADIUS - (Sint16)floor((r * cos(angle)) + 0.5) ;
+      PolarGradients[POLAR_PLAYING][peakN][r] =
+          *(Uint32*)((Uint8*)gradient->pixels + (y * gradient->pitch) + (x * BytesPerPixel)) ;
+    }
+  }
+  SDL_UnlockSurface(gradient) ; SDL_FreeSurface(gradient) ;
 
-void SceneSdl::PixelRgb2Greyscale(SDL_PixelFormat* fmt , Uint32* pixel)
-{
-  Uint8 r , g , b , lum ; SDL_GetRGB(*pixel , fmt , &r , &g , &b) ;
-  lum = (r * 0.3) + (g * 0.59) + (b * 0.11) ; *pixel = SDL_MapRGB(fmt , lum , lum , lum) ;
+  // muted gradients - the playing gradients are contiguous so this is a single pass
+  return PixelOps::GreyPixels(PolarGradients[POLAR_PLAYING][0] , PolarGradients[POLAR_MUTED][0] ,
+                              N_PEAKS_FINE * (PEAK_RADIUS + 1) , fmt                           ) ;
 }
 
 
@@ -157,6 +213,20 @@ void SceneSdl::PixelRgb2Greyscale(SDL_PixelFormat* fmt , Uint32* pixel)
 Sint16 SceneSdl::GetLoopL(Uint16 loopN) { return LoopsL + (LoopW * loopN) ; }
 
 
+// helpers
+
+void SceneSdl::MakeRadii(Loop* aLoop , Uint8* radii)
+{
+  // the ring shows what is heard - peaks are scaled by the loop volume
+  float scale = aLoop->vol * (float)PEAK_RADIUS ;
+  for (Uint16 peakN = 0 ; peakN < N_PEAKS_FINE ; ++peakN)
+  {
+    float radius = aLoop->getPeakFine(peakN) * scale ;
+    radii[peakN] = (radius < (float)PEAK_RADIUS)? (Uint8)radius : PEAK_RADIUS ;
+  }
+}
+
+
 /* SceneSdl instance side private functions */
 
 // setup
@@ -165,7 +235,7 @@ void SceneSdl::reset()
 {
   HistogramsT    = HistogramsB     = Histogram0 ;
   loopFrameColor = sceneFrameColor = STATE_IDLE_COLOR ;
-  histogramImgs.clear() ; loopImgs.clear() ;
+  LoopImager::Cancel(this , 0) ; histogramImgs.clear() ; loopImgs.clear() ; isDirty = true ;
 }
 
 void SceneSdl::cleanup() { SDL_FreeSurface(activeSceneSurface) ; SDL_FreeSurface(inactiveSceneSurface) ; }
@@ -195,6 +265,7 @@ DEBUG_TRACE_SCENESDL_UPDATESTATUS_IN
   }
 
   if (isCurrentScene) LoopiditySdl::SetStatusL(makeDurationStatusText()) ;
+  isDirty = true ;
 
 DRAW_DEBUG_TEXT_R
 DEBUG_TRACE_SCENESDL_UPDATESTATUS_OUT
@@ -213,13 +284,14 @@ LoopSdl* SceneSdl::getLoopView(list<LoopSdl*>* imgs , Uint32 loopN)
 
 void SceneSdl::drawScene(SDL_Surface* surface , Uint32 currentPeakN , Uint16 sceneProgress)
 {
+TRACE_SPAN(TRACE_SPAN_DRAW_SCENE)
+
 // TODO: perhaps scene scope could/should be output mix (is hiScenePeak now)
 //		(e.g) hiScenePeaks[] is static so scenescope does not reflect loop->vol or loop->isMuted
 // TODO: perhaps draw full width histogram/progress mixing all loops in this sceneN
 // TODO: for better scene scope responsiveness we could add another peaks cache with N_PEAKS_FINE/guiInterval samples granularity (e.g. peaksMed)
-// TODO: we could cache the rotImgs if need be but as of now she's pretty slick
 
-  SDL_FillRect(surface , 0 , LoopiditySdl::WinBgColor) ;
+  SDL_FillRect(surface , const_cast<SDL_Rect*>(&DynamicRect) , LoopiditySdl::WinBgColor) ;
 
 #if DRAW_SCENE_SCOPE
   // draw peak gradient mask
@@ -240,16 +312,18 @@ void SceneSdl::drawScene(SDL_Surface* surface , Uint32 currentPeakN , Uint16 sce
 #if DRAW_HISTOGRAMS
     histogramImg    = getLoopView(&histogramImgs , loopN) ;
     histogramRect.x = histogramImg->loopL - 1 ;
-    SDL_BlitSurface(histogramImg->currentSurface , 0 , surface , &histogramRect) ;
+    if (histogramImg->currentSurface)
+      SDL_BlitSurface(histogramImg->currentSurface , 0 , surface , &histogramRect) ;
+    else // placeholder - LoopImager has not yet drawn it
+      drawFrame(surface , histogramRect.x , HistFramesT , histogramRect.x + HistFrameR ,
+                HistFramesT + HistFrameB , STATE_PENDING_COLOR) ;
     vlineColor(surface , histogramImg->loopL + sceneProgress , HistogramsT , HistogramsB , PEAK_CURRENT_COLOR) ;
 #endif // #if DRAW_HISTOGRAMS
 
 #if DRAW_LOOPS
     // draw cached loop image
     loopImg = getLoopView(&loopImgs , loopN) ;
-    rotImg  = rotozoomSurface(loopImg->currentSurface , currentPeakN * PieSliceDegrees , 1.0 , 0) ;
-    rotRect = {(Sint16)(loopImg->loopC - (rotImg->w / 2)) , (Sint16)(Loops0 - (rotImg->h / 2)) , 0 , 0} ;
-    SDL_BlitSurface(rotImg , 0 , surface , &rotRect) ; SDL_FreeSurface(rotImg) ;
+    drawLoopRing(surface , loopImg , currentPeakN) ;
 #endif // #if DRAW_LOOPS
 
 #if DRAW_PEAK_RINGS
@@ -287,7 +361,7 @@ void SceneSdl::drawSceneStateIndicator(SDL_Surface* aSurface)
   drawFrame(aSurface , SceneFrameL , sceneFrameT , SceneFrameR , sceneFrameB , sceneFrameColor) ;
 
 //if (scene->sceneN == Loopidity::GetNextSceneN() && sceneFrameColor == STATE_PLAYING_COLOR)
-  if (scene->sceneN != Loopidity::GetNextSceneN()) return ;
+  if (scene->sceneN != LoopiditySdl::NextSceneN) return ; // render thread ViewState
 
 // TODO: drawing nextScene indicator outside of scene frame
 //          (instead of drawing frame different color if nextScene)
@@ -305,89 +379,83 @@ const Uint16 ToggleFrameR     = SceneFrameR + 4 ;
 void SceneSdl::drawFrame(SDL_Surface* aSurface , Uint16 l , Uint16 t , Uint16 r , Uint16 b , Uint32 color)
   { roundedRectangleColor(aSurface , l , t , r , b , 5 , color) ; }
 
-LoopSdl* SceneSdl::drawHistogram(Loop* aLoop)
+void SceneSdl::drawLoopRing(SDL_Surface* aSurface , LoopSdl* aLoopImg , Uint32 currentPeakN)
 {
-#if DRAW_HISTOGRAMS
-  SDL_Surface* HistogramGradient = LoopiditySdl::HistogramGradient ;
-  SDL_Surface* playingSurface    = createSwSurface(HistSurfaceW , HistSurfaceH) ;
-  SDL_Surface* mutedSurface      = createSwSurface(HistSurfaceW , HistSurfaceH) ;
+  const Uint8*  radii     = aLoopImg->radii ;
+  const Uint32* gradients = PolarGradients[aLoopImg->polarN][0] ;
+  Sint16        ringL     = aLoopImg->loopC - PEAK_RADIUS ;
+  Sint16        ringT     = Loops0          - PEAK_RADIUS ;
 
-  // draw histogram border
-  drawFrame(playingSurface , 0 , 0 , HistFrameR , HistFrameB , STATE_PLAYING_COLOR) ;
+  // scene surfaces are always PIXEL_DEPTH (see note on gradient columns in loopidity_sdl.h)
+  if (aSurface->format->BytesPerPixel != 4) return ;
 
-  // draw histogram
-  for (histPeakN = 0 ; histPeakN < N_PEAKS_COURSE ; ++histPeakN)
+  // the ring at angle bin peakN shows loop peak (peakN + currentPeakN)
+  SDL_LockSurface(aSurface) ;
+  for (Uint16 y = 0 ; y < LoopD ; ++y)
   {
-    peakH          = aLoop->getPeakCourse(histPeakN) * HistPeakH ;
-    histMaskRect.y = Histogram0 - peakH ;             histMaskRect.h = (peakH * 2) + 1 ;
-    histMaskRect.x = histGradRect.x = 1 + histPeakN ; histGradRect.y = histMaskRect.y ;
-    SDL_BlitSurface(HistogramGradient , &histMaskRect , playingSurface , &histGradRect) ;
+    Uint32*           destRow = (Uint32*)((Uint8*)aSurface->pixels + ((ringT + y) * aSurface->pitch)) + ringL ;
+    const PolarPixel* lutRow  = PolarLut[y] ;
+    for (Uint16 x = 0 ; x < LoopD ; ++x)
+    {
+      Uint8 r = lutRow[x].radius ; if (r == POLAR_OUTSIDE) continue ;
+
+      Uint16 peakN = lutRow[x].peakN + currentPeakN ; if (peakN >= N_PEAKS_FINE) peakN -= N_PEAKS_FINE ;
+      if (r <= radii[peakN]) destRow[x] = gradients[(peakN * (PEAK_RADIUS + 1)) + r] ;
+    }
   }
+  SDL_UnlockSurface(aSurface) ;
+
+  // loop start marker - rotates counter-clockwise from 12 o'clock
+  float  angle = currentPeakN * PIE_SLICE_RADIANS ;
+  Sint16 x     = aLoopImg->loopC - (Sint16)floor((PEAK_RADIUS * sin(angle)) + 0.5) ;
+  Sint16 y     = Loops0          - (Sint16)floor((PEAK_RADIUS * cos(angle)) + 0.5) ;
+  lineColor(aSurface , aLoopImg->loopC , Loops0 , x , y ,
+            (aLoopImg->polarN == POLAR_PLAYING)? PEAK_CURRENT_COLOR : PEAK_MUTED_COLOR) ;
+}
 
-#if DRAW_MUTED_HISTOGRAMS
-  SDL_LockSurface(playingSurface) ; SDL_LockSurface(mutedSurface) ;
-  Uint16 nBytes ; Uint8* destPixel ; Uint32 srcPixel ;
-  for (Uint16 y = 0 ; y < HistSurfaceH ; ++y) for (Uint16 x = 0 ; x < HistSurfaceW ; ++x)
+bool SceneSdl::drawHistogram(const Sample* peaksCourse , SDL_Surface** playingImg ,
+                             SDL_Surface** mutedImg                              )
+{
+TRACE_SPAN(TRACE_SPAN_DRAW_HISTOGRAM)
+
+#if DRAW_HISTOGRAMS
+  // LoopImager thread - this must not touch any SceneSdl instance variables
+  SDL_Surface* HistogramGradient = LoopiditySdl::HistogramGradient ;
+  SDL_Surface* playingSurface    = *playingImg = createSwSurface(HistSurfaceW , HistSurfaceH) ;
+  SDL_Surface* mutedSurface      = *mutedImg   = createSwSurface(HistSurfaceW , HistSurfaceH) ;
+  if (!playingSurface || !mutedSurface) return false ;
+
+  // draw histogram - the gradient has the same geometry as the histogram image
+  Sint16 heights[N_PEAKS_COURSE] ; Uint16 maxH = (Uint16)HistPeakH ;
+  for (Uint16 histPeakN = 0 ; histPeakN < N_PEAKS_COURSE ; ++histPeakN)
   {
-    nBytes    = x * BytesPerPixel ;
-    destPixel =            (Uint8*)mutedSurface->pixels   + (y * mutedSurface->pitch)   + nBytes ;
-    srcPixel  = *(Uint32*)((Uint8*)playingSurface->pixels + (y * playingSurface->pitch) + nBytes) ;
-    PixelRgb2Greyscale(playingSurface->format , &srcPixel) ;
-    *(Uint32*)destPixel = srcPixel ;
+    Uint16 peakH       = peaksCourse[histPeakN] * HistPeakH ;
+    heights[histPeakN] = (peakH < maxH)? peakH : maxH ;
   }
-  SDL_UnlockSurface(playingSurface) ; SDL_UnlockSurface(mutedSurface) ;
+  LoopiditySdl::DrawGradientColumns(playingSurface , 1 , Histogram0 , maxH , heights , N_PEAKS_COURSE ,
+                                    HistogramGradient , 1 , Histogram0 , false , 0) ;
+
+  // draw histogram border (after the columns which also write the background inside it)
+  drawFrame(playingSurface , 0 , 0 , HistFrameR , HistFrameB , STATE_PLAYING_COLOR) ;
+
+#if DRAW_MUTED_HISTOGRAMS
+  if (!PixelOps::Grey(playingSurface , mutedSurface)) return false ;
 #endif // #if DRAW_MUTED_HISTOGRAMS
 
-  return new LoopSdl(playingSurface , mutedSurface , GetLoopL(loopN) , LoopsT) ;
 #endif // #if DRAW_HISTOGRAMS
+
+  return true ;
 }
 
 LoopSdl* SceneSdl::drawLoop(Loop* aLoop , Uint16 loopN)
 {
-#if DRAW_LOOPS
-  SDL_Surface* loopBgGradient = LoopiditySdl::LoopGradient ;
-  SDL_Surface* playingSurface = SDL_DisplayFormat(loopBgGradient) ;
-  SDL_Surface* mutedSurface   = SDL_DisplayFormat(loopBgGradient) ;
-  SDL_SetColorKey(loopBgGradient , SDL_SRCCOLORKEY , LOOP_IMG_MASK_COLOR) ;
-  SDL_SetAlpha(playingSurface    , SDL_SRCALPHA    , 255) ;
-  SDL_SetAlpha(mutedSurface      , SDL_SRCALPHA    , 255) ;
-
-  // draw loop mask
-  SDL_Surface* maskSurface = createSwSurface(LoopD , LoopD) ;
-  for (Uint16 peakN = 0 ; peakN < N_PEAKS_FINE ; ++peakN)
-  {
-    Uint16 radius = (Uint16)(aLoop->getPeakFine(peakN) * (float)PEAK_RADIUS) ;
-    Sint16 begin  = PIE_12_OCLOCK + (PieSliceDegrees * peakN) ;
-    Sint16 end    = begin + PieSliceDegrees ;
-    filledPieColor(maskSurface , PEAK_RADIUS , PEAK_RADIUS , radius , begin , end , LOOP_IMG_MASK_COLOR) ;
-  }
+TRACE_SPAN(TRACE_SPAN_DRAW_LOOP)
 
-  // mask loop gradient image
-  SDL_LockSurface(loopBgGradient) ; SDL_LockSurface(maskSurface) ;
-  SDL_LockSurface(playingSurface) ; SDL_LockSurface(mutedSurface) ;
-  Uint16 nBytes ; Uint32 srcPixel , maskPixel ; Uint8 *playingDestPixel , *mutedDestPixel ;
-  for (Uint16 y = 0 ; y < LoopD ; ++y) for (Uint16 x = 0 ; x < LoopD ; ++x)
-  {
-    nBytes = x * BytesPerPixel ;
-    playingDestPixel = (Uint8*)playingSurface->pixels + (y * playingSurface->pitch) + nBytes ;
-    mutedDestPixel = (Uint8*)mutedSurface->pixels + (y * mutedSurface->pitch) + nBytes ;
-    if (x == PEAK_RADIUS && y < PEAK_RADIUS) { srcPixel = PEAK_CURRENT_COLOR ; maskPixel = true ; }
-    else
-    {
-      maskPixel = *(Uint32*)((Uint8*)maskSurface->pixels + (y * maskSurface->pitch) + nBytes) ;
-      srcPixel = (maskPixel)?
-          *(Uint32*)((Uint8*)loopBgGradient->pixels + (y * loopBgGradient->pitch) + nBytes) :
-          playingSurface->format->colorkey ;
-    }
-    *(Uint32*)playingDestPixel = srcPixel ;
-    if (maskPixel) PixelRgb2Greyscale(playingSurface->format , &srcPixel) ;
-    *(Uint32*)mutedDestPixel = srcPixel ;
-  }
-  SDL_UnlockSurface(maskSurface)    ; SDL_FreeSurface(maskSurface) ;
-  SDL_UnlockSurface(playingSurface) ; SDL_UnlockSurface(mutedSurface) ;
-  SDL_UnlockSurface(loopBgGradient) ;
+#if DRAW_LOOPS
+  // the ring itself is drawn per frame from PolarLut - only the peak lengths are cached
+  Uint8 radii[N_PEAKS_FINE] ; MakeRadii(aLoop , radii) ;
 
-  return new LoopSdl(playingSurface , mutedSurface , GetLoopL(loopN) , LoopsT) ;
+  return new LoopSdl(radii , GetLoopL(loopN) , LoopsT) ;
 #endif // #if DRAW_LOOPS
 }
 
@@ -401,7 +469,9 @@ DEBUG_TRACE_SCENESDL_ADDLOOP_IN
   if (loopImgs.size() != scene->loops.size() - 1) return ;
 
 #if DRAW_HISTOGRAMS
-  histogramImgs.push_back(drawHistogram(newLoop)) ;
+  // the histogram surfaces are drawn on the LoopImager thread (see note in loop_imager.h)
+  LoopSdl* placeholderImg = new LoopSdl(0 , 0 , GetLoopL(loopN) , LoopsT) ;
+  histogramImgs.push_back(placeholderImg) ; LoopImager::Enqueue(this , placeholderImg , newLoop) ;
 #endif // #if DRAW_HISTOGRAMS
 
 #if DRAW_LOOPS
@@ -411,6 +481,16 @@ DEBUG_TRACE_SCENESDL_ADDLOOP_IN
 DEBUG_TRACE_SCENESDL_ADDLOOP_OUT
 }
 
+void SceneSdl::updateLoopRadii(Uint16 loopN)
+{
+#if DRAW_LOOPS
+  LoopSdl* aLoopImg = getLoopView(&loopImgs , loopN) ; Loop* aLoop = scene->getLoop(loopN) ;
+  if (!aLoopImg || !aLoop) return ;
+
+  MakeRadii(aLoop , aLoopImg->radii) ; isDirty = true ;
+#endif // #if DRAW_LOOPS
+}
+
 void SceneSdl::deleteLoop(Uint8 loopN)
 {
 DEBUG_TRACE_SCENESDL_DELETELOOP_IN
@@ -420,8 +500,10 @@ DEBUG_TRACE_SCENESDL_DELETELOOP_IN
   list<LoopSdl*>::iterator histogramImgIter = histogramImgs.begin() ;
   list<LoopSdl*>::iterator loopImgIter      = loopImgs.begin() ;
   while (loopN--)             { ++histogramImgIter ; ++loopImgIter ; }
-  if (!histogramImgs.empty()) histogramImgs.erase(histogramImgIter) ;
+  if (!histogramImgs.empty())
+    { LoopImager::Cancel(this , *histogramImgIter) ; histogramImgs.erase(histogramImgIter) ; }
   if (!loopImgs.empty())      loopImgs.erase(loopImgIter) ;
+  isDirty = true ;
 
 DEBUG_TRACE_SCENESDL_DELETELOOP_OUT
 }
@@ -434,13 +516,17 @@ SDL_Surface* SceneSdl::createHwSurface(Sint16 w , Sint16 h)
 SDL_Surface* SceneSdl::createSwSurface(Sint16 w , Sint16 h)
   { return SDL_CreateRGBSurface(SDL_SWSURFACE , w , h , PIXEL_DEPTH , 0 , 0 , 0 , 0) ; }
 
-string SceneSdl::makeDurationStatusText()
+const string& SceneSdl::makeDurationStatusText()
 {
-  Uint32 nSeconds = scene->getTotalSeconds() ; char statusText[32] ;
+  // memoized - the text changes at most once per second
+  Uint32 nSeconds = scene->getTotalSeconds() ;
+  if (nSeconds == durationSeconds && !durationText.empty()) return durationText ;
+
+  char statusText[32] ; durationSeconds = nSeconds ;
   snprintf(statusText , 32 , "Scene: %d - %d:%02d:%02d" , sceneN ,
           ( nSeconds / SECONDS_PER_HOUR) ,
           ((nSeconds / SECONDS_PER_MINUTE) % MINUTES_PER_HOUR) ,
           ( nSeconds % SECONDS_PER_MINUTE)) ;
 
-  return string(statusText) ;
+  durationText = statusText ; return durationText ;
 }
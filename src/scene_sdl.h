@@ -58,11 +58,9 @@
 #define SCOPE_MASK_RECT         { 0 , 0 , SCENE_W , 0 }
 #define SCOPE_GRADIENT_RECT     { SCENE_L , 0 , 0 , 0 }
 #define HISTOGRAM_RECT          { 0 , HISTOGRAM_FRAMES_T , 0 , 0 }
-#define HISTOGRAM_MASK_RECT     { 0 , 0 , 1 , 0 }
-#define HISTOGRAM_GRADIENT_RECT { 0 , 0 , 0 , 0 }
-#define ROT_LOOP_IMG_RECT       { 0 , 0 , 0 , 0 }
-#define PIE_SLICE_DEGREES       (360.0 / (float)N_PEAKS_FINE)
-#define PIE_12_OCLOCK           -90
+#define SCENE_DYNAMIC_RECT      { (Sint16)SCENE_L , (Sint16)LOOP_FRAMES_T , SCENE_W , LOOP_FRAMES_B - LOOP_FRAMES_T + 1 }
+#define PIE_SLICE_RADIANS       ((2.0 * M_PI) / (float)N_PEAKS_FINE)
+#define POLAR_OUTSIDE           0xff // PolarPixel.radius beyond PEAK_RADIUS
 #define N_SECONDS_PER_HOUR      3600
 #define N_MINUTES_PER_HOUR      60
 #define N_SECONDS_PER_MINUTE    60
@@ -75,15 +73,20 @@
 #define STATE_PLAYING_COLOR   0x00ff00ff
 #define STATE_IDLE_COLOR      0x808080ff
 #define PEAK_CURRENT_COLOR    0xffff00ff
+#define PEAK_MUTED_COLOR      0xe2e2e2ff // greyscale PEAK_CURRENT_COLOR
 #define HISTOGRAM_PEAK_COLOR  0x008000ff
 #define LOOP_PEAK_MAX_COLOR   0x800000ff
-#define LOOP_IMG_MASK_COLOR   0xffffffff
 
 // loop states
 #define STATE_LOOP_PLAYING 1
 #define STATE_LOOP_PENDING 2
 #define STATE_LOOP_MUTED   3
 
+// polar gradients
+#define POLAR_PLAYING   0
+#define POLAR_MUTED     1
+#define N_POLAR_IMAGES  2
+
 
 #include "loopidity.h"
 class Loop ;
@@ -93,8 +96,17 @@ class Scene ;
 using namespace std ;
 
 
+typedef struct PolarPixel
+{
+  Uint16 peakN ;  // angle bin clockwise from 12 o'clock
+  Uint8  radius ; // POLAR_OUTSIDE if outside of the loop ring
+} PolarPixel ;
+
+
 class LoopSdl
 {
+  friend class GuiBench ;
+  friend class LoopImager ;
   friend class SceneSdl ;
 
 
@@ -103,6 +115,7 @@ class LoopSdl
     /* LoopSdl class side private functions */
 
     LoopSdl(SDL_Surface* playingImg , SDL_Surface* mutedImg , Sint16 x , Sint16 y) ;
+    LoopSdl(const Uint8* peakRadii  , Sint16 x               , Sint16 y) ;
     ~LoopSdl() ;
 
 
@@ -113,6 +126,10 @@ class LoopSdl
     SDL_Surface* mutedSurface ;
     SDL_Surface* currentSurface ;
 
+    // polar image (loop rings)
+    Uint8 radii[N_PEAKS_FINE] ; // nPixels per peak
+    Uint8 polarN ;              // POLAR_PLAYING or POLAR_MUTED
+
     // drawing coordinates
     Sint16   loopL ;
     Sint16   loopC ;
@@ -121,12 +138,15 @@ class LoopSdl
     /* LoopSdl instance side private functions */
 
     // loop state
-    void setStatus(Uint16 loopStatus) ;
+    void setStatus(  Uint16 loopStatus) ;
+    void setSurfaces(SDL_Surface* playingImg , SDL_Surface* mutedImg) ;
 } ;
 
 
 class SceneSdl
 {
+  friend class GuiBench ;
+  friend class LoopImager ;
   friend class Loopidity ;
   friend class LoopiditySdl ;
   friend class Trace ;
@@ -162,23 +182,32 @@ class SceneSdl
     static const Uint16 SceneR ;
     static const Uint16 SceneFrameL ;
     static const Uint16 SceneFrameR ;
-    static const float  PieSliceDegrees ;
+    static const SDL_Rect DynamicRect ; // everything drawScene() draws is inside this rect
     static const Uint8  BytesPerPixel ;
     static const Uint16 SECONDS_PER_HOUR ;
     static const Uint8  MINUTES_PER_HOUR ;
     static const Uint8  SECONDS_PER_MINUTE ;
 
+
+    /* SceneSdl class side private varables */
+
+    // loop ring LUTs (see note on loop rings below)
+    static PolarPixel PolarLut[LOOP_DIAMETER][LOOP_DIAMETER] ;
+    static Uint32     PolarGradients[N_POLAR_IMAGES][N_PEAKS_FINE][PEAK_RADIUS + 1] ;
+
+
     /* SceneSdl class side private functions */
 
     // setup
     SceneSdl(Scene* aScene) ;
-
-    // helpers
-    static void PixelRgb2Greyscale(SDL_PixelFormat* fmt , Uint32* pixel) ;
+    static bool InitPolarLut(SDL_Surface* loopGradient , SDL_PixelFormat* fmt) ;
 
     // getters/setters
     static Sint16 GetLoopL(Uint16 loopN) ;
 
+    // helpers
+    static void MakeRadii(Loop* aLoop , Uint8* radii) ;
+
 
     /* SceneSdl instance side private constants */
 
@@ -200,16 +229,19 @@ class SceneSdl
     list<LoopSdl*> histogramImgs ;
     list<LoopSdl*> loopImgs ;
 
+    // status text cache
+    Uint32 durationSeconds ; // makeDurationStatusText()
+    string durationText ;    // makeDurationStatusText()
+
     // drawScene() instance variables
     Uint32 loopFrameColor ;
     Uint32 sceneFrameColor ;
+    bool   isDirty ;        // LoopiditySdl::DrawScenes() must blit the entire scene
 
     // drawScene() , drawHistogram() , and drawRecordingLoop() 'temp' variables
     Uint16       currentPeakN ;
     Uint16       hiScenePeak ;
     Uint16       loopN ;
-    Uint16       histPeakN ;
-    Uint16       peakH ;
     Sint16       loopL ;
     Sint16       loopC ;
     Sint16       histFrameL ;
@@ -220,13 +252,9 @@ class SceneSdl
     SDL_Rect     scopeMaskRect ;
     SDL_Rect     scopeGradRect ;
     SDL_Rect     histogramRect ;
-    SDL_Rect     rotRect ;
-    SDL_Rect     histMaskRect ;
-    SDL_Rect     histGradRect ;
     LoopSdl*     histogramImg ;
     LoopSdl*     loopImg ;
     Loop*        loop ;
-    SDL_Surface* rotImg ;
 
     // drawing backbuffers
     SDL_Surface* activeSceneSurface ;
@@ -251,18 +279,45 @@ class SceneSdl
     void     drawSceneStateIndicator(SDL_Surface* aSurface) ;
     void     drawFrame(              SDL_Surface* aSurface , Uint16 l , Uint16 t    ,
                                      Uint16       r        , Uint16 b , Uint32 color) ;
-    LoopSdl* drawHistogram(          Loop* aLoop) ;
+    void     drawLoopRing(           SDL_Surface* aSurface , LoopSdl* aLoopImg ,
+                                     Uint32 currentPeakN                       ) ;
+    bool     drawHistogram(          const Sample* peaksCourse , SDL_Surface** playingImg ,
+                                     SDL_Surface** mutedImg                              ) ;
     LoopSdl* drawLoop(               Loop* aLoop , Uint16 loopN) ;
 
     // images
-    void  addLoop(   Loop* newLoop , Uint16 nLoops) ;
-    void  deleteLoop(Uint8 loopN) ;
+    void  addLoop(        Loop* newLoop , Uint16 nLoops) ;
+    void  updateLoopRadii(Uint16 loopN) ;
+    void  deleteLoop(     Uint8 loopN) ;
 
     // helpers
     SDL_Surface*  createHwSurface(       Sint16 w , Sint16 h) ;
     SDL_Surface*  createSwSurface(       Sint16 w , Sint16 h) ;
-    string        makeDurationStatusText(void) ;
+    const string& makeDurationStatusText(void) ;
 } ;
 
 
 #endif // #ifndef _SCENE_SDL_H_
+
+
+/* NOTE: on loop rings
+
+    loop rings are drawn directly into the scene surface at the current angle
+      rather than rotating a cached image every frame
+
+    PolarLut       -->
+        maps each pixel of the LOOP_DIAMETER square to its angle bin and radius
+        built once in InitPolarLut()
+    PolarGradients -->
+        the loop gradient image (and its greyscale via PixelOps) resampled as [peakN][radius]
+        in the display format - built once in InitPolarLut()
+    LoopSdl::radii -->
+        the length in pixels of each fine peak of a loop scaled by its volume
+        built by drawLoop() and rebuilt by updateLoopRadii() when the volume changes
+
+    drawLoopRing() then reads peak (peakN + currentPeakN) for each pixel
+      so a ring costs one LUT pass with no allocation and no interpolation
+    there are no per-loop playing/muted images - LoopSdl::polarN selects the gradient
+      so a state or volume change costs N_PEAKS_FINE multiplies at most
+    PolarPixel::radius is a Uint8 so PEAK_RADIUS may grow up to 254
+*/
@@ -0,0 +1,62 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+
+#include "scope_history.h"
+
+
+/* ScopeHistory class side private constants */
+
+const Uint32 ScopeHistory::SIZE_MASK = SCOPE_HISTORY_SIZE - 1 ;
+
+
+/* ScopeHistory instance side public functions */
+
+ScopeHistory::ScopeHistory() : writeN(0) { reset() ; }
+
+
+// producer
+
+void ScopeHistory::push(Sample peak)
+{
+  Uint32 n = writeN.load(memory_order_relaxed) ;
+  peaks[n & SIZE_MASK] = peak ; writeN.store(n + 1 , memory_order_release) ;
+}
+
+void ScopeHistory::reset()
+{
+  for (Uint32 peakN = 0 ; peakN < SCOPE_HISTORY_SIZE ; ++peakN) peaks[peakN] = 0.0 ;
+}
+
+
+// consumer
+
+bool ScopeHistory::read(Sample* dest , Uint32 nPeaks) const
+{
+  if (nPeaks > SCOPE_HISTORY_SIZE / 2) return false ;
+
+  Uint32 beginN = writeN.load(memory_order_acquire) ;
+  for (Uint32 peakN = 0 ; peakN < nPeaks ; ++peakN)
+    dest[peakN] = peaks[(beginN - 1 - peakN) & SIZE_MASK] ;
+
+  // the oldest slot copied is overwritten after SCOPE_HISTORY_SIZE - nPeaks more pushes
+  atomic_thread_fence(memory_order_acquire) ;
+  return writeN.load(memory_order_relaxed) - beginN <= SCOPE_HISTORY_SIZE - nPeaks ;
+}
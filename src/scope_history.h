@@ -0,0 +1,82 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+
+#ifndef _SCOPE_HISTORY_H_
+#define _SCOPE_HISTORY_H_
+
+
+#include <atomic>
+
+#include "loopidity.h"
+
+
+#define SCOPE_HISTORY_SIZE 1024 // power of 2 - at least twice the longest read (the widest scope)
+
+
+using namespace std ;
+
+
+class ScopeHistory
+{
+  public:
+
+    /* ScopeHistory instance side public functions */
+
+    ScopeHistory() ;
+
+    // producer
+    void push( Sample peak) ;
+    void reset(void) ;
+
+    // consumer
+    bool read(Sample* dest , Uint32 nPeaks) const ;
+
+
+  private:
+
+    /* ScopeHistory class side private constants */
+
+    static const Uint32 SIZE_MASK ;
+
+
+    /* ScopeHistory instance side private varables */
+
+    Sample         peaks[SCOPE_HISTORY_SIZE] ;
+    atomic<Uint32> writeN ; // total number of pushes - the newest peak is at writeN - 1
+} ;
+
+
+#endif // #ifndef _SCOPE_HISTORY_H_
+
+
+/* NOTE: on scope history
+
+    a fixed-capacity circular buffer with a single producer and a single consumer
+
+    push()  --> writes the slot then publishes it by incrementing writeN (release)
+                O(1) - formerly pop_back() then insert(begin()) shifted the whole vector
+    read()  --> copies the newest nPeaks into dest[] (newest first) then re-reads writeN
+                if the producer has pushed far enough meanwhile to overwrite any copied slot
+                  the copy is discarded and read() returns false (the caller keeps its previous copy)
+
+    SCOPE_HISTORY_SIZE / 2 covers half of the window width (the input and output scopes
+      are side by side) so the scopes can be widened without changing this class
+*/
@@ -58,9 +58,15 @@ Uint32 Trace::SenderLen = 0 ;
 Uint32 Trace::StateLen  = 0 ;
 Uint32 Trace::DescLen   = 0 ;
 
+/* categories */
+
+atomic<Uint32> Trace::Categories(TRACE_COMPILED_CATS) ; // SetCategories()
+
 
 /* Trace class side public functions */
 
+void Trace::SetCategories(Uint32 categories) { Categories = categories & TRACE_COMPILED_CATS ; }
+
 bool Trace::SanityCheck(Uint32 sceneN)
 {
   Scene*    scene    = Loopidity::Scenes   [sceneN] ;
@@ -77,21 +83,39 @@ void Trace::Dbg(string msg) { cout << "DBG: "   << msg << endl ; }
 
 void Trace::Err(string msg) { cout << "ERROR: " << msg << endl ; }
 
-#if DEBUG_TRACE
-bool Trace::TraceEvs(Uint32 sceneN) { return ((DEBUG_TRACE_EVS) || !SanityCheck(sceneN)) ; }
-
-bool Trace::TraceIn(Uint32 sceneN)  { return ((DEBUG_TRACE_IN ) || !SanityCheck(sceneN)) ; }
-
-bool Trace::TraceOut(Uint32 sceneN) { return ((DEBUG_TRACE_OUT) || !SanityCheck(sceneN)) ; }
-#endif // #if DEBUG_TRACE
-
 bool Trace::TraceScene(const char* senderTemplate , Scene* scene)
 {
   Uint32 sceneN = scene->sceneN ; SceneSdl* sdlScene = Loopidity::SdlScenes[sceneN] ;
   char sender[EVENT_LEN] ; snprintf(sender , EVENT_LEN , senderTemplate , sceneN) ;
 
+  // walk each list once - the dump and the mvc sanity check share the counts
+  Uint32 nLoops         = scene   ->loops        .size() ;
+  Uint32 nHistogramImgs = sdlScene->histogramImgs.size() ;
+  Uint32 nLoopImgs      = sdlScene->loopImgs     .size() ;
+  bool   isEq           = (nLoops == nHistogramImgs && nLoops == nLoopImgs) ;
+
+  // binary trace (see note on the binary trace in trace_ring.h)
+  if (TraceRing::IsEnabled())
+  {
+    Uint32 flags = (Loopidity::GetIsRolling() << 0) | (scene->shouldSaveLoop << 1) |
+                   (scene->doesPulseExist     << 2)                                  ;
+    TraceRing::Write(TRACE_EVT_SCENE_STATE , sceneN , 0 , TraceRing::Intern(senderTemplate) ,
+                     flags , nLoops , nHistogramImgs , nLoopImgs) ;
+    return isEq ;
+  }
+
+  TraceSceneState(sender , Loopidity::GetIsRolling() , scene->shouldSaveLoop ,
+                  scene->doesPulseExist , nLoops , nHistogramImgs , nLoopImgs) ;
+
+  return isEq ;
+}
+
+void Trace::TraceSceneState(const char* sender , bool isRolling , bool shouldSaveLoop ,
+                            bool doesPulseExist , Uint32 nLoops , Uint32 nHistogramImgs ,
+                            Uint32 nLoopImgs                                            )
+{
   // mvc sanity checks
-  bool isEq = SanityCheck(sceneN) ;
+  bool isEq = (nLoops == nHistogramImgs && nLoops == nLoopImgs) ;
   const char *modelEvent , *modelDescFormat , *viewEvent , *viewDescFormat ;
   if (isEq)
   {
@@ -106,13 +130,11 @@ bool Trace::TraceScene(const char* senderTemplate , Scene* scene)
 
   // model state dump
   TraceState(modelEvent , sender , MODEL_STATE_FMT , modelDescFormat ,
-      Loopidity::GetIsRolling() , scene->shouldSaveLoop , scene->doesPulseExist , isEq) ;
+      isRolling , shouldSaveLoop , doesPulseExist , isEq) ;
   // view state dump
   TraceState(viewEvent , sender , VIEW_STATE_FMT , viewDescFormat ,
-      scene->loops.size() , sdlScene->histogramImgs.size() , sdlScene->loopImgs.size() , isEq) ;
+      nLoops , nHistogramImgs , nLoopImgs , isEq) ;
   cout << endl ;
-
-  return isEq ;
 }
 
 void Trace::TraceState(const char* event , const char* sender ,
@@ -120,9 +142,8 @@ void Trace::TraceState(const char* event , const char* sender ,
                        bool bool0 , bool bool1 , bool bool2 , bool isEq)
 {
 
-#if DEBUG_TRACE_CLASS && DEBUG_TRACE_IN
+if (IsTracing<TRACE_CAT_CLASS | TRACE_CAT_IN>())
 cout << "Trace::TraceState(): '" << sender << "' bool0=" << bool0 << " bool1=" << bool1 << "bool2=" << bool2 << endl ;
-#endif // #if DEBUG_TRACE_CLASS && DEBUG_TRACE_IN
 
 #if DEBUG_TRACE
 
@@ -148,11 +169,12 @@ cout << "Trace::TraceState(): '" << sender << "' bool0=" << bool0 << " bool1=" <
 
 #endif // #if DEBUG_TRACE
 
-#if DEBUG_TRACE_CLASS && DEBUG_TRACE_OUT
+if (IsTracing<TRACE_CAT_CLASS | TRACE_CAT_OUT>())
+{
 cout << "Trace::TraceState(): Event(" << strlen(Event) << ")='" << Event << "'" << endl ; // for (int i=0 ; i < strlen(Event) ; ++i) printf("Event[%d]=%c\n" , i , Event[i]) ;
 cout << "Trace::TraceState(): State(" << strlen(State) << ")='" << State << "'" << endl ; // for (int i=0 ; i < strlen(State) ; ++i) printf("State[%d]=%c\n" , i , State[i]) ;
 cout << "Trace::TraceState(): Desc("  << strlen(Desc)  << ")='" << Desc  << "'" << endl ; // for (int i=0 ; i < strlen(Desc) ; ++i) printf("Desc[%d]=%c\n" , i , Desc[i]) ;
-#endif // #if DEBUG_TRACE_CLASS && DEBUG_TRACE_OUT
+}
 }
 
 #if DRAW_DEBUG_TEXT
@@ -22,148 +22,119 @@
 #define _TRACE_H_
 
 
+#include <atomic>
+
+
 #define DBG(d)      Trace::Dbg(d)
 #define ERR(d)      Trace::Err(d)
-#define TRACE_EVS   Trace::TraceEvs
-#define TRACE_IN    Trace::TraceIn
-#define TRACE_OUT   Trace::TraceOut
 #define TRACE_SCENE Trace::TraceScene
 
+// trace categories - subsystems
+#define TRACE_CAT_JACK         0x0001
+#define TRACE_CAT_LOOPIDITY    0x0002
+#define TRACE_CAT_LOOPIDITYSDL 0x0004
+#define TRACE_CAT_SCENE        0x0008
+#define TRACE_CAT_SCENESDL     0x0010
+#define TRACE_CAT_CLASS        0x0020
+// trace categories - kinds
+#define TRACE_CAT_EVS          0x0100
+#define TRACE_CAT_IN           0x0200
+#define TRACE_CAT_OUT          0x0400
+#define TRACE_CAT_CHECK        0x0800
+
+// categories compiled in (see note on trace categories below)
+#define TRACE_COMPILED_CATS (((DEBUG_TRACE_JACK        )? TRACE_CAT_JACK         : 0) | \
+                             ((DEBUG_TRACE_LOOPIDITY   )? TRACE_CAT_LOOPIDITY    : 0) | \
+                             ((DEBUG_TRACE_LOOPIDITYSDL)? TRACE_CAT_LOOPIDITYSDL : 0) | \
+                             ((DEBUG_TRACE_SCENE       )? TRACE_CAT_SCENE        : 0) | \
+                             ((DEBUG_TRACE_SCENESDL    )? TRACE_CAT_SCENESDL     : 0) | \
+                             ((DEBUG_TRACE_CLASS       )? TRACE_CAT_CLASS        : 0) | \
+                             ((DEBUG_TRACE_EVS         )? TRACE_CAT_EVS          : 0) | \
+                             ((DEBUG_TRACE_IN          )? TRACE_CAT_IN           : 0) | \
+                             ((DEBUG_TRACE_OUT         )? TRACE_CAT_OUT          : 0) | \
+                             ((DEBUG_TRACE_CHECK       )? TRACE_CAT_CHECK        : 0)   )
+
+// trace points
+#define TRACE_IF(category)                          if (Trace::IsTracing<category>())
+#define TRACE_SCENE_IF(category , sender , scene)   TRACE_IF(category) TRACE_SCENE(sender , scene) ;
+#define TRACE_SCENE_IN(category , sender , scene , bail)                         \
+  { if (Trace::IsTracing<(category) | TRACE_CAT_CHECK>()  &&                     \
+        !Trace::SanityCheck((scene)->sceneN)             )                       \
+      { TRACE_SCENE(sender , scene) ; bail ; }                                   \
+    TRACE_SCENE_IF((category) | TRACE_CAT_IN , sender , scene) }
+
 #if DEBUG_TRACE
 #  ifdef _WIN32
 #    define REDIRECT_WINDOWS_OUTPUT std::ofstream ofs("debug.log") ; cout.rdbuf(ofs.rdbuf()) ;
 #  else // _WIN32
 #    define REDIRECT_WINDOWS_OUTPUT ;
 #  endif // _WIN32
-#  define DEBUG_TRACE_MAIN_IN   REDIRECT_WINDOWS_OUTPUT if (DEBUG_TRACE_EVS) DBG(INIT_MSG) ;
+#  define DEBUG_TRACE_MAIN_IN   REDIRECT_WINDOWS_OUTPUT TRACE_IF(TRACE_CAT_EVS) DBG(INIT_MSG) ;
 #  define DEBUG_TRACE_MAIN_OUT  if (!!exitStatus) ERR(INIT_FAIL_MSG) ;
 #else
 #  define DEBUG_TRACE_MAIN_IN  ;
 #  define DEBUG_TRACE_MAIN_OUT ;
 #endif
 
-#if DEBUG_TRACE_LOOPIDITY
-#  define DEBUG_TRACE_LOOPIDITY_MAIN_MID                 if (DEBUG_TRACE_EVS) printf("%s\n" , INIT_SUCCESS_MSG) ;
-#  define DEBUG_TRACE_LOOPIDITY_MAIN_OUT                 if (DEBUG_TRACE_EVS) printf("%s\n" , EXIT_SUCCESS_MSG) ;
-#  define DEBUG_TRACE_LOOPIDITY_TOGGLERECORDINGSTATE_IN  if (TRACE_EVS(CurrentSceneN)) printf("\nUSER: SDLK_SPACE --> Loopidity::ToggleRecordingState(%d)\n\n" , CurrentSceneN) ; if (TRACE_IN(CurrentSceneN) && !TRACE_SCENE("Loopidity::ToggleRecordingState(%d)  IN" , Scenes[CurrentSceneN])) return ;
-#  define DEBUG_TRACE_LOOPIDITY_TOGGLERECORDINGSTATE_OUT if (TRACE_OUT(CurrentSceneN)) TRACE_SCENE("Loopidity::ToggleRecordingState(%d) OUT" , Scenes[CurrentSceneN]) ;
-#  define DEBUG_TRACE_LOOPIDITY_TOGGLENEXTSCENE_IN       if (TRACE_EVS(CurrentSceneN)) printf("\nUSER: SDLK_KP0 --> Loopidity::ToggleNextScene(%d)\n\n" , CurrentSceneN) ; if (TRACE_IN(CurrentSceneN) && !TRACE_SCENE("Loopidity::ToggleNextScene(%d)  IN" , Scenes[CurrentSceneN])) return ;
-#  define DEBUG_TRACE_LOOPIDITY_TOGGLENEXTSCENE_OUT      if (TRACE_OUT(CurrentSceneN)) TRACE_SCENE("Loopidity::ToggleNextScene(%d) OUT" , Scenes[CurrentSceneN]) ;
-#  define DEBUG_TRACE_LOOPIDITY_DELETELASTLOOP_IN        if (TRACE_EVS(CurrentSceneN)) printf("\nUSER: SDLK_ESCAPE --> Loopidity::DeleteLastLoop(%d)\n\n" , CurrentSceneN) ; if (TRACE_IN(CurrentSceneN) && !TRACE_SCENE("Loopidity::DeleteLastLoop(%d)  IN" , Scenes[CurrentSceneN])) return ;
-#  define DEBUG_TRACE_LOOPIDITY_DELETELASTLOOP_OUT       if (TRACE_OUT(CurrentSceneN)) TRACE_SCENE("Loopidity::DeleteLoop(%d) OUT" , Scenes[CurrentSceneN]) ;
-#  define DEBUG_TRACE_LOOPIDITY_DELETELOOP_IN            if (TRACE_EVS(sceneN))        printf("\nUSER: SDL_BUTTON_MIDDLE --> Loopidity::DeleteLoop(%d)\n\n" , sceneN) ; if (TRACE_IN(sceneN) && !TRACE_SCENE("Loopidity::DeleteLoop(%d)  IN" , Scenes[sceneN])) return ;
-#  define DEBUG_TRACE_LOOPIDITY_DELETELOOP_OUT           if (TRACE_OUT(sceneN))        TRACE_SCENE("Loopidity::DeleteLoop(%d) OUT" , Scenes[sceneN]) ;
-#  define DEBUG_TRACE_LOOPIDITY_INCLOOPVOL_IN            if (TRACE_EVS(sceneN))        printf("\nUSER: %s --> Loopidity::IncLoopVol(%d)  IN vol=%f\n\n" , (isInc)? "SDL_BUTTON_WHEELUP" : "SDL_BUTTON_WHEELDOWN" , sceneN , Scenes[sceneN]->getLoop(loopN)->vol) ;
-#  define DEBUG_TRACE_LOOPIDITY_INCLOOPVOL_OUT           if (DEBUG_TRACE_OUT)          { char event[128] ; sprintf(event , "%s OUT vol=%3.1f\n\n" , "Loopidity::IncLoopVol(%d)" , *vol) ; TRACE_SCENE(event , Scenes[sceneN]) ; }
-#  define DEBUG_TRACE_LOOPIDITY_TOGGLELOOPISMUTED_IN     if (TRACE_EVS(sceneN))        { printf("\nUSER: SDLK_KP_ENTER --> Loopidity::ToggleLoopIsMuted(%d)\n\n" , sceneN) ; printf("\nUSER: SDL_BUTTON_LEFT --> Loopidity::ToggleLoopIsMuted(%d)\n\n" , sceneN) ; } if (TRACE_IN(sceneN) && !TRACE_SCENE("Loopidity::ToggleLoopIsMuted(%d)  IN" , Scenes[sceneN])) return ;
-#  define DEBUG_TRACE_LOOPIDITY_TOGGLELOOPISMUTED_OUT    if (TRACE_OUT(sceneN))        TRACE_SCENE("Loopidity::ToggleLoopIsMuted(%d) OUT" , Scenes[sceneN]) ;
-#  define DEBUG_TRACE_LOOPIDITY_RESETSCENE_IN            if (TRACE_EVS(CurrentSceneN)) printf("\nUSER: KMOD_RSHIFT+SDLK_ESCAPE --> Loopidity::ResetScene(%d)\n\n" , sceneN) ; if (TRACE_IN(CurrentSceneN) && !TRACE_SCENE("Loopidity::ResetCurrentScene(%d)  IN" , Scenes[CurrentSceneN])) return ;
-#  define DEBUG_TRACE_LOOPIDITY_RESETSCENE_OUT           if (DEBUG_TRACE_OUT)          TRACE_SCENE("Loopidity::ResetScene(%d) OUT" , Scenes[sceneN]) ;
-#  define DEBUG_TRACE_LOOPIDITY_RESET_IN                 if (TRACE_EVS(CurrentSceneN)) printf("\nUSER: KMOD_RCTRL+SDLK_ESCAPE --> Loopidity::Reset(%d)\n\n" , CurrentSceneN) ; if (TRACE_IN(CurrentSceneN) && !TRACE_SCENE("Loopidity::Reset(%d)  IN" , Scenes[CurrentSceneN])) return ;
-#  define DEBUG_TRACE_LOOPIDITY_RESET_OUT                if (TRACE_OUT(CurrentSceneN)) TRACE_SCENE("Loopidity::Reset(%d) OUT" , Scenes[CurrentSceneN]) ;
-#  define DEBUG_TRACE_LOOPIDITY_ONLOOPCREATION_IN        if (TRACE_EVS(*sceneNum))     printf("\nUSER: EVT_NEW_LOOP --> Loopidity::OnLoopCreation(%d)\n\n" , *sceneNum) ; if (TRACE_IN(*sceneNum) && !TRACE_SCENE("Loopidity::OnLoopCreation(%d)  IN" , Scenes[*sceneNum])) return ;
-#  define DEBUG_TRACE_LOOPIDITY_ONLOOPCREATION_OUT       if (TRACE_OUT(sceneN))        TRACE_SCENE("Loopidity::OnLoopCreation(%d) OUT" , Scenes[sceneN]) ;
-#  define DEBUG_TRACE_LOOPIDITY_ONSCENECHANGE_IN         if (TRACE_EVS(CurrentSceneN)) printf("\nUSER: EVT_SCENE_CHANGED --> Loopidity::OnSceneChange(%d)\n\n" , CurrentSceneN) ; if (TRACE_IN(CurrentSceneN) && !TRACE_SCENE("Loopidity::OnSceneChange(%d)  IN" , Scenes[CurrentSceneN])) return ;
-#  define DEBUG_TRACE_LOOPIDITY_ONSCENECHANGE_OUT        if (TRACE_OUT(NextSceneN))    TRACE_SCENE("Loopidity::OnSceneChange(%d)  OUT" , nextScene) ;
-#  define DEBUG_TRACE_LOOPIDITY_OOM_IN                                                 TRACE_SCENE("Loopidity::OOM(%d)   IN" , Scenes[CurrentSceneN]) ;
-#else
-#  define DEBUG_TRACE_LOOPIDITY_MAIN_MID                 ;
-#  define DEBUG_TRACE_LOOPIDITY_MAIN_OUT                 ;
-#  define DEBUG_TRACE_LOOPIDITY_TOGGLERECORDINGSTATE_IN  ;
-#  define DEBUG_TRACE_LOOPIDITY_TOGGLERECORDINGSTATE_OUT ;
-#  define DEBUG_TRACE_LOOPIDITY_TOGGLENEXTSCENE_IN       ;
-#  define DEBUG_TRACE_LOOPIDITY_TOGGLENEXTSCENE_OUT      ;
-#  define DEBUG_TRACE_LOOPIDITY_DELETELASTLOOP_IN        ;
-#  define DEBUG_TRACE_LOOPIDITY_DELETELASTLOOP_OUT       ;
-#  define DEBUG_TRACE_LOOPIDITY_DELETELOOP_IN            ;
-#  define DEBUG_TRACE_LOOPIDITY_DELETELOOP_OUT           ;
-#  define DEBUG_TRACE_LOOPIDITY_INCLOOPVOL_IN            ;
-#  define DEBUG_TRACE_LOOPIDITY_INCLOOPVOL_OUT           ;
-#  define DEBUG_TRACE_LOOPIDITY_TOGGLELOOPISMUTED_IN     ;
-#  define DEBUG_TRACE_LOOPIDITY_TOGGLELOOPISMUTED_OUT    ;
-#  define DEBUG_TRACE_LOOPIDITY_RESETSCENE_IN            ;
-#  define DEBUG_TRACE_LOOPIDITY_RESETSCENE_OUT           ;
-#  define DEBUG_TRACE_LOOPIDITY_RESET_IN                 ;
-#  define DEBUG_TRACE_LOOPIDITY_RESET_OUT                ;
-#  define DEBUG_TRACE_LOOPIDITY_ONLOOPCREATION_IN        ;
-#  define DEBUG_TRACE_LOOPIDITY_ONLOOPCREATION_OUT       ;
-#  define DEBUG_TRACE_LOOPIDITY_ONSCENECHANGE_IN         ;
-#  define DEBUG_TRACE_LOOPIDITY_ONSCENECHANGE_OUT        ;
-#  define DEBUG_TRACE_LOOPIDITY_OOM_IN                   ;
-#endif // #if DEBUG_TRACE_LOOPIDITY
-
-#if DEBUG_TRACE_JACK
-#  define DEBUG_TRACE_JACK_INIT                      printf("JackIO::Init() shouldMonitorInputs=%d recordBufferSize=%d\n" , shouldMonitorInputs , recordBufferSize) ;
-#  define DEBUG_TRACE_JACK_RESET                     printf("JackIO::Reset() sceneN=%d\n" , currentScene->sceneN) ;
-#  define DEBUG_TRACE_JACK_PROCESS_CALLBACK_IN       ; // Uint32 DbgNextFrameN = (CurrentScene->currentFrameN + nFramesPerPeriod) ; if (DbgNextFrameN >= CurrentScene->endFrameN || !(DbgNextFrameN % 32768)) printf("JackIO::ProcessCallback() sceneN=%d currentFrameN=%d nFramesPerPeriod=%d CurrentScene->endFrameN=%d mod=%d\n" , CurrentScene->sceneN , CurrentScene->currentFrameN , nFramesPerPeriod , CurrentScene->endFrameN , ((CurrentScene->currentFrameN + nFramesPerPeriod) % CurrentScene->endFrameN)) ;
-#  define DEBUG_TRACE_JACK_PROCESS_CALLBACK_ROLLOVER printf("JackIO::ProcessCallback() buffer rollover nLoops=%d isBaseLoop=%d beginFrameN=%d endFrameN=%d nSeconds=%d - %s\n" , nLoops , isBaseLoop , beginFrameN , endFrameN , (nFrames / SampleRate) , ((!isBaseLoop)? "" : ((endFrameN == EndFrameN)? "endFrameN invalid" : ((nFrames < MinLoopSize)? "nFrames invalid" : "valid")))) ;
-#  define DEBUG_TRACE_JACK_PROCESS_CALLBACK_NEW_LOOP printf("JackIO::ProcessCallback() NewLoop isBaseLoop=%d\n" , isBaseLoop) ;
-#  define DEBUG_TRACE_JACK_SETMETADATA               printf("JackIO::SetMetadata() SampleRate=%d nFramesPerPeriod=%d BeginFrameN=%d EndFrameN=%d modsane=%d\n" , SampleRate , nFramesPerPeriod , BeginFrameN , EndFrameN , (!(BeginFrameN % nFramesPerPeriod) && !(EndFrameN % nFramesPerPeriod))) ;
-#else
-#  define DEBUG_TRACE_JACK_INIT                      ;
-#  define DEBUG_TRACE_JACK_RESET                     ;
-#  define DEBUG_TRACE_JACK_PROCESS_CALLBACK_IN       ;
-#  define DEBUG_TRACE_JACK_PROCESS_CALLBACK_ROLLOVER ;
-#  define DEBUG_TRACE_JACK_PROCESS_CALLBACK_NEW_LOOP ;
-#  define DEBUG_TRACE_JACK_SETMETADATA               ;
-#endif // #if DEBUG_TRACE_JACK
-
-#if DEBUG_TRACE_LOOPIDITYSDL
-#  define DEBUG_TRACE_LOOPIDITYSDL_HANDLEKEYEVENT if (DEBUG_TRACE_EVS) switch (event->key.keysym.sym) { case SDLK_SPACE: printf("\nKEY: SDLK_SPACE\n") ; break ; case SDLK_KP0: printf("\nKEY: SDLK_KP0\n") ; break ; case SDLK_KP_ENTER: printf("\nKEY: SDLK_KP_ENTER\n") ; break ; case SDLK_ESCAPE: printf("\nKEY: SDLK_ESCAPE\n") ;  break ; default: break ; }
-#else
-#  define DEBUG_TRACE_LOOPIDITYSDL_HANDLEKEYEVENT ;
-#endif // #if DEBUG_TRACE_LOOPIDITYSDL
-
-#if DEBUG_TRACE_SCENE
-#  define DEBUG_TRACE_SCENE_BEGINRECORDING_IN        if (TRACE_IN(sceneN) && !TRACE_SCENE("Scene::beginRecording(%d)     IN" , this)) return ; ;
-#  define DEBUG_TRACE_SCENE_TOGGLERECORDINGSTATE_IN  if (TRACE_IN(sceneN) && !TRACE_SCENE("Scene::toggleRecordingState(%d)      IN" , this)) return ;
-#  define DEBUG_TRACE_SCENE_TOGGLERECORDINGSTATE_OUT if (TRACE_OUT(sceneN))   TRACE_SCENE("Scene::toggleRecordingState(%d)     OUT" , this) ;
-#  define DEBUG_TRACE_SCENE_ADDLOOP_IN               if (TRACE_IN(sceneN) && !TRACE_SCENE("Scene::addLoop(%d)  IN" , this)) return false ;
-#  define DEBUG_TRACE_SCENE_ADDLOOP_OUT              if (TRACE_OUT(sceneN))   TRACE_SCENE("Scene::addLoop(%d) OUT" , this) ;
-#  define DEBUG_TRACE_SCENE_DELETELOOP_IN            if (TRACE_IN(sceneN) && !TRACE_SCENE("Scene::deleteLoop(%d)     IN" , this)) return ;
-#  define DEBUG_TRACE_SCENE_DELETELOOP_OUT           if (TRACE_OUT(sceneN))   TRACE_SCENE("Scene::deleteLoop(%d)    OUT" , this) ;
-#  define DEBUG_TRACE_SCENE_RESET_IN                 if (TRACE_IN(sceneN) && !TRACE_SCENE("Scene::reset(%d)  IN" , this)) return ; ;
-#  define DEBUG_TRACE_SCENE_RESET_OUT                if (TRACE_OUT(sceneN))   TRACE_SCENE("Scene::reset(%d) OUT" , this) ;
-#  define DEBUG_TRACE_SCENE_SCANPEAKS_IN             if (TRACE_IN(sceneN) && !TRACE_SCENE("Scene::scanPeaks(%d)  IN" , this)) return ;
-#  define DEBUG_TRACE_SCENE_SCANPEAKS_OUT            if (TRACE_OUT(sceneN))   TRACE_SCENE("Scene::scanPeaks(%d) OUT" , this) ;
-#  define DEBUG_TRACE_SCENE_RESCANPEAKS_IN           if (TRACE_IN(sceneN) && !TRACE_SCENE("Scene::rescanPeaks(%d)  IN" , this)) return ;
-#  define DEBUG_TRACE_SCENE_RESCANPEAKS_OUT          if (TRACE_OUT(sceneN))   TRACE_SCENE("Scene::rescanPeaks(%d) OUT" , this) ;
-#else
-#  define DEBUG_TRACE_SCENE_BEGINRECORDING_IN        ;
-#  define DEBUG_TRACE_SCENE_TOGGLERECORDINGSTATE_IN  ;
-#  define DEBUG_TRACE_SCENE_TOGGLERECORDINGSTATE_OUT ;
-#  define DEBUG_TRACE_SCENE_ADDLOOP_IN               ;
-#  define DEBUG_TRACE_SCENE_ADDLOOP_OUT              ;
-#  define DEBUG_TRACE_SCENE_DELETELOOP_IN            ;
-#  define DEBUG_TRACE_SCENE_DELETELOOP_OUT           ;
-#  define DEBUG_TRACE_SCENE_RESET_IN                 ;
-#  define DEBUG_TRACE_SCENE_RESET_OUT                ;
-#  define DEBUG_TRACE_SCENE_SCANPEAKS_IN             ;
-#  define DEBUG_TRACE_SCENE_SCANPEAKS_OUT            ;
-#  define DEBUG_TRACE_SCENE_RESCANPEAKS_IN           ;
-#  define DEBUG_TRACE_SCENE_RESCANPEAKS_OUT          ;
-#endif // #if DEBUG_TRACE_SCENE
-
-#if DEBUG_TRACE_SCENESDL
-#  define DEBUG_TRACE_SCENESDL_UPDATESTATUS_IN  if (TRACE_IN(scene->sceneN))    TRACE_SCENE("SceneSdl::updateState(%d)   IN" , scene) ;
-#  define DEBUG_TRACE_SCENESDL_UPDATESTATUS_OUT if (TRACE_OUT(scene->sceneN))   TRACE_SCENE("SceneSdl::updateState(%d)  OUT" , scene) ;
-#  define DEBUG_TRACE_SCENESDL_ADDLOOP_IN       if (TRACE_IN(scene->sceneN) && (loopImgs.size() != scene->loops.size() - 1) && !TRACE_SCENE("SceneSdl::addLoop(%d) ERR" , scene)) return ;
-#  define DEBUG_TRACE_SCENESDL_ADDLOOP_OUT      if (TRACE_OUT(scene->sceneN))   TRACE_SCENE("SceneSdl::addLoop(%d) OUT" , scene) ;
-#  define DEBUG_TRACE_SCENESDL_DELETELOOP_IN    if (TRACE_IN(scene->sceneN) && !TRACE_SCENE("SceneSdl::deleteLoop(%d)   IN" , scene)) return ;
-#  define DEBUG_TRACE_SCENESDL_DELETELOOP_OUT   if (TRACE_OUT(scene->sceneN))   TRACE_SCENE("SceneSdl::deleteLoop(%d)  OUT" , scene) ;
-#else
-#  define DEBUG_TRACE_SCENESDL_UPDATESTATUS_IN  ;
-#  define DEBUG_TRACE_SCENESDL_UPDATESTATUS_OUT ;
-#  define DEBUG_TRACE_SCENESDL_ADDLOOP_IN       ;
-#  define DEBUG_TRACE_SCENESDL_ADDLOOP_OUT      ;
-#  define DEBUG_TRACE_SCENESDL_DELETELOOP_IN    ;
-#  define DEBUG_TRACE_SCENESDL_DELETELOOP_OUT   ;
-#endif // #if DEBUG_TRACE_SCENESDL
+#define DEBUG_TRACE_LOOPIDITY_MAIN_MID                 TRACE_IF(TRACE_CAT_LOOPIDITY | TRACE_CAT_EVS) printf("%s\n" , INIT_SUCCESS_MSG) ;
+#define DEBUG_TRACE_LOOPIDITY_MAIN_OUT                 TRACE_IF(TRACE_CAT_LOOPIDITY | TRACE_CAT_EVS) printf("%s\n" , EXIT_SUCCESS_MSG) ;
+#define DEBUG_TRACE_LOOPIDITY_TOGGLERECORDINGSTATE_IN  TRACE_IF(TRACE_CAT_LOOPIDITY | TRACE_CAT_EVS) printf("\nUSER: SDLK_SPACE --> Loopidity::ToggleRecordingState(%d)\n\n" , CurrentSceneN) ; TRACE_SCENE_IN(TRACE_CAT_LOOPIDITY , "Loopidity::ToggleRecordingState(%d)  IN" , Scenes[CurrentSceneN] , return)
+#define DEBUG_TRACE_LOOPIDITY_TOGGLERECORDINGSTATE_OUT TRACE_SCENE_IF(TRACE_CAT_LOOPIDITY | TRACE_CAT_OUT , "Loopidity::ToggleRecordingState(%d) OUT" , Scenes[CurrentSceneN])
+#define DEBUG_TRACE_LOOPIDITY_TOGGLENEXTSCENE_IN       TRACE_IF(TRACE_CAT_LOOPIDITY | TRACE_CAT_EVS) printf("\nUSER: SDLK_KP0 --> Loopidity::ToggleNextScene(%d)\n\n" , CurrentSceneN) ; TRACE_SCENE_IN(TRACE_CAT_LOOPIDITY , "Loopidity::ToggleNextScene(%d)  IN" , Scenes[CurrentSceneN] , return)
+#define DEBUG_TRACE_LOOPIDITY_TOGGLENEXTSCENE_OUT      TRACE_SCENE_IF(TRACE_CAT_LOOPIDITY | TRACE_CAT_OUT , "Loopidity::ToggleNextScene(%d) OUT" , Scenes[CurrentSceneN])
+#define DEBUG_TRACE_LOOPIDITY_DELETELASTLOOP_IN        TRACE_IF(TRACE_CAT_LOOPIDITY | TRACE_CAT_EVS) printf("\nUSER: SDLK_ESCAPE --> Loopidity::DeleteLastLoop(%d)\n\n" , CurrentSceneN) ; TRACE_SCENE_IN(TRACE_CAT_LOOPIDITY , "Loopidity::DeleteLastLoop(%d)  IN" , Scenes[CurrentSceneN] , return)
+#define DEBUG_TRACE_LOOPIDITY_DELETELASTLOOP_OUT       TRACE_SCENE_IF(TRACE_CAT_LOOPIDITY | TRACE_CAT_OUT , "Loopidity::DeleteLoop(%d) OUT" , Scenes[CurrentSceneN])
+#define DEBUG_TRACE_LOOPIDITY_DELETELOOP_IN            TRACE_IF(TRACE_CAT_LOOPIDITY | TRACE_CAT_EVS) printf("\nUSER: SDL_BUTTON_MIDDLE --> Loopidity::DeleteLoop(%d)\n\n" , sceneN) ; TRACE_SCENE_IN(TRACE_CAT_LOOPIDITY , "Loopidity::DeleteLoop(%d)  IN" , Scenes[sceneN] , return)
+#define DEBUG_TRACE_LOOPIDITY_DELETELOOP_OUT           TRACE_SCENE_IF(TRACE_CAT_LOOPIDITY | TRACE_CAT_OUT , "Loopidity::DeleteLoop(%d) OUT" , Scenes[sceneN])
+#define DEBUG_TRACE_LOOPIDITY_INCLOOPVOL_IN            TRACE_IF(TRACE_CAT_LOOPIDITY | TRACE_CAT_EVS) printf("\nUSER: %s --> Loopidity::IncLoopVol(%d)  IN vol=%f\n\n" , (isInc)? "SDL_BUTTON_WHEELUP" : "SDL_BUTTON_WHEELDOWN" , sceneN , Scenes[sceneN]->getLoop(loopN)->vol) ;
+#define DEBUG_TRACE_LOOPIDITY_INCLOOPVOL_OUT           TRACE_IF(TRACE_CAT_LOOPIDITY | TRACE_CAT_OUT) { char event[128] ; sprintf(event , "%s OUT vol=%3.1f\n\n" , "Loopidity::IncLoopVol(%d)" , *vol) ; TRACE_SCENE(event , Scenes[sceneN]) ; }
+#define DEBUG_TRACE_LOOPIDITY_TOGGLELOOPISMUTED_IN     TRACE_IF(TRACE_CAT_LOOPIDITY | TRACE_CAT_EVS) { printf("\nUSER: SDLK_KP_ENTER --> Loopidity::ToggleLoopIsMuted(%d)\n\n" , sceneN) ; printf("\nUSER: SDL_BUTTON_LEFT --> Loopidity::ToggleLoopIsMuted(%d)\n\n" , sceneN) ; } TRACE_SCENE_IN(TRACE_CAT_LOOPIDITY , "Loopidity::ToggleLoopIsMuted(%d)  IN" , Scenes[sceneN] , return)
+#define DEBUG_TRACE_LOOPIDITY_TOGGLELOOPISMUTED_OUT    TRACE_SCENE_IF(TRACE_CAT_LOOPIDITY | TRACE_CAT_OUT , "Loopidity::ToggleLoopIsMuted(%d) OUT" , Scenes[sceneN])
+#define DEBUG_TRACE_LOOPIDITY_RESETSCENE_IN            TRACE_IF(TRACE_CAT_LOOPIDITY | TRACE_CAT_EVS) printf("\nUSER: KMOD_RSHIFT+SDLK_ESCAPE --> Loopidity::ResetScene(%d)\n\n" , sceneN) ; TRACE_SCENE_IN(TRACE_CAT_LOOPIDITY , "Loopidity::ResetCurrentScene(%d)  IN" , Scenes[CurrentSceneN] , return)
+#define DEBUG_TRACE_LOOPIDITY_RESETSCENE_OUT           TRACE_SCENE_IF(TRACE_CAT_LOOPIDITY | TRACE_CAT_OUT , "Loopidity::ResetScene(%d) OUT" , Scenes[sceneN])
+#define DEBUG_TRACE_LOOPIDITY_RESET_IN                 TRACE_IF(TRACE_CAT_LOOPIDITY | TRACE_CAT_EVS) printf("\nUSER: KMOD_RCTRL+SDLK_ESCAPE --> Loopidity::Reset(%d)\n\n" , CurrentSceneN) ; TRACE_SCENE_IN(TRACE_CAT_LOOPIDITY , "Loopidity::Reset(%d)  IN" , Scenes[CurrentSceneN] , return)
+#define DEBUG_TRACE_LOOPIDITY_RESET_OUT                TRACE_SCENE_IF(TRACE_CAT_LOOPIDITY | TRACE_CAT_OUT , "Loopidity::Reset(%d) OUT" , Scenes[CurrentSceneN])
+#define DEBUG_TRACE_LOOPIDITY_ONLOOPCREATION_IN        TRACE_IF(TRACE_CAT_LOOPIDITY | TRACE_CAT_EVS) printf("\nUSER: EVT_NEW_LOOP --> Loopidity::OnLoopCreation(%d)\n\n" , *sceneNum) ; TRACE_SCENE_IN(TRACE_CAT_LOOPIDITY , "Loopidity::OnLoopCreation(%d)  IN" , Scenes[*sceneNum] , return)
+#define DEBUG_TRACE_LOOPIDITY_ONLOOPCREATION_OUT       TRACE_SCENE_IF(TRACE_CAT_LOOPIDITY | TRACE_CAT_OUT , "Loopidity::OnLoopCreation(%d) OUT" , Scenes[sceneN])
+#define DEBUG_TRACE_LOOPIDITY_ONSCENECHANGE_IN         TRACE_IF(TRACE_CAT_LOOPIDITY | TRACE_CAT_EVS) printf("\nUSER: EVT_SCENE_CHANGED --> Loopidity::OnSceneChange(%d)\n\n" , CurrentSceneN) ; TRACE_SCENE_IN(TRACE_CAT_LOOPIDITY , "Loopidity::OnSceneChange(%d)  IN" , Scenes[CurrentSceneN] , return)
+#define DEBUG_TRACE_LOOPIDITY_ONSCENECHANGE_OUT        TRACE_SCENE_IF(TRACE_CAT_LOOPIDITY | TRACE_CAT_OUT , "Loopidity::OnSceneChange(%d)  OUT" , nextScene)
+#define DEBUG_TRACE_LOOPIDITY_OOM_IN                   TRACE_SCENE_IF(TRACE_CAT_LOOPIDITY , "Loopidity::OOM(%d)   IN" , Scenes[CurrentSceneN])
+
+#define DEBUG_TRACE_JACK_INIT                      TRACE_IF(TRACE_CAT_JACK) printf("JackIO::Init() shouldMonitorInputs=%d recordBufferSize=%d\n" , shouldMonitorInputs , recordBufferSize) ;
+#define DEBUG_TRACE_JACK_RESET                     TRACE_IF(TRACE_CAT_JACK) printf("JackIO::Reset() sceneN=%d\n" , currentScene->sceneN) ;
+#define DEBUG_TRACE_JACK_PROCESS_CALLBACK_IN       ; // Uint32 DbgNextFrameN = (CurrentScene->currentFrameN + nFramesPerPeriod) ; if (DbgNextFrameN >= CurrentScene->endFrameN || !(DbgNextFrameN % 32768)) printf("JackIO::ProcessCallback() sceneN=%d currentFrameN=%d nFramesPerPeriod=%d CurrentScene->endFrameN=%d mod=%d\n" , CurrentScene->sceneN , CurrentScene->currentFrameN , nFramesPerPeriod , CurrentScene->endFrameN , ((CurrentScene->currentFrameN + nFramesPerPeriod) % CurrentScene->endFrameN)) ;
+#define DEBUG_TRACE_JACK_PROCESS_CALLBACK_ROLLOVER TRACE_IF(TRACE_CAT_JACK) TraceRing::Write(TRACE_EVT_ROLLOVER , CurrentScene->sceneN , nLoops , beginFrameN , endFrameN , (nFrames / SampleRate) , ((!isBaseLoop)? 0 : ((endFrameN == EndFrameN)? 1 : ((nFrames < MinLoopSize)? 2 : 3)))) ; // RT - see note on the binary trace in trace_ring.h
+#define DEBUG_TRACE_JACK_PROCESS_CALLBACK_NEW_LOOP TRACE_IF(TRACE_CAT_JACK) TraceRing::Write(TRACE_EVT_NEW_LOOP , CurrentScene->sceneN , nLoops) ;
+#define DEBUG_TRACE_JACK_SETMETADATA               TRACE_IF(TRACE_CAT_JACK) printf("JackIO::SetMetadata() SampleRate=%d nFramesPerPeriod=%d BeginFrameN=%d EndFrameN=%d modsane=%d\n" , SampleRate , nFramesPerPeriod , BeginFrameN , EndFrameN , (!(BeginFrameN % nFramesPerPeriod) && !(EndFrameN % nFramesPerPeriod))) ;
+
+#define DEBUG_TRACE_LOOPIDITYSDL_HANDLEKEYEVENT TRACE_IF(TRACE_CAT_LOOPIDITYSDL | TRACE_CAT_EVS) switch (event->key.keysym.sym) { case SDLK_SPACE: printf("\nKEY: SDLK_SPACE\n") ; break ; case SDLK_KP0: printf("\nKEY: SDLK_KP0\n") ; break ; case SDLK_KP_ENTER: printf("\nKEY: SDLK_KP_ENTER\n") ; break ; case SDLK_ESCAPE: printf("\nKEY: SDLK_ESCAPE\n") ;  break ; default: break ; }
+
+#define DEBUG_TRACE_SCENE_BEGINRECORDING_IN        TRACE_SCENE_IN(TRACE_CAT_SCENE , "Scene::beginRecording(%d)     IN" , this , return)
+#define DEBUG_TRACE_SCENE_TOGGLERECORDINGSTATE_IN  TRACE_SCENE_IN(TRACE_CAT_SCENE , "Scene::toggleRecordingState(%d)      IN" , this , return)
+#define DEBUG_TRACE_SCENE_TOGGLERECORDINGSTATE_OUT TRACE_SCENE_IF(TRACE_CAT_SCENE | TRACE_CAT_OUT , "Scene::toggleRecordingState(%d)     OUT" , this)
+#define DEBUG_TRACE_SCENE_ADDLOOP_IN               TRACE_SCENE_IN(TRACE_CAT_SCENE , "Scene::addLoop(%d)  IN" , this , return false)
+#define DEBUG_TRACE_SCENE_ADDLOOP_OUT              TRACE_SCENE_IF(TRACE_CAT_SCENE | TRACE_CAT_OUT , "Scene::addLoop(%d) OUT" , this)
+#define DEBUG_TRACE_SCENE_DELETELOOP_IN            TRACE_SCENE_IN(TRACE_CAT_SCENE , "Scene::deleteLoop(%d)     IN" , this , return)
+#define DEBUG_TRACE_SCENE_DELETELOOP_OUT           TRACE_SCENE_IF(TRACE_CAT_SCENE | TRACE_CAT_OUT , "Scene::deleteLoop(%d)    OUT" , this)
+#define DEBUG_TRACE_SCENE_RESET_IN                 TRACE_SCENE_IN(TRACE_CAT_SCENE , "Scene::reset(%d)  IN" , this , return)
+#define DEBUG_TRACE_SCENE_RESET_OUT                TRACE_SCENE_IF(TRACE_CAT_SCENE | TRACE_CAT_OUT , "Scene::reset(%d) OUT" , this)
+#define DEBUG_TRACE_SCENE_SCANPEAKS_IN             TRACE_SCENE_IN(TRACE_CAT_SCENE , "Scene::scanPeaks(%d)  IN" , this , return)
+#define DEBUG_TRACE_SCENE_SCANPEAKS_OUT            TRACE_SCENE_IF(TRACE_CAT_SCENE | TRACE_CAT_OUT , "Scene::scanPeaks(%d) OUT" , this)
+#define DEBUG_TRACE_SCENE_RESCANPEAKS_IN           TRACE_SCENE_IN(TRACE_CAT_SCENE , "Scene::rescanPeaks(%d)  IN" , this , return)
+#define DEBUG_TRACE_SCENE_RESCANPEAKS_OUT          TRACE_SCENE_IF(TRACE_CAT_SCENE | TRACE_CAT_OUT , "Scene::rescanPeaks(%d) OUT" , this)
+
+#define DEBUG_TRACE_SCENESDL_UPDATESTATUS_IN  TRACE_SCENE_IF(TRACE_CAT_SCENESDL | TRACE_CAT_IN  , "SceneSdl::updateState(%d)   IN" , scene)
+#define DEBUG_TRACE_SCENESDL_UPDATESTATUS_OUT TRACE_SCENE_IF(TRACE_CAT_SCENESDL | TRACE_CAT_OUT , "SceneSdl::updateState(%d)  OUT" , scene)
+#define DEBUG_TRACE_SCENESDL_ADDLOOP_IN       TRACE_IF(TRACE_CAT_SCENESDL | TRACE_CAT_CHECK) if ((loopImgs.size() != scene->loops.size() - 1) && !TRACE_SCENE("SceneSdl::addLoop(%d) ERR" , scene)) return ;
+#define DEBUG_TRACE_SCENESDL_ADDLOOP_OUT      TRACE_SCENE_IF(TRACE_CAT_SCENESDL | TRACE_CAT_OUT , "SceneSdl::addLoop(%d) OUT" , scene)
+#define DEBUG_TRACE_SCENESDL_DELETELOOP_IN    TRACE_SCENE_IN(TRACE_CAT_SCENESDL , "SceneSdl::deleteLoop(%d)   IN" , scene , return)
+#define DEBUG_TRACE_SCENESDL_DELETELOOP_OUT   TRACE_SCENE_IF(TRACE_CAT_SCENESDL | TRACE_CAT_OUT , "SceneSdl::deleteLoop(%d)  OUT" , scene)
 
 
 #define INIT_MSG          "main(): init"
 #define INIT_SUCCESS_MSG  "Loopidity::Main(): init success - entering sdl loop"
 #define INIT_FAIL_MSG     "Loopidity::Main(): init failed - quitting"
+#define EXIT_SUCCESS_MSG  "Loopidity::Main(): sdl loop exited - quitting"
 #define GETPEAK_ERROR_MSG "Loopidity::GetPeak(): subscript out of range"
 
 #define DEBUG_TRACE_MODEL            "MODEL: "
@@ -215,18 +186,29 @@ class Trace
     static const char   *EventType , *SenderClass , *StateFormat , *DescFormat ;
     static       Uint32  EventLen  ,  SenderLen   ,  StateLen    ,  DescLen ;
 
+    // categories
+    static atomic<Uint32> Categories ;
+
 
   public:
 
     /* class side public functions */
 
+    // categories - compiled out categories fold to false and their trace points vanish
+    template<Uint32 category> static inline bool IsTracing()
+    {
+      return ((TRACE_COMPILED_CATS & category) == category) &&
+             ((Categories.load(memory_order_relaxed) & category) == category) ;
+    }
+    static void SetCategories(Uint32 categories) ;
+
     static bool SanityCheck(Uint32 sceneN) ;
     static void Dbg(        string msg) ;
     static void Err(        string msg) ;
-    static bool TraceEvs(   Uint32 sceneN) ;
-    static bool TraceIn(    Uint32 sceneN) ;
-    static bool TraceOut(   Uint32 sceneN) ;
     static bool TraceScene( const char* senderTemplate , Scene* scene) ;
+    static void TraceSceneState(const char* sender , bool isRolling , bool shouldSaveLoop ,
+                                bool doesPulseExist , Uint32 nLoops , Uint32 nHistogramImgs ,
+                                Uint32 nLoopImgs                                            ) ;
     static void TraceState( const char* event       , const char* sender     ,
                             const char* stateFormat , const char* descFormat ,
                             bool bool0 , bool bool1 , bool bool2 , bool isEq ) ;
@@ -238,3 +220,20 @@ class Trace
 
 
 #endif // #if _TRACE_H_
+
+
+/* NOTE: on trace categories
+
+    each trace point belongs to a subsystem category (TRACE_CAT_JACK , TRACE_CAT_SCENE , ...)
+      and usually a kind (TRACE_CAT_EVS , TRACE_CAT_IN , TRACE_CAT_OUT , TRACE_CAT_CHECK)
+    a category is compiled in by its DEBUG_TRACE_* flag in loopidity.h - Trace::IsTracing<>()
+      of a category that is not compiled in is the constant false so the trace point
+      is removed entirely
+    a compiled in category costs one relaxed load and branch against the runtime mask
+      which defaults to all compiled categories - TRACE_CATS_ARG <mask> narrows it
+      (e.g. --tracecats 0x0208 for scene IN only)
+
+    mvc sanity checks (Trace::SanityCheck() walks the loop and image lists) run only
+      in checking mode (DEBUG_TRACE_CHECK) - an inconsistent scene is dumped and the
+      traced function bails out as before
+*/
@@ -0,0 +1,357 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+
+#include "trace_ring.h"
+
+
+#define TRACE_NO_RING 0xffffffff // ThreadRingN before the first Write()
+
+
+/* per-thread ring index */
+
+static thread_local Uint32 ThreadRingN = TRACE_NO_RING ; // Append()
+
+static bool IsEarlier(const TraceRecord& a , const TraceRecord& b) { return a.usecs < b.usecs ; }
+
+
+/* span names */
+
+static const char* SpanNames[TRACE_N_SPANS] = TRACE_SPAN_NAMES ;
+
+
+/* TraceRing class side private varables */
+
+// rings
+TraceRing::Ring TraceRing::Rings[TRACE_N_RINGS] ; // zero-initialized
+atomic<Uint32>  TraceRing::NRings(0) ;            // Append()
+atomic<Uint32>  TraceRing::NDropped(0) ;          // Append()
+
+// strings
+const char* TraceRing::Strings[TRACE_N_STRINGS] = { 0 } ; // Intern()
+Uint32      TraceRing::NStrings                 = 0 ;     // Intern()
+SDL_mutex*  TraceRing::StringsMutex             = 0 ;     // Init()
+
+// writer thread
+FILE*        TraceRing::File         = 0 ;     // Init()
+SDL_Thread*  TraceRing::WriterThread = 0 ;     // Init()
+atomic<bool> TraceRing::IsRunning(false) ;     // Init() , Cleanup()
+
+
+/* TraceRing::Span public functions */
+
+TraceRing::Span::Span(Uint8 aSpanN)
+  { spanN = aSpanN ; beginUsecs = (IsEnabled())? NowUsecs() : 0 ; }
+
+TraceRing::Span::~Span()
+{
+  if (!beginUsecs) return ;
+
+  // the record is stamped with the begin time so that the span sorts where it started
+  Append(beginUsecs , TRACE_EVT_SPAN , 0 , spanN , (Uint32)(NowUsecs() - beginUsecs) , 0 , 0 , 0 , 0) ;
+}
+
+
+/* TraceRing class side public functions */
+
+// any thread
+
+void TraceRing::Write(Uint8  eventId , Uint8  sceneN , Uint8  loopN , Uint32 arg0 ,
+                      Uint32 arg1    , Uint32 arg2   , Uint32 arg3  , Uint32 arg4 )
+{
+  if (IsEnabled()) Append(NowUsecs() , eventId , sceneN , loopN , arg0 , arg1 , arg2 , arg3 , arg4) ;
+}
+
+void TraceRing::NameThread(const char* name) { Write(TRACE_EVT_THREAD_NAME , 0 , 0 , Intern(name)) ; }
+
+
+/* TraceRing class side private functions */
+
+// setup
+
+bool TraceRing::Init(const char* path)
+{
+  if (IsRunning) return false ;
+
+  TraceFileHeader header = { { 0 } , TRACE_FILE_VERSION , sizeof(TraceRecord) } ;
+  memcpy(header.magic , TRACE_FILE_MAGIC , sizeof(header.magic)) ;
+  if (!(File = fopen(path , "wb"))                       ||
+      fwrite(&header , sizeof(header) , 1 , File) != 1   ||
+      !(StringsMutex = SDL_CreateMutex())                 )
+    { Cleanup() ; return false ; }
+
+  IsRunning = true ;
+  if (!(WriterThread = SDL_CreateThread(Writer , 0))) { Cleanup() ; return false ; }
+
+  return true ;
+}
+
+void TraceRing::Cleanup()
+{
+  IsRunning = false ;
+  if (WriterThread) { SDL_WaitThread(WriterThread , 0) ; WriterThread = 0 ; }
+
+  // the dropped count is written directly - the rings are no longer drained
+  Uint32 nDropped = NDropped.exchange(0) ;
+  if (File && nDropped)
+  {
+    TraceRecord record = { NowUsecs() , 0 , TRACE_EVT_DROPPED , 0 , 0 , { nDropped } } ;
+    fwrite(&record , sizeof(record) , 1 , File) ;
+  }
+  if (File)         { fclose(File) ;                     File         = 0 ; }
+  if (StringsMutex) { SDL_DestroyMutex(StringsMutex) ;   StringsMutex = 0 ; }
+}
+
+
+// any thread
+
+void TraceRing::Append(Uint64 usecs  , Uint8  eventId , Uint8  sceneN , Uint8  loopN ,
+                       Uint32 arg0   , Uint32 arg1    , Uint32 arg2   , Uint32 arg3  ,
+                       Uint32 arg4                                                   )
+{
+
+  // claim a ring on the first Write() from this thread
+  if (ThreadRingN == TRACE_NO_RING) ThreadRingN = NRings.fetch_add(1 , memory_order_relaxed) ;
+  if (ThreadRingN >= TRACE_N_RINGS) { NDropped.fetch_add(1 , memory_order_relaxed) ; return ; }
+
+  Ring*  ring   = &Rings[ThreadRingN] ;
+  Uint32 writeN = ring->writeN.load(memory_order_relaxed) ;
+  if (writeN - ring->readN.load(memory_order_acquire) >= TRACE_RING_SIZE)
+    { NDropped.fetch_add(1 , memory_order_relaxed) ; return ; }
+
+  TraceRecord* record = &ring->records[writeN & (TRACE_RING_SIZE - 1)] ;
+  record->usecs   = usecs ;
+  record->ringN   = ThreadRingN ;
+  record->eventId = eventId ;
+  record->sceneN  = sceneN ;
+  record->loopN   = loopN ;
+  record->args[0] = arg0 ; record->args[1] = arg1 ; record->args[2] = arg2 ;
+  record->args[3] = arg3 ; record->args[4] = arg4 ;
+  ring->writeN.store(writeN + 1 , memory_order_release) ;
+}
+
+bool TraceRing::IsEnabled() { return IsRunning.load(memory_order_relaxed) ; }
+
+Uint8 TraceRing::Intern(const char* str)
+{
+  if (!IsEnabled()) return TRACE_N_STRINGS ;
+
+  SDL_mutexP(StringsMutex) ;
+  Uint32 stringN = 0 ; while (stringN < NStrings && Strings[stringN] != str) ++stringN ;
+  if (stringN == NStrings && NStrings < TRACE_N_STRINGS)
+  {
+    // first use - write the chars ahead of the record that refers to them
+    Strings[NStrings++] = str ;
+    Uint32 nBytes = strlen(str) + 1 , chunkSize = sizeof(Uint32) * TRACE_N_ARGS ;
+    for (Uint32 byteN = 0 , chunkN = 0 ; byteN < nBytes ; byteN += chunkSize , ++chunkN)
+    {
+      Uint32 chunk[TRACE_N_ARGS] = { 0 } ;
+      memcpy(chunk , str + byteN , min(chunkSize , nBytes - byteN)) ;
+      Write(TRACE_EVT_STRING , chunkN , stringN , chunk[0] , chunk[1] , chunk[2] , chunk[3] , chunk[4]) ;
+    }
+  }
+  SDL_mutexV(StringsMutex) ;
+
+  return (stringN < TRACE_N_STRINGS)? stringN : TRACE_N_STRINGS ;
+}
+
+
+// writer thread
+
+int TraceRing::Writer(void* unused)
+{
+  while (IsRunning) { Drain() ; SDL_Delay(TRACE_WRITER_INTERVAL) ; }
+  Drain() ;
+
+  return 0 ;
+}
+
+void TraceRing::Drain()
+{
+  Uint32 nRings = min(NRings.load(memory_order_relaxed) , (Uint32)TRACE_N_RINGS) ;
+  for (Uint32 ringN = 0 ; ringN < nRings ; ++ringN)
+  {
+    Ring*  ring   = &Rings[ringN] ;
+    Uint32 readN  = ring->readN .load(memory_order_relaxed) ;
+    Uint32 writeN = ring->writeN.load(memory_order_acquire) ;
+
+    // at most two contiguous spans per ring
+    while (readN != writeN)
+    {
+      Uint32 recordN  = readN & (TRACE_RING_SIZE - 1) ;
+      Uint32 nRecords = min(writeN - readN , TRACE_RING_SIZE - recordN) ;
+      fwrite(&ring->records[recordN] , sizeof(TraceRecord) , nRecords , File) ;
+      readN += nRecords ;
+    }
+    ring->readN.store(readN , memory_order_release) ;
+  }
+  fflush(File) ;
+}
+
+
+// offline
+
+bool TraceRing::Read(const char* path , vector<TraceRecord>* records , vector<string>* strings)
+{
+  FILE* file = fopen(path , "rb") ; TraceFileHeader header ;
+  if (!file) { printf(TRACE_OPEN_FAIL_FMT , path) ; return false ; }
+  if (fread(&header , sizeof(header) , 1 , file) != 1                     ||
+      memcmp(header.magic , TRACE_FILE_MAGIC , sizeof(header.magic))      ||
+      header.version != TRACE_FILE_VERSION || header.recordSize != sizeof(TraceRecord))
+    { printf(TRACE_FORMAT_FAIL_FMT , path) ; fclose(file) ; return false ; }
+
+  TraceRecord record ;
+  while (fread(&record , sizeof(record) , 1 , file) == 1) records->push_back(record) ;
+  fclose(file) ;
+
+  // collect the interned strings first - they may have been drained after their first use
+  Uint32 chunkSize = sizeof(Uint32) * TRACE_N_ARGS ;
+  for (Uint32 recordN = 0 ; recordN < records->size() ; ++recordN)
+  {
+    TraceRecord* aRecord = &(*records)[recordN] ;
+    if (aRecord->eventId != TRACE_EVT_STRING) continue ;
+
+    if (strings->size() <= aRecord->loopN) strings->resize(aRecord->loopN + 1) ;
+    string* str = &(*strings)[aRecord->loopN] ; Uint32 byteN = aRecord->sceneN * chunkSize ;
+    if (str->size() < byteN + chunkSize) str->resize(byteN + chunkSize , '\0') ;
+    memcpy(&(*str)[byteN] , aRecord->args , chunkSize) ;
+  }
+  for (Uint32 stringN = 0 ; stringN < strings->size() ; ++stringN)
+    (*strings)[stringN] = (*strings)[stringN].c_str() ; // trim at the terminator
+
+  // merge the threads
+  stable_sort(records->begin() , records->end() , IsEarlier) ;
+
+  return true ;
+}
+
+bool TraceRing::Decode(const char* path)
+{
+  vector<TraceRecord> records ; vector<string> strings ;
+  if (!Read(path , &records , &strings)) return false ;
+
+  Uint64 beginUsecs = (records.size())? records[0].usecs : 0 ;
+  for (Uint32 recordN = 0 ; recordN < records.size() ; ++recordN)
+  {
+    TraceRecord* aRecord = &records[recordN] ;
+    if (aRecord->eventId == TRACE_EVT_STRING) continue ;
+
+    printf(TRACE_RECORD_FMT , (aRecord->usecs - beginUsecs) * 0.000001 , aRecord->ringN) ;
+    Format(aRecord , &strings) ;
+  }
+
+  return true ;
+}
+
+void TraceRing::Format(const TraceRecord* record , vector<string>* strings)
+{
+  const Uint32* args = record->args ;
+  switch (record->eventId)
+  {
+    case TRACE_EVT_SCENE_STATE:
+    {
+      // args --> senderN , model flags , nLoops , nHistogramImgs , nLoopImgs
+      const char* senderTemplate = GetString(strings , args[0]) ;
+      char sender[DEBUG_TRACE_EVENT_LEN] ;
+      snprintf(sender , DEBUG_TRACE_EVENT_LEN , senderTemplate , record->sceneN) ;
+      Trace::TraceSceneState(sender , !!(args[1] & 1) , !!(args[1] & 2) , !!(args[1] & 4) ,
+                             args[2] , args[3] , args[4]) ;
+      break ;
+    }
+    case TRACE_EVT_ROLLOVER:
+    {
+      // args --> beginFrameN , endFrameN , nSeconds , validity
+      const char* validities[4] = { "" , "endFrameN invalid" , "nFrames invalid" , "valid" } ;
+      printf(TRACE_ROLLOVER_FMT , record->loopN , !record->loopN , args[0] , args[1] , args[2] ,
+             validities[args[3] & 3]) ;
+      break ;
+    }
+    case TRACE_EVT_NEW_LOOP:    printf(TRACE_NEW_LOOP_FMT , !record->loopN) ;         break ;
+    case TRACE_EVT_DROPPED:     printf(TRACE_DROPPED_FMT  , args[0]) ;                break ;
+    case TRACE_EVT_SPAN:        printf(TRACE_SPAN_FMT     , GetSpanName(record->loopN) , args[0]) ; break ;
+    case TRACE_EVT_THREAD_NAME: printf(TRACE_THREAD_FMT   , GetString(strings , args[0])) ;         break ;
+    case TRACE_EVT_NEXT_SCENE:  printf(TRACE_SCENE_FMT    , record->sceneN) ;         break ;
+    default:                    printf(TRACE_UNKNOWN_FMT  , record->eventId) ;        break ;
+  }
+}
+
+bool TraceRing::Export(const char* tracePath , const char* jsonPath)
+{
+  vector<TraceRecord> records ; vector<string> strings ;
+  if (!Read(tracePath , &records , &strings)) return false ;
+
+  FILE* file = fopen(jsonPath , "w") ;
+  if (!file) { printf(TRACE_OPEN_FAIL_FMT , jsonPath) ; return false ; }
+
+  // timestamps are relative to the first record - viewers expect usecs from zero
+  Uint64 beginUsecs = (records.size())? records[0].usecs : 0 ; const char* separator = "" ;
+  fprintf(file , TRACE_JSON_HEAD) ;
+  for (Uint32 recordN = 0 ; recordN < records.size() ; ++recordN)
+  {
+    TraceRecord* record = &records[recordN] ;
+    unsigned long long usecs = record->usecs - beginUsecs ;
+    switch (record->eventId)
+    {
+      case TRACE_EVT_SPAN:
+        fprintf(file , TRACE_JSON_SPAN_FMT , separator , GetSpanName(record->loopN) , usecs ,
+                record->args[0] , record->ringN , record->sceneN) ;
+        break ;
+      case TRACE_EVT_THREAD_NAME:
+        fprintf(file , TRACE_JSON_THREAD_FMT , separator , record->ringN ,
+                GetString(&strings , record->args[0])) ;
+        break ;
+      case TRACE_EVT_NEXT_SCENE:
+      case TRACE_EVT_ROLLOVER:
+      case TRACE_EVT_NEW_LOOP:
+      {
+        const char* name = (record->eventId == TRACE_EVT_NEXT_SCENE)? "nextScene" :
+                           (record->eventId == TRACE_EVT_ROLLOVER  )? "rollover"  : "newLoop" ;
+        fprintf(file , TRACE_JSON_EVENT_FMT , separator , name , usecs , record->ringN ,
+                record->sceneN , record->loopN) ;
+        break ;
+      }
+      default: continue ; // strings , scene state dumps , and drop counts are console only
+    }
+    separator = ",\n" ;
+  }
+  fprintf(file , TRACE_JSON_TAIL) ;
+
+  return !fclose(file) ;
+}
+
+
+// helpers
+
+const char* TraceRing::GetSpanName(Uint32 spanN)
+  { return (spanN < TRACE_N_SPANS)? SpanNames[spanN] : "" ; }
+
+const char* TraceRing::GetString(vector<string>* strings , Uint32 stringN)
+  { return (stringN < strings->size())? (*strings)[stringN].c_str() : "" ; }
+
+Uint64 TraceRing::NowUsecs()
+{
+  timespec now ; clock_gettime(CLOCK_MONOTONIC , &now) ;
+
+  return ((Uint64)now.tv_sec * 1000000) + (now.tv_nsec / 1000) ;
+}
@@ -0,0 +1,235 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+
+#ifndef _TRACE_RING_H_
+#define _TRACE_RING_H_
+
+
+#include <atomic>
+
+#include "loopidity.h"
+
+
+#define TRACE_SPAN(spanN) TraceRing::Span span##spanN(spanN) ;
+
+// event ids
+#define TRACE_EVT_STRING      1 // sceneN is the chunk index , loopN the string id , args the chars
+#define TRACE_EVT_SCENE_STATE 2 // Trace::TraceScene()
+#define TRACE_EVT_ROLLOVER    3 // DEBUG_TRACE_JACK_PROCESS_CALLBACK_ROLLOVER
+#define TRACE_EVT_NEW_LOOP    4 // DEBUG_TRACE_JACK_PROCESS_CALLBACK_NEW_LOOP
+#define TRACE_EVT_DROPPED     5 // written by Cleanup()
+#define TRACE_EVT_SPAN        6 // TRACE_SPAN - loopN is the span id , args[0] the duration
+#define TRACE_EVT_THREAD_NAME 7 // NameThread() - args[0] is the string id
+#define TRACE_EVT_NEXT_SCENE  8 // JackIO::ProcessCallback() - sceneN is the next scene
+
+// span ids
+#define TRACE_SPAN_PROCESS        0 // JackIO::ProcessCallback()
+#define TRACE_SPAN_ROLLOVER       1 // JackIO::ProcessCallback() rollover branch
+#define TRACE_SPAN_LOOP_COMMIT    2 // JackIO::ProcessCallback() new Loop copy
+#define TRACE_SPAN_SCAN_PEAKS     3 // Scene::scanPeaks()
+#define TRACE_SPAN_DRAW_SCENE     4 // SceneSdl::drawScene()
+#define TRACE_SPAN_DRAW_LOOP      5 // SceneSdl::drawLoop()
+#define TRACE_SPAN_DRAW_HISTOGRAM 6 // SceneSdl::drawHistogram()
+#define TRACE_SPAN_FLIP           7 // LoopiditySdl::FlipScreen()
+#define TRACE_N_SPANS             8
+#define TRACE_SPAN_NAMES          { "process" , "rollover" , "loopCommit" , "scanPeaks" , \
+                                    "drawScene" , "drawLoop" , "drawHistogram" , "flip" }
+
+// magnitudes
+#define TRACE_N_RINGS         8    // one per thread that writes records
+#define TRACE_RING_SIZE       2048 // records per ring - must be a power of two
+#define TRACE_N_ARGS          5
+#define TRACE_N_STRINGS       255
+#define TRACE_WRITER_INTERVAL 100  // nMsecs between drains
+
+// file format
+#define TRACE_FILE_MAGIC      "LPTR"
+#define TRACE_FILE_VERSION    1
+
+// string constants
+#define TRACE_OPEN_FAIL_FMT   "ERROR: TraceRing: could not open '%s'\n"
+#define TRACE_FORMAT_FAIL_FMT "ERROR: TraceRing: '%s' is not a loopidity trace\n"
+#define TRACE_RECORD_FMT      "%12.6f t%d "
+#define TRACE_ROLLOVER_FMT    "JackIO::ProcessCallback() buffer rollover nLoops=%d isBaseLoop=%d beginFrameN=%d endFrameN=%d nSeconds=%d - %s\n"
+#define TRACE_NEW_LOOP_FMT    "JackIO::ProcessCallback() NewLoop isBaseLoop=%d\n"
+#define TRACE_DROPPED_FMT     "TraceRing: %d records dropped (rings full)\n"
+#define TRACE_UNKNOWN_FMT     "TraceRing: unknown event %d\n"
+#define TRACE_SPAN_FMT        "%s %u us\n"
+#define TRACE_THREAD_FMT      "thread '%s'\n"
+#define TRACE_SCENE_FMT       "JackIO::ProcessCallback() scene change nextSceneN=%d\n"
+
+// chrome trace event format
+#define TRACE_JSON_HEAD       "{\"traceEvents\":[\n"
+#define TRACE_JSON_TAIL       "\n],\"displayTimeUnit\":\"ms\"}\n"
+#define TRACE_JSON_SPAN_FMT   "%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%u,\"pid\":1,\"tid\":%d,\"args\":{\"sceneN\":%d}}"
+#define TRACE_JSON_EVENT_FMT  "%s{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%llu,\"pid\":1,\"tid\":%d,\"args\":{\"sceneN\":%d,\"loopN\":%d}}"
+#define TRACE_JSON_THREAD_FMT "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}"
+
+
+using namespace std ;
+
+
+typedef struct TraceRecord
+{
+  Uint64 usecs ;   // monotonic
+  Uint8  ringN ;   // writing thread
+  Uint8  eventId ;
+  Uint8  sceneN ;
+  Uint8  loopN ;
+  Uint32 args[TRACE_N_ARGS] ;
+} TraceRecord ;
+
+typedef struct TraceFileHeader
+{
+  char   magic[4] ;
+  Uint32 version ;
+  Uint32 recordSize ;
+} TraceFileHeader ;
+
+
+class TraceRing
+{
+  friend class Loopidity ;
+  friend class Trace ;
+
+
+  public:
+
+    /* TraceRing::Span - records the duration of the enclosing block (TRACE_SPAN) */
+
+    class Span
+    {
+      public:
+
+        Span(Uint8 aSpanN) ;
+        ~Span() ;
+
+
+      private:
+
+        Uint8  spanN ;
+        Uint64 beginUsecs ; // 0 if tracing was disabled on entry
+    } ;
+
+
+    /* TraceRing class side public functions */
+
+    // any thread
+    static void Write(Uint8  eventId     , Uint8  sceneN      , Uint8  loopN       ,
+                      Uint32 arg0 = 0    , Uint32 arg1 = 0    , Uint32 arg2 = 0    ,
+                      Uint32 arg3 = 0    , Uint32 arg4 = 0                         ) ;
+    static void NameThread(const char* name) ;
+
+
+  private:
+
+    /* TraceRing::Ring - single producer (the owning thread) single consumer (Writer()) */
+
+    typedef struct Ring
+    {
+      TraceRecord    records[TRACE_RING_SIZE] ;
+      atomic<Uint32> writeN ;
+      atomic<Uint32> readN ;
+    } Ring ;
+
+
+    /* TraceRing class side private varables */
+
+    // rings
+    static Ring           Rings[TRACE_N_RINGS] ;
+    static atomic<Uint32> NRings ;
+    static atomic<Uint32> NDropped ;
+
+    // strings
+    static const char* Strings[TRACE_N_STRINGS] ;
+    static Uint32      NStrings ;
+    static SDL_mutex*  StringsMutex ;
+
+    // writer thread
+    static FILE*        File ;
+    static SDL_Thread*  WriterThread ;
+    static atomic<bool> IsRunning ;
+
+
+    /* TraceRing class side private functions */
+
+    // setup
+    static bool Init(   const char* path) ;
+    static void Cleanup(void) ;
+
+    // any thread
+    static void  Append(   Uint64 usecs , Uint8  eventId , Uint8  sceneN , Uint8  loopN ,
+                           Uint32 arg0  , Uint32 arg1    , Uint32 arg2   , Uint32 arg3  ,
+                           Uint32 arg4                                                  ) ;
+    static bool  IsEnabled(void) ;
+    static Uint8 Intern(   const char* str) ;
+
+    // writer thread
+    static int  Writer(void* unused) ;
+    static void Drain( void) ;
+
+    // offline
+    static bool Read(  const char* path , vector<TraceRecord>* records , vector<string>* strings) ;
+    static bool Decode(const char* path) ;
+    static void Format(const TraceRecord* record , vector<string>* strings) ;
+    static bool Export(const char* tracePath , const char* jsonPath) ;
+
+    // helpers
+    static const char* GetSpanName(Uint32 spanN) ;
+    static const char* GetString(  vector<string>* strings , Uint32 stringN) ;
+    static Uint64      NowUsecs(   void) ;
+} ;
+
+
+#endif // #ifndef _TRACE_RING_H_
+
+
+/* NOTE: on the binary trace
+
+    TRACE_ARG <path> records trace events as fixed-size TraceRecords rather than
+      printing them - Write() is lock-free and does not allocate so it is safe to call
+      from ProcessCallback() (e.g. DEBUG_TRACE_JACK_PROCESS_CALLBACK_*)
+    each thread claims its own Ring on its first Write() - a full ring drops the record
+      and counts it rather than blocking
+    Writer() wakes every TRACE_WRITER_INTERVAL and appends whatever the rings hold to
+      the file - records are ordered within a thread but not across threads
+
+    strings (e.g. the senders of Trace::TraceScene()) are interned once per pointer
+      and written into the ring as TRACE_EVT_STRING chunks before their first use
+    DECODE_TRACE_ARG <path> reads a trace , sorts it by timestamp , and formats each record
+      as the equivalent console output - scene state records are formatted with the same
+      Trace::TraceSceneState() used by the live console trace
+*/
+
+
+/* NOTE: on trace timelines
+
+    TRACE_SPAN(spanN) at the top of a block records one TRACE_EVT_SPAN when the block exits
+      (begin time and duration) - with tracing disabled it costs one relaxed load
+    spans cover the JACK period , its rollover branch and loop commit , peak scanning ,
+      and the scene , loop , and histogram drawing and screen flip of the view
+    each thread names itself via NameThread() so that timelines are labelled
+
+    EXPORT_TRACE_ARG <trace> <json> converts a trace to the chrome trace event format
+      (chrome://tracing or ui.perfetto.dev) - spans become complete ('X') events ,
+      scene changes and loop events become instant ('i') events , and thread names
+      become metadata ('M') events
+*/
@@ -0,0 +1,224 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+
+#include "wav_file.h"
+
+
+/* WavFile class side private constants */
+
+const Uint32 WavFile::WRITE_HEADER_SIZE = 58 ; // RIFF + fmt (18) + fact + data headers
+
+
+/* WavFile instance side public functions */
+
+WavFile::WavFile() : file(0) , isWriting(false) , nFramesLeft(0) , nChannels(0) ,
+                     sampleRate(0) , bitsPerSample(0) , isFloat(false) , nFrames(0) {}
+
+WavFile::~WavFile() { close() ; }
+
+
+// setup
+
+bool WavFile::openRead(const char* path)
+{
+  close() ;
+
+  if (!(file = fopen(path , "rb"))) return false ;
+  if (!readFormat()) { close() ; return false ; }
+
+  isWriting = false ; nFramesLeft = nFrames ; return true ;
+}
+
+bool WavFile::openWrite(const char* path , Uint32 nChannels , Uint32 sampleRate)
+{
+  close() ;
+
+  if (!nChannels || !(file = fopen(path , "wb"))) return false ;
+
+  this->nChannels = nChannels ; this->sampleRate = sampleRate ;
+  bitsPerSample   = 32 ;        isFloat          = true ;
+  nFrames         = 0 ;         nFramesLeft      = 0 ;
+  isWriting       = true ;
+  if (!writeHeader()) { close() ; return false ; }
+
+  return true ;
+}
+
+void WavFile::close()
+{
+  if (!file) return ;
+
+  // patch the chunk sizes now that the length is known
+  if (isWriting && !fseek(file , 0 , SEEK_SET)) writeHeader() ;
+
+  fclose(file) ; file = 0 ; isWriting = false ;
+}
+
+
+// getters
+
+Uint32 WavFile::getNChannels() { return nChannels ; }
+
+Uint32 WavFile::getSampleRate() { return sampleRate ; }
+
+Uint32 WavFile::getNFrames() { return nFrames ; }
+
+
+// I/O
+
+Uint32 WavFile::read(Sample** buffers , Uint32 nChannels , Uint32 nFrames)
+{
+  if (!file || isWriting) return 0 ;
+
+  Uint32 nBytesPerSample = bitsPerSample / 8 ;
+  Uint32 nBytesPerFrame  = nBytesPerSample * this->nChannels ;
+  Uint32 nFramesToRead   = (nFrames < nFramesLeft)? nFrames : nFramesLeft ;
+  if (scratch.size() < nFramesToRead * nBytesPerFrame)
+    scratch.resize(nFramesToRead * nBytesPerFrame) ;
+
+  Uint32 nFramesRead = (nFramesToRead)?
+      fread(&scratch[0] , nBytesPerFrame , nFramesToRead , file) : 0 ;
+  nFramesLeft = (nFramesRead == nFramesToRead)? nFramesLeft - nFramesRead : 0 ;
+
+  for (Uint32 channelN = 0 ; channelN < nChannels ; ++channelN)
+  {
+    Sample* buffer = buffers[channelN] ;
+    Uint32  fileChannelN = (this->nChannels == 1)? 0 : channelN ;
+    if (fileChannelN >= this->nChannels) { memset(buffer , 0 , nFrames * sizeof(Sample)) ; continue ; }
+
+    const Uint8* bytes = &scratch[0] + (fileChannelN * nBytesPerSample) ;
+    for (Uint32 frameN = 0 ; frameN < nFramesRead ; ++frameN , bytes += nBytesPerFrame)
+      switch (bitsPerSample)
+      {
+        case 16: buffer[frameN] = *(const Sint16*)bytes * (1.0f / 32768.0f) ; break ;
+        case 24: buffer[frameN] = (Sint32)(((Uint32)bytes[0] << 8)  | ((Uint32)bytes[1] << 16) |
+                                           ((Uint32)bytes[2] << 24)                            ) *
+                                  (1.0f / 2147483648.0f) ;                    break ;
+        default: buffer[frameN] = *(const float*)bytes ;                      break ;
+      }
+    if (nFramesRead < nFrames)
+      memset(buffer + nFramesRead , 0 , (nFrames - nFramesRead) * sizeof(Sample)) ;
+  }
+
+  return nFramesRead ;
+}
+
+bool WavFile::write(Sample** buffers , Uint32 nChannels , Uint32 nFrames)
+{
+  if (!file || !isWriting) return false ;
+
+  // interleave - channels missing from the source are written silent
+  Uint32 nBytesPerFrame = sizeof(float) * this->nChannels ;
+  if (scratch.size() < nFrames * nBytesPerFrame) scratch.resize(nFrames * nBytesPerFrame) ;
+
+  float* frames = (float*)&scratch[0] ;
+  for (Uint32 channelN = 0 ; channelN < this->nChannels ; ++channelN)
+  {
+    Sample* buffer = (channelN < nChannels)? buffers[channelN] : 0 ;
+    for (Uint32 frameN = 0 ; frameN < nFrames ; ++frameN)
+      frames[(frameN * this->nChannels) + channelN] = (buffer)? buffer[frameN] : 0.0f ;
+  }
+
+  if (fwrite(frames , nBytesPerFrame , nFrames , file) != nFrames) return false ;
+
+  this->nFrames += nFrames ; return true ;
+}
+
+
+/* WavFile instance side private functions */
+
+// helpers
+
+bool WavFile::readFormat()
+{
+  // RIFF header
+  Uint8 header[12] ;
+  if (fread(header , 1 , 12 , file) != 12       ||
+      memcmp(header , "RIFF" , 4) || memcmp(header + 8 , "WAVE" , 4)) return false ;
+
+  // walk the chunks until the data chunk - fmt must come first
+  bool isFormatRead = false ; Uint8 chunkHeader[8] ;
+  while (fread(chunkHeader , 1 , 8 , file) == 8)
+  {
+    Uint32 chunkSize = chunkHeader[4]         | (chunkHeader[5] << 8) |
+                      (chunkHeader[6] << 16) | (chunkHeader[7] << 24) ;
+    if (!memcmp(chunkHeader , "fmt " , 4))
+    {
+      Uint8 format[40] = { 0 } ; Uint32 nBytes = (chunkSize < 40)? chunkSize : 40 ;
+      if (chunkSize < 16 || fread(format , 1 , nBytes , file) != nBytes) return false ;
+
+      Uint32 formatTag = format[0] | (format[1] << 8) ;
+      if (formatTag == WAV_FORMAT_EXTENSIBLE && chunkSize >= 26)
+        formatTag = format[24] | (format[25] << 8) ; // first two bytes of the sub-format GUID
+      nChannels     = format[2] | (format[3] << 8) ;
+      sampleRate    = format[4] | (format[5] << 8) | (format[6] << 16) | (format[7] << 24) ;
+      bitsPerSample = format[14] | (format[15] << 8) ;
+      isFloat       = formatTag == WAV_FORMAT_FLOAT ;
+      if (!nChannels || !sampleRate                                            ||
+          !((formatTag == WAV_FORMAT_PCM   && (bitsPerSample == 16 || bitsPerSample == 24)) ||
+            (formatTag == WAV_FORMAT_FLOAT &&  bitsPerSample == 32)                       ))
+        return false ;
+
+      isFormatRead = true ; chunkSize -= nBytes ;
+    }
+    else if (!memcmp(chunkHeader , "data" , 4))
+    {
+      if (!isFormatRead) return false ;
+
+      nFrames = chunkSize / ((bitsPerSample / 8) * nChannels) ; return true ;
+    }
+
+    // skip unknown chunks and any fmt extension - chunks are word aligned
+    if (fseek(file , chunkSize + (chunkSize & 1) , SEEK_CUR)) return false ;
+  }
+
+  return false ;
+}
+
+bool WavFile::writeHeader()
+{
+  Uint32 dataSize   = nFrames * nChannels * sizeof(float) ;
+  Uint32 blockAlign = nChannels * sizeof(float) ;
+  Uint32 fields[][2] = { { 0x46464952                            , 4 } , // "RIFF"
+                         { WRITE_HEADER_SIZE - 8 + dataSize      , 4 } ,
+                         { 0x45564157                            , 4 } , // "WAVE"
+                         { 0x20746D66                            , 4 } , // "fmt "
+                         { 18                                    , 4 } ,
+                         { WAV_FORMAT_FLOAT                      , 2 } ,
+                         { nChannels                             , 2 } ,
+                         { sampleRate                            , 4 } ,
+                         { sampleRate * blockAlign               , 4 } ,
+                         { blockAlign                            , 2 } ,
+                         { 32                                    , 2 } ,
+                         { 0                                     , 2 } , // cbSize
+                         { 0x74636166                            , 4 } , // "fact"
+                         { 4                                     , 4 } ,
+                         { nFrames                               , 4 } ,
+                         { 0x61746164                            , 4 } , // "data"
+                         { dataSize                              , 4 } } ;
+
+  Uint8 header[WRITE_HEADER_SIZE] ; Uint32 byteN = 0 ;
+  for (Uint32 fieldN = 0 ; fieldN < sizeof(fields) / sizeof(fields[0]) ; ++fieldN)
+    for (Uint32 shiftN = 0 ; shiftN < fields[fieldN][1] ; ++shiftN)
+      header[byteN++] = (fields[fieldN][0] >> (shiftN * 8)) & 0xFF ;
+
+  return fwrite(header , 1 , WRITE_HEADER_SIZE , file) == WRITE_HEADER_SIZE ;
+}
@@ -0,0 +1,112 @@
+/*\ Loopidity - multitrack audio looper designed for live handsfree use
+|*| https://github.com/bill-auger/loopidity/issues/
+|*| Copyright 2013,2015 Bill Auger - https://bill-auger.github.io/
+|*|
+|*| This file is part of Loopidity.
+|*|
+|*| Loopidity is free software: you can redistribute it and/or modify
+|*| it under the terms of the GNU General Public License version 3
+|*| as published by the Free Software Foundation.
+|*|
+|*| Loopidity is distributed in the hope that it will be useful,
+|*| but WITHOUT ANY WARRANTY; without even the implied warranty of
+|*| MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+|*| GNU General Public License for more details.
+|*|
+|*| You should have received a copy of the GNU General Public License
+|*| along with Loopidity.  If not, see <http://www.gnu.org/licenses/>.
+\*/
+
+
+
+#ifndef _WAV_FILE_H_
+#define _WAV_FILE_H_
+
+
+#include <cstdio>
+
+#include "loopidity.h"
+
+
+#define WAV_FORMAT_PCM        0x0001
+#define WAV_FORMAT_FLOAT      0x0003
+#define WAV_FORMAT_EXTENSIBLE 0xFFFE
+
+
+using namespace std ;
+
+
+class WavFile
+{
+  private:
+
+    /* WavFile class side private constants */
+
+    static const Uint32 WRITE_HEADER_SIZE ;
+
+
+  public:
+
+    /* WavFile instance side public functions */
+
+    WavFile() ;
+    ~WavFile() ;
+
+    // setup
+    bool openRead( const char* path) ;
+    bool openWrite(const char* path , Uint32 nChannels , Uint32 sampleRate) ;
+    void close(    void) ;
+
+    // getters
+    Uint32 getNChannels( void) ;
+    Uint32 getSampleRate(void) ;
+    Uint32 getNFrames(   void) ;
+
+    // I/O
+    Uint32 read( Sample** buffers , Uint32 nChannels , Uint32 nFrames) ;
+    bool   write(Sample** buffers , Uint32 nChannels , Uint32 nFrames) ;
+
+
+  private:
+
+    /* WavFile instance side private varables */
+
+    // file state
+    FILE*  file ;
+    bool   isWriting ;
+    Uint32 nFramesLeft ; // read only
+
+    // format
+    Uint32 nChannels ;
+    Uint32 sampleRate ;
+    Uint32 bitsPerSample ;
+    bool   isFloat ;
+    Uint32 nFrames ;     // data chunk size (read) or frames written so far (write)
+
+    // interleaved frames - grown on demand then reused
+    vector<Uint8> scratch ;
+
+
+    /* WavFile instance side private functions */
+
+    // helpers
+    bool readFormat( void) ;
+    bool writeHeader(void) ;
+} ;
+
+
+#endif // #ifndef _WAV_FILE_H_
+
+
+/* NOTE: on WAV files
+
+    read() accepts 16 and 24 bit integer PCM and 32 bit float - plain or WAVE_FORMAT_EXTENSIBLE
+      frames are de-interleaved into one buffer per channel and scaled to -1.0 .. 1.0
+      a mono file feeds every channel - other channels beyond the file's count are silent
+      frames past the end of the data chunk are silent and are not counted in the return value
+    write() always writes 32 bit float (WAVE_FORMAT_IEEE_FLOAT) interleaved from one buffer
+      per channel - the header is written with zero sizes on openWrite() and patched
+      on close() so a file that is never closed declares an empty data chunk
+      (the samples are on disk but most readers will see zero frames)
+    samples are read and written in host byte order - this assumes a little endian host
+*/